@@ -0,0 +1,182 @@
+#include <algorithm>                                                  // clamp(), count(), max(), min(), move()
+#include <cstddef>                                                    // size_t
+#include <filesystem>                                                 // path
+#include <string_view>
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "IngestMetrics.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"                                             // runInParallel(), resolveThreadCount()
+#include "UpcValidation.hpp"                                        // normalizeUpcs()
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // The records of one chunk:  those starting at or after the chunk's first record and before limit.  The last of them may extend
+  // past limit.
+  struct ChunkResult
+  {
+    std::vector<GroceryItem> items;
+    char const *             start  = nullptr;                        // Where the chunk's first record starts (after skipping whitespace)
+    char const *             stop   = nullptr;                        // Where the next chunk's first record must start, or where parsing failed
+    char const *             failed = nullptr;                        // The failing record's first character
+    ParseStatus              status = ParseStatus::ok;                // ok (stopped at limit), endOfInput, or the reason parsing failed
+  };
+
+
+  void parseChunk( char const * from, char const * limit, char const * end, ChunkResult & chunk )
+  {
+    chunk.items.clear();
+    if( from < limit )  chunk.items.reserve( static_cast<std::size_t>( std::count( from, limit, '\n' ) ) + 1 );
+    chunk.start = skipWhitespace( from, end );
+
+    char const * cursor = chunk.start;
+    RecordView   record;
+    while( true )
+    {
+      cursor = skipWhitespace( cursor, end );
+      if( cursor == end   )  { chunk.status = ParseStatus::endOfInput;  break; }
+      if( cursor >= limit )  { chunk.status = ParseStatus::ok;          break; }
+
+      chunk.status = parseRecord( cursor, end, record );
+      if( chunk.status != ParseStatus::ok )
+      {
+        chunk.failed = record.begin;
+        break;
+      }
+      chunk.items.push_back( toGroceryItem( record ) );
+    }
+    chunk.stop = cursor;
+  }
+
+
+  // A finished load's ingest metrics:  records and bytes read, and why it stopped if it failed
+  void countLoad( CatalogLoadResult const & result, std::size_t textSize ) noexcept
+  {
+    IngestMetrics::count     ( IngestCounter::recordsRead, result.items.size()                   );
+    IngestMetrics::count     ( IngestCounter::bytesRead,   result ? textSize : result.errorOffset );
+    IngestMetrics::parseError( result.status                                                     );
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Loaders
+*******************************************************************************/
+
+CatalogLoadResult loadCatalog( std::string_view text, UpcHandling upcs )
+{
+  CatalogLoadResult result;
+
+  char const * const begin  = text.data();
+  char const * const end    = begin + text.size();
+  char const *       cursor = begin;
+
+  // Records are normally one per line, so the line count is a cheap, (usually) exact capacity estimate that avoids regrowing a
+  // vector of millions of items
+  result.items.reserve( static_cast<std::size_t>( std::count( begin, end, '\n' ) ) + 1 );
+
+  RecordView  record;
+  ParseStatus status;
+  while( ( status = parseRecord( cursor, end, record ) ) == ParseStatus::ok )  result.items.push_back( toGroceryItem( record ) );
+
+  result.status = status;
+  if( status != ParseStatus::endOfInput )
+  {
+    result.errorOffset = static_cast<std::size_t>( record.begin - begin );
+    result.errorLine   = static_cast<std::size_t>( std::count( begin, record.begin, '\n' ) ) + 1;
+  }
+  if( upcs == UpcHandling::normalize )  normalizeUpcs( result.items, &result.invalidUpcs );
+  countLoad( result, text.size() );
+  return result;
+}
+
+
+CatalogLoadResult loadCatalogFile( std::filesystem::path const & path, UpcHandling upcs )
+{
+  MappedFile file( path );
+  return loadCatalog( file.view(), upcs );
+}
+
+
+CatalogLoadResult loadCatalogParallel( std::string_view text, unsigned threadCount, UpcHandling upcs )
+{
+  constexpr std::size_t minimumChunkSize = 1 << 20;                   // Smaller chunks cost more in thread hand-offs than they save
+
+  threadCount = resolveThreadCount( threadCount );
+
+  char const * const begin = text.data();
+  char const * const end   = begin + text.size();
+
+  // Several chunks per thread so an unlucky thread with a slow chunk doesn't hold up the others
+  std::size_t chunkCount = std::clamp<std::size_t>( text.size() / minimumChunkSize, 1, std::size_t{ threadCount } * 4 );
+  if( threadCount == 1 || chunkCount == 1 )  return loadCatalog( text, upcs );
+
+  std::vector<char const *> boundaries{ begin };
+  for( std::size_t i = 1; i < chunkCount; ++i )
+  {
+    char const * cut = std::find( std::max( begin + text.size() / chunkCount * i, boundaries.back() ), end, '\n' );
+    if( cut != end )  ++cut;
+    if( cut != boundaries.back() && cut != end )  boundaries.push_back( cut );
+  }
+  boundaries.push_back( end );
+  chunkCount = boundaries.size() - 1;
+
+  std::vector<ChunkResult> chunks( chunkCount );
+  runInParallel( threadCount, chunkCount, [&]( std::size_t i ) { parseChunk( boundaries[i], boundaries[i+1], end, chunks[i] ); } );
+
+  // Stitch the chunks together in file order, re-parsing any chunk whose speculative start turned out to be inside a record
+  CatalogLoadResult result;
+  char const *      expectedStart = skipWhitespace( begin, end );
+  std::size_t       lastChunk     = 0;
+  std::size_t       itemCount     = 0;
+  for( ; lastChunk < chunkCount; ++lastChunk )
+  {
+    auto & chunk = chunks[lastChunk];
+    if( chunk.start != expectedStart )  parseChunk( expectedStart, boundaries[lastChunk+1], end, chunk );
+
+    itemCount += chunk.items.size();
+    if( chunk.status != ParseStatus::ok )  break;
+    expectedStart = chunk.stop;
+  }
+  // The last chunk's limit is end, so the loop always breaks:  chunks[lastChunk] ended with endOfInput or a failure
+
+  result.status = chunks[lastChunk].status;
+  if( result.status != ParseStatus::endOfInput )
+  {
+    result.errorOffset = static_cast<std::size_t>( chunks[lastChunk].failed - begin );
+    result.errorLine   = static_cast<std::size_t>( std::count( begin, chunks[lastChunk].failed, '\n' ) ) + 1;
+  }
+
+  // Move the items into place, also in parallel, normalizing each chunk's codes on the way if asked to
+  std::vector<std::size_t> offsets( lastChunk + 2, 0 ),  invalidUpcs( lastChunk + 1, 0 );
+  for( std::size_t i = 0; i <= lastChunk; ++i )  offsets[i+1] = offsets[i] + chunks[i].items.size();
+
+  result.items.resize( itemCount );
+  runInParallel( threadCount, lastChunk + 1, [&]( std::size_t i )
+  {
+    if( upcs == UpcHandling::normalize )  normalizeUpcs( chunks[i].items, &invalidUpcs[i] );
+    std::move( chunks[i].items.begin(), chunks[i].items.end(), result.items.begin() + static_cast<std::ptrdiff_t>( offsets[i] ) );
+    chunks[i].items = {};
+  } );
+  for( auto invalid : invalidUpcs )  result.invalidUpcs += invalid;
+
+  countLoad( result, text.size() );
+  return result;
+}
+
+
+CatalogLoadResult loadCatalogFileParallel( std::filesystem::path const & path, unsigned threadCount, UpcHandling upcs )
+{
+  MappedFile file( path );
+  return loadCatalogParallel( file.view(), threadCount, upcs );
+}
@@ -0,0 +1,55 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <filesystem>                                                         // path
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+
+
+
+
+// What a bulk load does with the UPC codes it reads (see UpcValidation.hpp)
+enum class UpcHandling : unsigned char
+{
+  asIs,                                                                       // Kept exactly as read
+  normalize                                                                   // Validated, and valid UPC-A codes rewritten to their GTIN-14 form (normalizeUpcs()) so both
+                                                                              // spellings of a code compare equal.  Invalid codes are kept as read and counted in invalidUpcs
+};
+
+
+
+
+// The outcome of a bulk load.  items holds every record read before the first failure, exactly as
+//     GroceryItem item;   while( stream >> item )  items.push_back( item );
+// would have read them from the same text.
+struct CatalogLoadResult
+{
+  std::vector<GroceryItem> items;
+  ParseStatus              status      = ParseStatus::endOfInput;             // endOfInput when the whole input was read, otherwise why the failing record was rejected
+  std::size_t              errorLine   = 0;                                   // 1-based line on which the failing record starts (0 when there was no failure)
+  std::size_t              errorOffset = 0;                                   // Byte offset of the failing record's first character
+  std::size_t              invalidUpcs = 0;                                   // Items whose UPC code failed GS1 validation.  Counted only with UpcHandling::normalize
+
+  explicit operator bool() const noexcept { return status == ParseStatus::endOfInput; }
+};
+
+
+
+
+// Bulk catalog loaders.  These replace a loop over operator>> with an in-place parse of the whole text (see GroceryItemParser.hpp)
+// and produce byte-for-byte identical items - unless upcs is UpcHandling::normalize, when valid UPC-A codes come back in GTIN-14 form.
+CatalogLoadResult loadCatalog    ( std::string_view              text, UpcHandling upcs = UpcHandling::asIs );   // Parses text already in memory
+CatalogLoadResult loadCatalogFile( std::filesystem::path const & path, UpcHandling upcs = UpcHandling::asIs );   // Memory-maps the file and parses it in place.  Throws std::system_error if the file can't be mapped
+
+
+// Parallel versions of the above, spreading the parse over threadCount threads (0 means one per hardware thread).  The results,
+// including the failing record's status and line, are identical to the single-threaded loaders.
+//
+// The text is cut into chunks just after a newline and every chunk is parsed speculatively.  A newline may sit inside a quoted
+// field, so a chunk's records are kept only if its first record starts exactly where the previous chunk's last record ended;
+// otherwise that chunk is parsed again, in order, from the correct position.
+CatalogLoadResult loadCatalogParallel    ( std::string_view              text, unsigned threadCount = 0, UpcHandling upcs = UpcHandling::asIs );
+CatalogLoadResult loadCatalogFileParallel( std::filesystem::path const & path, unsigned threadCount = 0, UpcHandling upcs = UpcHandling::asIs );
@@ -0,0 +1,536 @@
+#include <algorithm>                                                  // clamp(), min(), max()
+#include <atomic>
+#include <cerrno>                                                     // errno
+#include <compare>                                                    // strong_order()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t
+#include <filesystem>
+#include <fstream>
+#include <memory>                                                     // unique_ptr
+#include <span>
+#include <stdexcept>                                                  // runtime_error
+#include <string>
+#include <system_error>                                               // system_error, generic_category()
+#include <utility>                                                    // move(), swap()
+#include <vector>
+
+#include <unistd.h>                                                   // getpid()
+
+#include "CatalogMerge.hpp"
+#include "CatalogSort.hpp"
+#include "CatalogWriter.hpp"
+#include "FloatingPoint.hpp"
+#include "GroceryItem.hpp"
+#include "PendingOutput.hpp"
+#include "RecordSource.hpp"
+#include "StringMemory.hpp"                                           // heapBytes()
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t minimumBudget       = std::size_t{ 4 } << 20;
+  constexpr std::size_t minimumBufferSize   = std::size_t{ 64 } << 10;   // Per input, run, or output, for reading and writing
+  constexpr std::size_t maximumBufferSize   = std::size_t{ 1 } << 20;    // Larger buffers stop paying for themselves
+  constexpr std::size_t maximumFanIn        = 256;                       // Runs merged at once.  Two open files each
+  constexpr std::size_t sortOverheadPerItem = 64;                        // sortedOrder()'s keys, scratch keys, and permutations, per item
+
+
+  // The memory an item holds:  the object itself and its strings' heap blocks, if any, as the allocator sizes them
+  std::size_t footprint( GroceryItem const & item ) noexcept
+  {
+    auto allocated = []( std::string const & text ) -> std::size_t
+    {
+      auto bytes = heapBytes( text );
+      return bytes == 0 ? 0 : ( bytes + sizeof( void * ) + 15 ) / 16 * 16;   // With malloc's chunk header and rounding
+    };
+    return sizeof item + allocated( item.upcCode() ) + allocated( item.brandName() ) + allocated( item.productName() );
+  }
+
+
+  // Writing a run visits the items in sorted, so random, order:  fetch each item well ahead, and its names once the item has arrived
+  // and says where they are.  Halves the time to write a run of items too many for the cache.
+  void prefetchAhead( std::vector<GroceryItem> const & items, std::vector<std::size_t> const & order, std::size_t position ) noexcept
+  {
+    constexpr std::size_t itemDistance = 16,  nameDistance = 8;
+    if( position + itemDistance < order.size() )  __builtin_prefetch( &items[order[position + itemDistance]] );
+    if( position + nameDistance < order.size() )
+    {
+      auto const & item = items[order[position + nameDistance]];
+      __builtin_prefetch( item.productName().data() );
+      __builtin_prefetch( item.brandName  ().data() );
+    }
+  }
+
+
+  GroceryItem toGroceryItem( ItemView const & view )
+  { return GroceryItem( std::string( view.productName ), std::string( view.brandName ), std::string( view.upcCode ), view.price ); }
+
+
+  std::ifstream openForReading( std::filesystem::path const & path )
+  {
+    std::ifstream file( path, std::ios::binary );
+    if( !file )  throw std::system_error( errno, std::generic_category(), "mergeCatalogs: cannot open " + path.string() );
+    return file;
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Spilled runs
+  *****************************************************************************/
+  // A sorted run on disk:  the items as text, and beside them each item's position in the concatenated inputs
+  struct RunFiles
+  {
+    std::filesystem::path items;
+    std::filesystem::path ordinals;
+  };
+
+
+  // A private directory for the runs, created when the first run is spilled and removed, with everything in it, on destruction
+  class TemporaryDirectory
+  {
+    public:
+      explicit TemporaryDirectory( std::filesystem::path parent )
+        : _parent( parent.empty() ? std::filesystem::temp_directory_path() : std::move( parent ) )
+      {}
+
+      TemporaryDirectory            ( TemporaryDirectory const & ) = delete;
+      TemporaryDirectory & operator=( TemporaryDirectory const & ) = delete;
+
+     ~TemporaryDirectory() noexcept
+      {
+        std::error_code ignored;
+        if( !_path.empty() )  std::filesystem::remove_all( _path, ignored );
+      }
+
+      RunFiles newRun()
+      {
+        static std::atomic<unsigned> instance{ 0 };
+        while( _path.empty() )
+        {
+          auto candidate = _parent / ( "catalog-merge-" + std::to_string( ::getpid() ) + '-' + std::to_string( instance++ ) );
+          if( std::filesystem::create_directory( candidate ) )  _path = std::move( candidate );
+        }
+
+        auto name = "run-" + std::to_string( _runCount++ );
+        return { _path / ( name + ".txt" ), _path / ( name + ".ordinals" ) };
+      }
+
+    private:
+      std::filesystem::path _parent;
+      std::filesystem::path _path;
+      std::size_t           _runCount = 0;
+  };
+
+
+  // Input positions, written and read back in raw binary a block at a time.  The files never leave this machine, or this merge.
+  class OrdinalWriter
+  {
+    public:
+      OrdinalWriter( std::filesystem::path const & path, std::size_t bufferSize )
+        : _file( path, std::ios::binary | std::ios::trunc )
+      {
+        if( !_file )  throw std::system_error( errno, std::generic_category(), "mergeCatalogs: cannot create " + path.string() );
+        _file.exceptions( std::ios::badbit | std::ios::failbit );
+        _block.reserve( std::max<std::size_t>( bufferSize / sizeof( std::uint64_t ), 1 ) );
+      }
+
+      void write( std::uint64_t ordinal )
+      {
+        _block.push_back( ordinal );
+        if( _block.size() == _block.capacity() )  flush();
+      }
+
+      void flush()
+      {
+        _file.write( reinterpret_cast<char const *>( _block.data() ), static_cast<std::streamsize>( _block.size() * sizeof( std::uint64_t ) ) );
+        _file.flush();
+        _block.clear();
+      }
+
+    private:
+      std::ofstream              _file;
+      std::vector<std::uint64_t> _block;
+  };
+
+
+  class OrdinalReader
+  {
+    public:
+      OrdinalReader( std::filesystem::path const & path, std::size_t bufferSize )
+        : _file ( openForReading( path ) ),
+          _block( std::max<std::size_t>( bufferSize / sizeof( std::uint64_t ), 1 ) )
+      {}
+
+      std::uint64_t next()
+      {
+        if( _next == _size )
+        {
+          _file.read( reinterpret_cast<char *>( _block.data() ), static_cast<std::streamsize>( _block.size() * sizeof( std::uint64_t ) ) );
+          _size = static_cast<std::size_t>( _file.gcount() ) / sizeof( std::uint64_t );
+          _next = 0;
+          if( _size == 0 )  throw std::runtime_error( "mergeCatalogs: a spilled run's ordinals ended early" );
+        }
+        return _block[_next++];
+      }
+
+    private:
+      std::ifstream              _file;
+      std::vector<std::uint64_t> _block;
+      std::size_t                _next = 0;
+      std::size_t                _size = 0;
+  };
+
+
+  // One run being merged:  its current (smallest remaining) item and that item's input position
+  class RunSource
+  {
+    public:
+      RunSource( RunFiles const & run, std::size_t bufferSize )
+        : _file    ( openForReading( run.items ) ),
+          _source  ( _file, bufferSize ),
+          _ordinals( run.ordinals, bufferSize / 8 )                   // About one ordinal per 8 bytes of text
+      { advance(); }
+
+      bool                exhausted() const noexcept  { return _exhausted; }
+      GroceryItem const & item     () const noexcept  { return _item;      }
+      std::uint64_t       ordinal  () const noexcept  { return _ordinal;   }
+      GroceryItem         take     () noexcept        { return std::move( _item ); }
+
+      void advance()
+      {
+        ItemView view;
+        if( _source.next( view ) )
+        {
+          _item    = toGroceryItem( view );
+          _ordinal = _ordinals.next();
+          return;
+        }
+        if( _source.status() != ParseStatus::endOfInput )  throw std::runtime_error( std::string( "mergeCatalogs: a spilled run is corrupt:  " ) + describe( _source.status() ) );
+        _exhausted = true;
+      }
+
+    private:
+      std::ifstream _file;
+      RecordSource  _source;
+      OrdinalReader _ordinals;
+      GroceryItem   _item;
+      std::uint64_t _ordinal   = 0;
+      bool          _exhausted = false;
+  };
+
+
+  // The merge order:  operator<=> order with ties broken by exact price, then input position, which is the order sortedOrder() gives
+  // within a run.  Exhausted runs come after everything.
+  bool mergeLess( RunSource const & lhs, RunSource const & rhs ) noexcept
+  {
+    if( lhs.exhausted() || rhs.exhausted() )  return !lhs.exhausted();
+
+    auto const & left  = lhs.item();
+    auto const & right = rhs.item();
+    if( int order = left.upcCode    ().compare( right.upcCode    () );  order != 0 )  return order < 0;
+    if( int order = left.productName().compare( right.productName() );  order != 0 )  return order < 0;
+    if( int order = left.brandName  ().compare( right.brandName  () );  order != 0 )  return order < 0;
+    if( auto order = std::strong_order( left.price(), right.price() );  order != 0 )  return order < 0;
+    return lhs.ordinal() < rhs.ordinal();
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Loser tree
+  *****************************************************************************/
+  // A tournament over leafCount sources, stored as an implicit binary tree:  node n's children are nodes 2n and 2n + 1, and source i
+  // is leaf leafCount + i.  Each internal node remembers the loser of the match played there, and node 0 the overall winner, so when
+  // the winner's source moves on to its next item only the matches on the path from its leaf to the root are replayed - one comparison
+  // per level, where a binary heap would need two.
+  template< typename Less >
+  class LoserTree
+  {
+    public:
+      LoserTree( std::size_t leafCount, Less less )
+        : _nodes( leafCount, 0 ),
+          _less ( std::move( less ) )
+      {
+        std::vector<std::size_t> winners( 2 * leafCount );
+        for( std::size_t i = 0; i < leafCount; ++i )  winners[leafCount + i] = i;
+        for( std::size_t node = leafCount - 1; node > 0; --node )
+        {
+          std::size_t left = winners[2 * node],  right = winners[2 * node + 1];
+          bool        leftWins = !_less( right, left );
+          winners[node] = leftWins ? left  : right;
+          _nodes [node] = leftWins ? right : left;
+        }
+        if( leafCount > 1 )  _nodes[0] = winners[1];
+      }
+
+      std::size_t winner() const noexcept
+      { return _nodes[0]; }
+
+      // After the winner's source has changed
+      void replay()
+      {
+        std::size_t winner = _nodes[0];
+        for( std::size_t node = ( winner + _nodes.size() ) / 2; node > 0; node /= 2 )
+        {
+          if( _less( _nodes[node], winner ) )  std::swap( _nodes[node], winner );
+        }
+        _nodes[0] = winner;
+      }
+
+    private:
+      std::vector<std::size_t> _nodes;
+      Less                     _less;
+  };
+
+
+
+
+  /*****************************************************************************
+  **  Output and duplicates
+  *****************************************************************************/
+  // Receives the merged items in merge order and writes them on, to the final output or to a longer run, collapsing duplicates.
+  //
+  // A group of duplicates starts with the first item in merge order (the cheapest) and takes in every following item equal to it.
+  // Equal items share their UPC code and names, so the group's start is fully described by the item kept plus the start's price.
+  class MergedOutput
+  {
+    public:
+      MergedOutput( CatalogWriter & items, OrdinalWriter * ordinals, DuplicatePolicy policy ) noexcept
+        : _items( items ), _ordinals( ordinals ), _policy( policy )
+      {}
+
+      void push( GroceryItem && item, std::uint64_t ordinal )
+      {
+        if( _policy == DuplicatePolicy::keepAll )  return write( item, ordinal );
+
+        if( _pending && isDuplicate( item ) )
+        {
+          ++_dropped;
+          if( _policy == DuplicatePolicy::keepFirst && ordinal < _keptOrdinal )
+          {
+            _kept        = std::move( item );
+            _keptOrdinal = ordinal;
+          }
+          return;
+        }
+
+        finish();
+        _groupPrice  = item.price();
+        _kept        = std::move( item );
+        _keptOrdinal = ordinal;
+        _pending     = true;
+      }
+
+      void finish()
+      {
+        if( _pending )  write( _kept, _keptOrdinal );
+        _pending = false;
+      }
+
+      std::size_t written() const noexcept  { return _written; }
+      std::size_t dropped() const noexcept  { return _dropped; }
+
+    private:
+      bool isDuplicate( GroceryItem const & item ) const noexcept
+      {
+        return floating_point_is_equal( _groupPrice, item.price() )
+            && item.upcCode()     == _kept.upcCode()
+            && item.brandName()   == _kept.brandName()
+            && item.productName() == _kept.productName();
+      }
+
+      void write( GroceryItem const & item, std::uint64_t ordinal )
+      {
+        _items.write( item );
+        if( _ordinals != nullptr )  _ordinals->write( ordinal );
+        ++_written;
+      }
+
+      CatalogWriter & _items;
+      OrdinalWriter * _ordinals;
+      DuplicatePolicy _policy;
+
+      bool            _pending     = false;
+      GroceryItem     _kept;
+      std::uint64_t   _keptOrdinal = 0;
+      double          _groupPrice  = 0.0;
+      std::size_t     _written     = 0;
+      std::size_t     _dropped     = 0;
+  };
+
+
+  // Buffers for merging runCount runs into one output within budget:  half the budget, shared between the runs and the output
+  std::size_t mergeBufferSize( std::size_t budget, std::size_t runCount ) noexcept
+  { return std::clamp( budget / 2 / ( runCount + 1 ), minimumBufferSize, maximumBufferSize ); }
+
+
+  void mergeRuns( std::span<RunFiles const> runs, std::size_t bufferSize, MergedOutput & output )
+  {
+    std::vector<std::unique_ptr<RunSource>> sources;
+    sources.reserve( runs.size() );
+    for( auto const & run : runs )  sources.push_back( std::make_unique<RunSource>( run, bufferSize ) );
+
+    LoserTree tree( sources.size(), [&]( std::size_t lhs, std::size_t rhs ) { return mergeLess( *sources[lhs], *sources[rhs] ); } );
+    for( auto * source = sources[tree.winner()].get();  !source->exhausted();  source = sources[tree.winner()].get() )
+    {
+      std::uint64_t ordinal = source->ordinal();
+      output.push( source->take(), ordinal );
+      source->advance();
+      tree.replay();
+    }
+    output.finish();
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Merging
+*******************************************************************************/
+
+CatalogMergeResult mergeCatalogs( std::span<std::filesystem::path const> inputs, std::filesystem::path const & output, CatalogMergeOptions const & options )
+{
+  CatalogMergeResult result;
+  TemporaryDirectory temporary( options.temporaryDirectory );
+
+  // Phase 1:  read the inputs into runs of as many items as the budget holds, sorting and spilling each as it fills
+  std::size_t const budget       = std::max( options.memoryBudget, minimumBudget );
+  std::size_t const ioBufferSize = std::clamp( budget / 16, minimumBufferSize, maximumBufferSize );
+  std::size_t const itemBudget   = budget - 3 * ioBufferSize;            // Less the input's, the run's, and the ordinals' buffers
+
+  std::vector<RunFiles>    runs;
+  std::vector<GroceryItem> items;
+  std::size_t              itemBytes  = 0;
+  std::uint64_t            firstInRun = 0;                               // Input position of items[0]
+  items.reserve( itemBudget / ( sizeof( GroceryItem ) + sortOverheadPerItem ) );
+
+  auto spill = [&]
+  {
+    auto     order = sortedOrder( items, options.threadCount );
+    RunFiles run   = temporary.newRun();
+    {
+      CatalogWriter writer  ( run.items,    ioBufferSize );
+      OrdinalWriter ordinals( run.ordinals, ioBufferSize / 8 );
+      for( std::size_t position = 0; position < order.size(); ++position )
+      {
+        prefetchAhead( items, order, position );
+        writer  .write( items[order[position]] );
+        ordinals.write( firstInRun + order[position] );
+      }
+      writer  .flush();
+      ordinals.flush();
+    }
+    runs.push_back( std::move( run ) );
+
+    firstInRun += items.size();
+    itemBytes   = 0;
+    items.clear();
+  };
+
+  for( std::size_t input = 0; input < inputs.size(); ++input )
+  {
+    std::ifstream file = openForReading( inputs[input] );
+    RecordSource  source( file, ioBufferSize );
+    for( ItemView view; source.next( view ); )
+    {
+      items.push_back( toGroceryItem( view ) );
+      itemBytes += footprint( items.back() ) + sortOverheadPerItem;
+      if( itemBytes >= itemBudget )  spill();
+    }
+
+    result.recordsRead += source.recordCount();
+    if( source.status() != ParseStatus::endOfInput )
+    {
+      result.status      = source.status();
+      result.errorInput  = input;
+      result.errorLine   = source.errorLine();
+      result.errorOffset = source.errorOffset();
+      return result;
+    }
+  }
+
+  // Everything fit:  no need to touch the disk until the output is written
+  PendingOutput pending( output );
+  if( runs.empty() )
+  {
+    auto order = sortedOrder( items, options.threadCount );
+    {
+      CatalogWriter writer( pending.path(), ioBufferSize );
+      MergedOutput  merged( writer, nullptr, options.duplicates );
+      for( std::size_t position = 0; position < order.size(); ++position )
+      {
+        prefetchAhead( items, order, position );
+        merged.push( std::move( items[order[position]] ), order[position] );
+      }
+      merged.finish();
+      writer.flush();
+
+      result.recordsWritten    = merged.written();
+      result.duplicatesDropped = merged.dropped();
+    }
+    pending.commit();
+    return result;
+  }
+
+  if( !items.empty() )  spill();
+  items = {};                                                        // Its memory goes to the merge's buffers from here on
+  result.runCount = runs.size();
+
+  // Phase 2:  while there are more runs than the budget has buffers for, merge neighbouring groups of them into longer runs.
+  // Neighbours, so the runs stay in input order, and keeping every item, so the final pass still sees every duplicate.
+  std::size_t const fanIn = std::clamp( budget / 2 / minimumBufferSize - 1, std::size_t{ 2 }, maximumFanIn );
+  for( ; runs.size() > fanIn; ++result.mergePasses )
+  {
+    std::vector<RunFiles> longer;
+    for( std::size_t first = 0; first < runs.size(); first += fanIn )
+    {
+      auto group = std::span<RunFiles const>( runs ).subspan( first, std::min( fanIn, runs.size() - first ) );
+      if( group.size() == 1 )
+      {
+        longer.push_back( group.front() );
+        continue;
+      }
+
+      std::size_t bufferSize = mergeBufferSize( budget, group.size() );
+      RunFiles    run        = temporary.newRun();
+      {
+        CatalogWriter writer  ( run.items,    bufferSize );
+        OrdinalWriter ordinals( run.ordinals, bufferSize / 8 );
+        MergedOutput  merged  ( writer, &ordinals, DuplicatePolicy::keepAll );
+        mergeRuns( group, bufferSize, merged );
+        writer  .flush();
+        ordinals.flush();
+      }
+      for( auto const & merged : group )
+      {
+        std::filesystem::remove( merged.items );
+        std::filesystem::remove( merged.ordinals );
+      }
+      longer.push_back( std::move( run ) );
+    }
+    runs = std::move( longer );
+  }
+
+  // Phase 3:  the final merge, collapsing duplicates on the way out
+  {
+    std::size_t   bufferSize = mergeBufferSize( budget, runs.size() );
+    CatalogWriter writer( pending.path(), bufferSize );
+    MergedOutput  merged( writer, nullptr, options.duplicates );
+    mergeRuns( runs, bufferSize, merged );
+    writer.flush();
+    ++result.mergePasses;
+
+    result.recordsWritten    = merged.written();
+    result.duplicatesDropped = merged.dropped();
+  }
+  pending.commit();
+  return result;
+}
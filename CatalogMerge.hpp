@@ -0,0 +1,68 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <filesystem>                                                         // path
+#include <span>
+
+#include "GroceryItemParser.hpp"                                              // ParseStatus
+
+
+
+
+// What to do with grocery items that are equal (GroceryItem::operator==:  the same UPC code, brand and product names, and prices
+// within epsilon) when catalogs are merged
+enum class DuplicatePolicy
+{
+  keepAll,                                                                    // Keep every one:  a plain merge sort
+  keepFirst,                                                                  // Keep the one read first (the earliest input, then the earliest line in it)
+  keepLowestPrice                                                             // Keep the cheapest, or of equally cheap ones, the one read first
+};
+
+
+struct CatalogMergeOptions
+{
+  std::size_t           memoryBudget       = std::size_t{ 256 } << 20;       // Bytes the merge may use for items and buffers.  Raised to 4 MiB if less
+  DuplicatePolicy       duplicates         = DuplicatePolicy::keepFirst;
+  std::filesystem::path temporaryDirectory = {};                              // Where runs are spilled.  Empty means std::filesystem::temp_directory_path()
+  unsigned              threadCount        = 0;                               // For sorting each run (see sortCatalog()).  0 means one per hardware thread
+};
+
+
+struct CatalogMergeResult
+{
+  std::size_t recordsRead       = 0;
+  std::size_t recordsWritten    = 0;
+  std::size_t duplicatesDropped = 0;
+  std::size_t runCount          = 0;                                          // Sorted runs spilled to disk.  0 when everything fit in the budget at once
+  std::size_t mergePasses       = 0;                                          // Passes over the runs:  1 unless there were too many runs to merge at once
+
+  ParseStatus status      = ParseStatus::endOfInput;                          // endOfInput when every input was read, otherwise why the failing record was rejected
+  std::size_t errorInput  = 0;                                                // Index into inputs of the file holding the failing record
+  std::size_t errorLine   = 0;                                                // 1-based line on which the failing record starts (0 when there was no failure)
+  std::size_t errorOffset = 0;                                                // Byte offset of the failing record's first character
+};
+
+
+
+
+// Merges catalog files in operator<< text form into one, sorted into GroceryItem::operator<=> order, collapsing duplicates as
+// options.duplicates says.  The inputs need not be sorted, and together they may be far larger than memory.
+//
+// External merge sort:  the inputs are read in order, through fixed-size buffers (see RecordSource), into runs of as many items as
+// the memory budget allows.  Each run is sorted with sortedOrder() and spilled to a temporary file, in the exact-price text form
+// CatalogWriter writes, alongside a file of each item's position in the input.  The runs are then merged through a loser tree, which
+// finds each next item with one comparison per level of a tree over the runs.  When there are more runs than the budget has read
+// buffers for, groups of them are first merged into longer runs.  If everything fits in one run, nothing is spilled.
+//
+// Order and duplicates:  items are merged in operator<=> order, ties broken by exact price, then input position - the order
+// sortCatalog() gives the concatenated inputs.  operator== isn't transitive (two prices within epsilon of a third needn't be within
+// epsilon of each other), so a group of duplicates is defined as the item that comes first in that order (the cheapest) and every
+// following item equal to it.  The output is the same whatever the memory budget, and is exactly what sorting all the inputs in
+// memory and then collapsing duplicates would give.
+//
+// A record that doesn't parse stops the merge before anything is written:  the result says which input, line, and why, and output
+// is left untouched.  I/O errors throw std::system_error, also leaving output untouched:  the merge is written to a temporary file in
+// output's directory and renamed over output only once complete.  Temporary files are removed either way.
+CatalogMergeResult mergeCatalogs( std::span<std::filesystem::path const> inputs,
+                                  std::filesystem::path const &          output,
+                                  CatalogMergeOptions const &            options = {} );
@@ -0,0 +1,443 @@
+#include <algorithm>                                                  // min()
+#include <array>
+#include <bit>                                                        // rotl()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint32_t, uint64_t
+#include <cstring>                                                    // memcpy(), memcmp()
+#include <filesystem>                                                 // path
+#include <fstream>                                                    // ofstream
+#include <span>
+#include <stdexcept>                                                  // runtime_error
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CatalogSnapshot.hpp"
+#include "GroceryItem.hpp"
+#include "MappedFile.hpp"
+#include "PendingOutput.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr char          magic[8]        = { 'G', 'R', 'O', 'C', 'S', 'N', 'A', 'P' };
+  constexpr std::uint32_t byteOrderMark   = 0x01020304;
+  constexpr std::size_t   upcSlotSize     = 16;
+  constexpr std::size_t   upcInlineLength = upcSlotSize - 1;
+  constexpr unsigned char upcOverflowTag  = 0xFF;
+
+
+  struct Section                                                      // Where a section starts, and how many bytes it holds
+  {
+    std::uint64_t offset = 0;
+    std::uint64_t size   = 0;
+  };
+
+
+  struct Header
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint64_t itemCount;
+    Section       upcSlots;
+    Section       prices;
+    Section       brandOffsets;
+    Section       brandBlob;
+    Section       productOffsets;
+    Section       productBlob;
+    Section       upcOverflow;
+    std::uint64_t checksum;                                           // Of every byte after the header
+  };
+
+  static_assert( sizeof( Header ) % 8 == 0, "sections must start 8-byte aligned" );
+
+
+  constexpr std::uint64_t alignUp( std::uint64_t offset ) noexcept
+  { return ( offset + 7 ) & ~std::uint64_t{ 7 }; }
+
+
+
+
+  // A 64-bit checksum in the style of xxHash64:  four independent multiply-rotate lanes over 32-byte stripes, so it runs at memory
+  // speed, and fed incrementally so the writer never has to hold the whole file.
+  class Checksum
+  {
+    public:
+      void update( void const * data, std::size_t size ) noexcept
+      {
+        auto bytes = static_cast<unsigned char const *>( data );
+        _total += size;
+
+        if( _pendingSize != 0 )
+        {
+          auto count = std::min( size, stripeSize - _pendingSize );
+          std::memcpy( _pending.data() + _pendingSize, bytes, count );
+          _pendingSize += count;
+          bytes        += count;
+          size         -= count;
+          if( _pendingSize < stripeSize )  return;
+
+          consume( _pending.data() );
+          _pendingSize = 0;
+        }
+
+        for( ; size >= stripeSize; bytes += stripeSize, size -= stripeSize )  consume( bytes );
+
+        std::memcpy( _pending.data(), bytes, size );
+        _pendingSize = size;
+      }
+
+
+      std::uint64_t finish() const noexcept
+      {
+        std::uint64_t hash = std::rotl( _lanes[0], 1 ) + std::rotl( _lanes[1], 7 ) + std::rotl( _lanes[2], 12 ) + std::rotl( _lanes[3], 18 );
+        for( auto lane : _lanes )  hash = ( hash ^ round( 0, lane ) ) * prime1 + prime4;
+        hash += _total;
+
+        std::size_t i = 0;
+        for( ; i + 8 <= _pendingSize; i += 8 )  hash = std::rotl( hash ^ round( 0, load64( _pending.data() + i ) ), 27 ) * prime1 + prime4;
+        for( ; i     <  _pendingSize; ++i    )  hash = std::rotl( hash ^ ( _pending[i] * prime5 ), 11 ) * prime1;
+
+        hash ^= hash >> 33;  hash *= prime2;
+        hash ^= hash >> 29;  hash *= prime3;
+        hash ^= hash >> 32;
+        return hash;
+      }
+
+    private:
+      static constexpr std::uint64_t prime1     = 0x9E3779B185EBCA87ULL;
+      static constexpr std::uint64_t prime2     = 0xC2B2AE3D27D4EB4FULL;
+      static constexpr std::uint64_t prime3     = 0x165667B19E3779F9ULL;
+      static constexpr std::uint64_t prime4     = 0x85EBCA77C2B2AE63ULL;
+      static constexpr std::uint64_t prime5     = 0x27D4EB2F165667C5ULL;
+      static constexpr std::size_t   stripeSize = 32;
+
+      static std::uint64_t load64( unsigned char const * bytes ) noexcept
+      {
+        std::uint64_t word;
+        std::memcpy( &word, bytes, sizeof word );
+        return word;
+      }
+
+      static std::uint64_t round( std::uint64_t lane, std::uint64_t input ) noexcept
+      { return std::rotl( lane + input * prime2, 31 ) * prime1; }
+
+      void consume( unsigned char const * stripe ) noexcept
+      {
+        for( std::size_t lane = 0; lane < 4; ++lane )  _lanes[lane] = round( _lanes[lane], load64( stripe + 8 * lane ) );
+      }
+
+      std::array<std::uint64_t, 4>          _lanes       = { prime1 + prime2, prime2, 0, 0 - prime1 };
+      std::array<unsigned char, stripeSize> _pending     = {};
+      std::size_t                           _pendingSize = 0;
+      std::uint64_t                         _total       = 0;
+  };
+
+
+
+
+  // Buffered, checksummed output of everything after the header
+  class SnapshotOutput
+  {
+    public:
+      explicit SnapshotOutput( std::filesystem::path const & path )
+      {
+        _file.exceptions( std::ios::failbit | std::ios::badbit );
+        _file.open( path, std::ios::binary | std::ios::trunc );
+        _buffer.reserve( bufferSize );
+        _buffer.resize( sizeof( Header ) );                           // Room for the header, which is written last and not checksummed
+        _offset = sizeof( Header );
+      }
+
+      void put( void const * data, std::size_t size )
+      {
+        auto bytes = static_cast<char const *>( data );
+        _checksum.update( bytes, size );
+        _offset += size;
+        if( _buffer.size() + size > bufferSize )  drain();
+        if( size > bufferSize )  _file.write( bytes, static_cast<std::streamsize>( size ) );
+        else                     _buffer.insert( _buffer.end(), bytes, bytes + size );
+      }
+
+      template< typename T >
+      void put( T const & value )
+      { put( &value, sizeof value ); }
+
+      void pad( std::uint64_t offset )                                // Zeros up to offset
+      {
+        static constexpr char zeros[8] = {};
+        while( _offset < offset )  put( zeros, std::min<std::uint64_t>( offset - _offset, sizeof zeros ) );
+      }
+
+      void finish( Header header )
+      {
+        drain();
+        header.checksum = _checksum.finish();
+        _file.seekp( 0 );
+        _file.write( reinterpret_cast<char const *>( &header ), sizeof header );
+        _file.close();
+      }
+
+    private:
+      static constexpr std::size_t bufferSize = std::size_t{ 1 } << 20;
+
+      void drain()
+      {
+        _file.write( _buffer.data(), static_cast<std::streamsize>( _buffer.size() ) );
+        _buffer.clear();
+      }
+
+      std::ofstream     _file;
+      std::vector<char> _buffer;
+      std::uint64_t     _offset = 0;
+      Checksum          _checksum;
+  };
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Writing
+*******************************************************************************/
+
+void CatalogSnapshot::write( std::filesystem::path const & path, std::span<GroceryItem const> items )
+{
+  std::uint64_t const count = items.size();
+
+  std::uint64_t brandBytes = 0,  productBytes = 0,  overflowBytes = 0;
+  for( auto const & item : items )
+  {
+    brandBytes   += item.brandName()  .size();
+    productBytes += item.productName().size();
+    if( item.upcCode().size() > upcInlineLength )  overflowBytes += item.upcCode().size();
+  }
+
+  // Lay the sections out back to back, each 8-byte aligned
+  Header header{};
+  std::memcpy( header.magic, magic, sizeof magic );
+  header.version       = formatVersion;
+  header.byteOrderMark = byteOrderMark;
+  header.itemCount     = count;
+
+  std::uint64_t offset = sizeof( Header );
+  auto place = [&]( Section & section, std::uint64_t size )
+  {
+    section = { offset, size };
+    offset  = alignUp( offset + size );
+  };
+  place( header.upcSlots,       count * upcSlotSize                  );
+  place( header.prices,         count * sizeof( double )             );
+  place( header.brandOffsets,   ( count + 1 ) * sizeof( std::uint64_t ) );
+  place( header.brandBlob,      brandBytes                           );
+  place( header.productOffsets, ( count + 1 ) * sizeof( std::uint64_t ) );
+  place( header.productBlob,    productBytes                         );
+  place( header.upcOverflow,    overflowBytes                        );
+
+
+  // Written beside path and renamed over it once complete:  a failed write leaves the previous snapshot whole, and services that
+  // have it mapped keep their pages rather than taking SIGBUS as the file is truncated under them
+  PendingOutput  pending( path );
+  SnapshotOutput output( pending.path() );
+
+  output.pad( header.upcSlots.offset );
+  std::uint64_t overflowOffset = 0;
+  for( auto const & item : items )
+  {
+    std::array<unsigned char, upcSlotSize> slot{};
+    auto const & upc = item.upcCode();
+    if( upc.size() <= upcInlineLength )
+    {
+      std::memcpy( slot.data(), upc.data(), upc.size() );
+      slot.back() = static_cast<unsigned char>( upc.size() );
+    }
+    else
+    {
+      auto length = static_cast<std::uint32_t>( upc.size() );
+      std::memcpy( slot.data(),     &overflowOffset, sizeof overflowOffset );
+      std::memcpy( slot.data() + 8, &length,         sizeof length         );
+      slot.back()     = upcOverflowTag;
+      overflowOffset += length;
+    }
+    output.put( slot );
+  }
+
+  output.pad( header.prices.offset );
+  for( auto const & item : items )  output.put( item.price() );
+
+  auto putStrings = [&]( Section const & offsets, Section const & blob, auto field )
+  {
+    output.pad( offsets.offset );
+    std::uint64_t position = 0;
+    output.put( position );
+    for( auto const & item : items )  output.put( position += field( item ).size() );
+
+    output.pad( blob.offset );
+    for( auto const & item : items )  output.put( field( item ).data(), field( item ).size() );
+  };
+  putStrings( header.brandOffsets,   header.brandBlob,   []( GroceryItem const & item ) -> std::string const & { return item.brandName();   } );
+  putStrings( header.productOffsets, header.productBlob, []( GroceryItem const & item ) -> std::string const & { return item.productName(); } );
+
+  output.pad( header.upcOverflow.offset );
+  for( auto const & item : items )
+  {
+    if( item.upcCode().size() > upcInlineLength )  output.put( item.upcCode().data(), item.upcCode().size() );
+  }
+
+  output.pad( offset );
+  output.finish( header );
+  pending.commit();
+}
+
+
+
+
+/*******************************************************************************
+**  Opening and integrity
+*******************************************************************************/
+
+CatalogSnapshot::CatalogSnapshot( std::filesystem::path const & path )
+  : _file( path, MappedFile::Access::random )
+{
+  auto reject = [&]( char const * reason ) { throw std::runtime_error( "CatalogSnapshot: " + path.string() + " " + reason ); };
+
+  Header header;
+  if( _file.size() < sizeof header )  reject( "is too small to be a catalog snapshot" );
+  std::memcpy( &header, _file.data(), sizeof header );
+
+  if( std::memcmp( header.magic, magic, sizeof magic ) != 0 )  reject( "is not a catalog snapshot" );
+  if( header.byteOrderMark != byteOrderMark                 )  reject( "was written with a different byte order" );
+  if( header.version       != formatVersion                 )  reject( "is a snapshot format version this build can't read" );
+
+  // Every section must lie inside the file, 8-byte aligned, and the fixed-width ones must be exactly the size the item count implies
+  std::uint64_t const fileSize = _file.size();
+  std::uint64_t const count    = header.itemCount;
+  auto fits = [&]( Section const & section )
+  {
+    return section.offset % 8 == 0 && section.offset >= sizeof header && section.size <= fileSize && section.offset <= fileSize - section.size;
+  };
+
+  if(    count > fileSize / upcSlotSize
+      || !fits( header.upcSlots )       || header.upcSlots      .size != count * upcSlotSize
+      || !fits( header.prices )         || header.prices        .size != count * sizeof( double )
+      || !fits( header.brandOffsets )   || header.brandOffsets  .size != ( count + 1 ) * sizeof( std::uint64_t )
+      || !fits( header.productOffsets ) || header.productOffsets.size != ( count + 1 ) * sizeof( std::uint64_t )
+      || !fits( header.brandBlob )      || !fits( header.productBlob ) || !fits( header.upcOverflow ) )
+  {
+    reject( "has a damaged header" );
+  }
+
+  auto at = [&]( Section const & section ) { return _file.data() + section.offset; };
+  _size           = static_cast<size_type>( count );
+  _upcSlots       = reinterpret_cast<unsigned char const *>( at( header.upcSlots       ) );
+  _prices         = reinterpret_cast<double        const *>( at( header.prices         ) );
+  _brandOffsets   = reinterpret_cast<std::uint64_t const *>( at( header.brandOffsets   ) );
+  _brandBlob      =                                          at( header.brandBlob      );
+  _productOffsets = reinterpret_cast<std::uint64_t const *>( at( header.productOffsets ) );
+  _productBlob    =                                          at( header.productBlob    );
+  _upcOverflow    =                                          at( header.upcOverflow    );
+}
+
+
+bool CatalogSnapshot::verify() const noexcept
+{
+  Header header;
+  std::memcpy( &header, _file.data(), sizeof header );
+
+  Checksum checksum;
+  checksum.update( _file.data() + sizeof header, _file.size() - sizeof header );
+  if( checksum.finish() != header.checksum )  return false;
+
+  // Offset tables:  start at zero, never decrease, and end exactly at the end of their blob
+  auto ascending = [&]( std::uint64_t const * offsets, std::uint64_t blobSize )
+  {
+    if( offsets[0] != 0 || offsets[_size] != blobSize )  return false;
+    for( size_type i = 0; i < _size; ++i )  if( offsets[i] > offsets[i + 1] )  return false;
+    return true;
+  };
+  if( !ascending( _brandOffsets, header.brandBlob.size ) || !ascending( _productOffsets, header.productBlob.size ) )  return false;
+
+  // UPC slots:  inline lengths in range, overflow references inside the overflow blob
+  for( size_type i = 0; i < _size; ++i )
+  {
+    unsigned char const * slot = _upcSlots + i * upcSlotSize;
+    if( slot[upcSlotSize - 1] == upcOverflowTag )
+    {
+      std::uint64_t offset;
+      std::uint32_t length;
+      std::memcpy( &offset, slot,     sizeof offset );
+      std::memcpy( &length, slot + 8, sizeof length );
+      if( offset > header.upcOverflow.size || length > header.upcOverflow.size - offset )  return false;
+    }
+    else if( slot[upcSlotSize - 1] > upcInlineLength )  return false;
+  }
+  return true;
+}
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+
+CatalogSnapshot::size_type CatalogSnapshot::size() const noexcept
+{ return _size; }
+
+
+bool CatalogSnapshot::empty() const noexcept
+{ return _size == 0; }
+
+
+std::string_view CatalogSnapshot::upcCode( size_type item ) const noexcept
+{
+  unsigned char const * slot   = _upcSlots + item * upcSlotSize;
+  unsigned char         length = slot[upcSlotSize - 1];
+  if( length != upcOverflowTag )  return { reinterpret_cast<char const *>( slot ), length };
+
+  std::uint64_t offset;
+  std::uint32_t overflowLength;
+  std::memcpy( &offset,         slot,     sizeof offset         );
+  std::memcpy( &overflowLength, slot + 8, sizeof overflowLength );
+  return { _upcOverflow + offset, overflowLength };
+}
+
+
+std::string_view CatalogSnapshot::brandName( size_type item ) const noexcept
+{ return { _brandBlob + _brandOffsets[item], _brandOffsets[item + 1] - _brandOffsets[item] }; }
+
+
+std::string_view CatalogSnapshot::productName( size_type item ) const noexcept
+{ return { _productBlob + _productOffsets[item], _productOffsets[item + 1] - _productOffsets[item] }; }
+
+
+double CatalogSnapshot::price( size_type item ) const noexcept
+{ return _prices[item]; }
+
+
+std::span<double const> CatalogSnapshot::prices() const noexcept
+{ return { _prices, _size }; }
+
+
+
+
+/*******************************************************************************
+**  Conversion back to grocery items
+*******************************************************************************/
+
+GroceryItem CatalogSnapshot::item( size_type item ) const
+{ return GroceryItem( std::string( productName( item ) ), std::string( brandName( item ) ), std::string( upcCode( item ) ), price( item ) ); }
+
+
+std::vector<GroceryItem> CatalogSnapshot::toItems() const
+{
+  std::vector<GroceryItem> items;
+  items.reserve( _size );
+  for( size_type i = 0; i < _size; ++i )  items.push_back( item( i ) );
+  return items;
+}
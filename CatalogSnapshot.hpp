@@ -0,0 +1,74 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint32_t, uint64_t
+#include <filesystem>                                                         // path
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "MappedFile.hpp"
+
+
+
+
+// A binary image of a catalog that is used where it lies:  opening a snapshot maps the file and checks its header, and nothing is
+// read or converted until it's asked for, so a service can start on a catalog of any size in well under a millisecond.
+//
+// Layout (native byte order, every section 8-byte aligned, offsets are from the start of the file):
+//   o)  header          magic, format version, byte order mark, item count, the offset and size of every section, and a checksum
+//                       of everything after the header
+//   o)  UPC codes       one 16-byte slot per item:  up to 15 characters and their length in the last byte, or, for longer codes,
+//                       0xFF in the last byte with the code's offset (8 bytes) and length (4 bytes) in the UPC overflow blob
+//   o)  prices          one double per item, directly usable as a std::span<double const> (e.g. by the batch kernels in PriceKernels.hpp)
+//   o)  brand names     item count + 1 ascending 8-byte offsets into the brand blob, then the blob; item i is [offsets[i], offsets[i+1])
+//   o)  product names   the same, for product names
+//   o)  UPC overflow    the text of UPC codes longer than 15 characters
+class CatalogSnapshot
+{
+  public:
+    using size_type = std::size_t;
+
+    static constexpr std::uint32_t formatVersion = 1;
+
+    // Writes items to path as a snapshot, replacing any existing file only once the new one is complete (see PendingOutput.hpp), so a
+    // failure leaves the old snapshot intact.  Throws std::system_error on failure:  std::ios_base::failure writing, or
+    // std::filesystem::filesystem_error renaming.
+    static void write( std::filesystem::path const & path, std::span<GroceryItem const> items );
+
+    // Maps the snapshot at path and checks that its header describes sections that fit in the file.  Throws std::system_error if the
+    // file can't be mapped and std::runtime_error if it isn't a snapshot this version can read.  The checksum is not checked here (that
+    // means reading the whole file); call verify() for that.
+    explicit CatalogSnapshot( std::filesystem::path const & path );
+
+
+    // Integrity
+    bool verify() const noexcept;                                             // Checksum matches and every offset table is in bounds and ascending
+
+
+    // Queries, straight from the mapping.  Views are valid as long as the snapshot is.
+    size_type                size       () const noexcept;
+    bool                     empty      () const noexcept;
+    std::string_view         upcCode    ( size_type item ) const noexcept;
+    std::string_view         brandName  ( size_type item ) const noexcept;
+    std::string_view         productName( size_type item ) const noexcept;
+    double                   price      ( size_type item ) const noexcept;
+    std::span<double const>  prices     () const noexcept;
+
+
+    // Conversion back to grocery items
+    GroceryItem              item       ( size_type item ) const;
+    std::vector<GroceryItem> toItems    () const;
+
+  private:
+    MappedFile            _file;
+    size_type             _size           = 0;
+    unsigned char const * _upcSlots       = nullptr;
+    double const *        _prices         = nullptr;
+    std::uint64_t const * _brandOffsets   = nullptr;
+    char const *          _brandBlob      = nullptr;
+    std::uint64_t const * _productOffsets = nullptr;
+    char const *          _productBlob    = nullptr;
+    char const *          _upcOverflow    = nullptr;
+};
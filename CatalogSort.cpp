@@ -0,0 +1,266 @@
+#include <algorithm>                                                  // sort(), copy(), clamp(), all_of(), any_of(), find_if_not()
+#include <array>
+#include <bit>                                                        // bit_width(), byteswap(), endian
+#include <compare>                                                    // strong_order()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint32_t, uint64_t
+#include <cstring>                                                    // memcpy()
+#include <limits>
+#include <span>
+#include <stdexcept>                                                  // length_error
+#include <string_view>
+#include <utility>                                                    // move()
+#include <vector>
+
+#include "CatalogSort.hpp"
+#include "GroceryItem.hpp"
+#include "PackedUpc.hpp"
+#include "Parallel.hpp"                                               // runInParallel(), resolveThreadCount()
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // An item's sort key:  comparing (high, low) as unsigned integers orders items as operator<=> does, except that equal keys may
+  // belong to items that differ further on
+  struct SortKey
+  {
+    std::uint64_t high;
+    std::uint64_t low;
+    std::uint32_t item;
+  };
+
+
+  constexpr std::size_t minimumChunkSize = 1 << 16;                   // Items per parallel chunk when building and bucketing keys
+  constexpr std::size_t targetBucketSize = 1 << 13;                   // Items per MSD bucket to aim for, so a bucket's keys fit in L2 cache
+  constexpr unsigned    maxBucketBits    = 16;
+  constexpr std::size_t smallBucketSize  = 64;                        // Buckets this small are comparison sorted instead
+
+
+  // Eight bytes of text starting at offset, zero padded, as a big-endian integer:  integer order is the text's lexicographic order
+  // (char_traits<char> compares as unsigned char), up to ties between a prefix and the same prefix followed by '\0's
+  std::uint64_t prefixKey( std::string_view text, std::size_t offset ) noexcept
+  {
+    std::uint64_t word = 0;
+    if( offset < text.size() )  std::memcpy( &word, text.data() + offset, std::min<std::size_t>( 8, text.size() - offset ) );
+    if constexpr( std::endian::native == std::endian::little )  word = std::byteswap( word );
+    return word;
+  }
+
+
+  bool keyLess( SortKey const & lhs, SortKey const & rhs ) noexcept
+  { return lhs.high != rhs.high ? lhs.high < rhs.high : lhs.low < rhs.low; }
+
+
+  bool keyEqual( SortKey const & lhs, SortKey const & rhs ) noexcept
+  { return lhs.high == rhs.high && lhs.low == rhs.low; }
+
+
+  // The documented total order:  operator<=> on the names, then exact price, then original position
+  struct FullLess
+  {
+    std::span<GroceryItem const> items;
+
+    bool operator()( SortKey const & lhs, SortKey const & rhs ) const noexcept
+    {
+      GroceryItem const & a = items[lhs.item];
+      GroceryItem const & b = items[rhs.item];
+      if( auto cmp = a.upcCode()     <=> b.upcCode();      cmp != 0 )  return cmp < 0;
+      if( auto cmp = a.productName() <=> b.productName();  cmp != 0 )  return cmp < 0;
+      if( auto cmp = a.brandName()   <=> b.brandName();    cmp != 0 )  return cmp < 0;
+      if( auto cmp = std::strong_order( a.price(), b.price() );  cmp != 0 )  return cmp < 0;
+      return lhs.item < rhs.item;
+    }
+  };
+
+
+  // Least-significant-digit radix sort of keys on (high, low), a byte at a time, ping-ponging with scratch.  One counting pass finds
+  // the byte positions on which every key agrees, and those are skipped.  The result ends up in keys.
+  void radixSort( std::span<SortKey> keys, std::span<SortKey> scratch )
+  {
+    std::array<std::array<std::uint32_t, 256>, 16> counts{};
+    for( auto const & key : keys )
+    {
+      for( unsigned byte = 0; byte < 8; ++byte )
+      {
+        ++counts[byte    ][( key.low  >> ( 8 * byte ) ) & 0xFF];
+        ++counts[byte + 8][( key.high >> ( 8 * byte ) ) & 0xFF];
+      }
+    }
+
+    std::span<SortKey> source = keys,  destination = scratch;
+    for( unsigned digit = 0; digit < 16; ++digit )
+    {
+      auto & count = counts[digit];
+      if( std::any_of( count.begin(), count.end(), [&]( std::uint32_t n ) { return n == keys.size(); } ) )  continue;
+
+      std::array<std::uint32_t, 256> next;
+      std::uint32_t                  offset = 0;
+      for( unsigned value = 0; value < 256; ++value )  { next[value] = offset;  offset += count[value]; }
+
+      for( auto const & key : source )
+      {
+        std::uint64_t word = digit < 8 ? key.low : key.high;
+        destination[next[( word >> ( 8 * ( digit % 8 ) ) ) & 0xFF]++] = key;
+      }
+      std::swap( source, destination );
+    }
+
+    if( source.data() != keys.data() )  std::copy( source.begin(), source.end(), keys.begin() );
+  }
+
+
+  std::vector<std::uint32_t> sortPermutation( std::span<GroceryItem const> items, unsigned threadCount )
+  {
+    std::size_t const count = items.size();
+    if( count >= std::numeric_limits<std::uint32_t>::max() )  throw std::length_error( "sortCatalog:  too many items" );
+
+    threadCount = resolveThreadCount( threadCount );
+    std::size_t const chunkCount = std::clamp<std::size_t>( count / minimumChunkSize, 1, std::size_t{ threadCount } * 4 );
+    auto chunkBegin = [&]( std::size_t chunk ) { return count / chunkCount * chunk + std::min( chunk, count % chunkCount ); };
+
+
+    // Keys.  Packed UPC codes are complete, which frees the low half of the key for the product name, but only if every code packs;
+    // if one doesn't, all keys are built again from the codes' bytes
+    std::vector<SortKey>       keys   ( count );
+    std::vector<std::uint64_t> lowest ( chunkCount );
+    std::vector<std::uint64_t> highest( chunkCount );
+    std::vector<char>          packed ( chunkCount );
+    auto buildKeys = [&]( bool packUpcs )
+    {
+      runInParallel( threadCount, chunkCount, [&]( std::size_t chunk )
+      {
+        lowest [chunk] = std::numeric_limits<std::uint64_t>::max();
+        highest[chunk] = 0;
+        packed [chunk] = 1;
+        for( std::size_t i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )
+        {
+          std::string_view upc = items[i].upcCode();
+          auto & key = keys[i];
+          key.item = static_cast<std::uint32_t>( i );
+          if( packUpcs )
+          {
+            auto packedUpc = PackedUpc::pack( upc );
+            if( !packedUpc )  { packed[chunk] = 0;  return; }
+            key.high = packedUpc->value();
+            key.low  = prefixKey( items[i].productName(), 0 );
+          }
+          else
+          {
+            key.high = prefixKey( upc, 0 );
+            key.low  = prefixKey( upc, 8 );
+          }
+
+          lowest [chunk] = std::min( lowest [chunk], key.high );
+          highest[chunk] = std::max( highest[chunk], key.high );
+        }
+      } );
+    };
+    buildKeys( true );
+    if( !std::all_of( packed.begin(), packed.end(), []( char chunkPacked ) { return chunkPacked != 0; } ) )  buildKeys( false );
+    if( count == 0 )  return {};
+
+
+    // Most-significant-digit pass:  the top bucketBits bits on which the high keys differ choose the bucket.  Each chunk counts its
+    // keys per bucket, and the counts give every chunk its own place in every bucket, so the chunks scatter in parallel.
+    std::uint64_t const minHigh    = *std::min_element( lowest .begin(), lowest .end() );
+    std::uint64_t const maxHigh    = *std::max_element( highest.begin(), highest.end() );
+    auto const          diffBits   = static_cast<unsigned>( std::bit_width( minHigh ^ maxHigh ) );
+    auto const          bucketBits = std::min( { diffBits, maxBucketBits, static_cast<unsigned>( std::bit_width( count / targetBucketSize ) ) } );
+    auto const          shift      = diffBits - bucketBits;
+    std::size_t const   buckets    = std::size_t{ 1 } << bucketBits;
+    auto bucketOf = [&]( SortKey const & key ) -> std::size_t        // With one bucket, shift can be 64, too far to shift by
+    { return bucketBits == 0 ? 0 : static_cast<std::size_t>( ( key.high >> shift ) - ( minHigh >> shift ) ); };
+
+    std::vector<std::uint32_t> counts( chunkCount * buckets, 0 );
+    runInParallel( threadCount, chunkCount, [&]( std::size_t chunk )
+    {
+      for( std::size_t i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )  ++counts[chunk * buckets + bucketOf( keys[i] )];
+    } );
+
+    std::vector<std::size_t> bucketStart( buckets + 1, 0 );
+    std::vector<std::size_t> scatterAt  ( chunkCount * buckets );
+    for( std::size_t bucket = 0, offset = 0; bucket < buckets; ++bucket )
+    {
+      bucketStart[bucket] = offset;
+      for( std::size_t chunk = 0; chunk < chunkCount; ++chunk )
+      {
+        scatterAt[chunk * buckets + bucket] = offset;
+        offset += counts[chunk * buckets + bucket];
+      }
+    }
+    bucketStart[buckets] = count;
+
+    std::vector<SortKey> scratch( count );
+    runInParallel( threadCount, chunkCount, [&]( std::size_t chunk )
+    {
+      std::size_t * next = scatterAt.data() + chunk * buckets;
+      for( std::size_t i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )  scratch[next[bucketOf( keys[i] )]++] = keys[i];
+    } );
+
+
+    // Each bucket:  radix sort the keys (from scratch back into keys), then put runs of equal keys in full order
+    runInParallel( threadCount, buckets, [&]( std::size_t bucket )
+    {
+      std::span<SortKey> sorted    ( keys   .data() + bucketStart[bucket], bucketStart[bucket + 1] - bucketStart[bucket] );
+      std::span<SortKey> unsorted  ( scratch.data() + bucketStart[bucket], sorted.size() );
+      if( sorted.empty() )  return;
+
+      if( sorted.size() <= smallBucketSize )
+      {
+        std::copy( unsorted.begin(), unsorted.end(), sorted.begin() );
+        std::sort( sorted.begin(), sorted.end(), keyLess );
+      }
+      else
+      {
+        std::copy( unsorted.begin(), unsorted.end(), sorted.begin() );
+        radixSort( sorted, unsorted );
+      }
+
+      for( auto run = sorted.begin(); run != sorted.end(); )
+      {
+        auto runEnd = std::find_if_not( run + 1, sorted.end(), [&]( SortKey const & key ) { return keyEqual( key, *run ); } );
+        if( runEnd - run > 1 )  std::sort( run, runEnd, FullLess{ items } );
+        run = runEnd;
+      }
+    } );
+
+    std::vector<std::uint32_t> permutation( count );
+    for( std::size_t i = 0; i < count; ++i )  permutation[i] = keys[i].item;
+    return permutation;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Sorting
+*******************************************************************************/
+
+void sortCatalog( std::span<GroceryItem> items, unsigned threadCount )
+{
+  auto permutation = sortPermutation( items, threadCount );
+
+  // Gathering into a new vector reads the items in random order but writes them in order, and the reads can be prefetched; moving
+  // items around the permutation's cycles in place would miss the cache on every read and every write
+  constexpr std::size_t prefetchDistance = 8;
+  std::vector<GroceryItem> sorted;
+  sorted.reserve( items.size() );
+  for( std::size_t i = 0; i < permutation.size(); ++i )
+  {
+    if( i + prefetchDistance < permutation.size() )  __builtin_prefetch( &items[permutation[i + prefetchDistance]] );
+    sorted.push_back( std::move( items[permutation[i]] ) );
+  }
+  std::move( sorted.begin(), sorted.end(), items.begin() );
+}
+
+
+std::vector<std::size_t> sortedOrder( std::span<GroceryItem const> items, unsigned threadCount )
+{
+  auto permutation = sortPermutation( items, threadCount );
+  return std::vector<std::size_t>( permutation.begin(), permutation.end() );
+}
@@ -0,0 +1,32 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <span>
+#include <vector>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// Sorts grocery items into GroceryItem::operator<=> order (UPC code, product name, brand name, then price) without calling
+// operator<=> for all but a few comparisons.
+//
+// Each item gets a 16-byte key that orders items the way operator<=> does as far as the key goes:  the UPC code packed into 64 bits
+// (see PackedUpc) plus the first 8 bytes of the product name, or, when some UPC code in the catalog can't be packed, the first 16
+// bytes of the UPC code.  The keys, small enough to stay in cache, are radix sorted:  one parallel most-significant-digit pass
+// spreads them into buckets, and each bucket is finished by a least-significant-digit radix sort on its own thread, skipping byte
+// positions on which the whole bucket agrees.  Only items whose keys tie are compared field by field.  Then the items are gathered
+// into sorted order and moved back.
+//
+// Ties:  items with equal UPC codes, product names, and brand names whose prices are within operator<=>'s epsilon are equivalent,
+// and std::sort leaves their relative order unspecified.  sortCatalog() always orders them by exact price, ascending (by
+// std::strong_order, so -0.0 before +0.0), then by original position.  The result is therefore deterministic, it is sorted by
+// operator<=> ( std::is_sorted( items.begin(), items.end() ) holds), and it is exactly what std::stable_sort gives for
+// "operator<=> on the names, then exact price".
+//
+// threadCount 0 means one thread per hardware thread.  At most 2^32 - 1 items.
+void sortCatalog( std::span<GroceryItem> items, unsigned threadCount = 0 );
+
+// The same order, as a permutation:  sortedOrder( items )[i] is the index of the item that belongs at position i.  items is not changed.
+std::vector<std::size_t> sortedOrder( std::span<GroceryItem const> items, unsigned threadCount = 0 );
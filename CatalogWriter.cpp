@@ -0,0 +1,341 @@
+#include <algorithm>                                                  // max(), min()
+#include <cerrno>                                                     // errno, EINTR
+#include <charconv>                                                   // to_chars(), chars_format
+#include <climits>                                                    // IOV_MAX
+#include <cstddef>                                                    // size_t
+#include <cstring>                                                    // memcpy()
+#include <filesystem>                                                 // path
+#include <span>
+#include <string>
+#include <system_error>                                               // system_error, generic_category()
+
+#include <fcntl.h>                                                    // open()
+#include <sys/uio.h>                                                  // writev(), iovec
+#include <unistd.h>                                                   // write(), close()
+
+#include "CatalogWriter.hpp"
+#include "GroceryItem.hpp"
+#include "IngestMetrics.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t maxPriceLength = 32;                          // Longer than any double std::to_chars can produce in either format
+  constexpr char        separator[]    = ", ";
+
+
+  bool needsEscape( char c ) noexcept
+  { return c == '"' || c == '\\'; }
+
+
+  // Bytes formatRecord() may need, at most:  every field character escaped, six quotes, three separators, the price
+  std::size_t recordBound( GroceryItem const & groceryItem ) noexcept
+  {
+    return 2 * ( groceryItem.upcCode().size() + groceryItem.brandName().size() + groceryItem.productName().size() ) + 6 + 6 + maxPriceLength;
+  }
+
+
+  // Writes field the way std::quoted does - in '"' with '"' and '\' escaped by a '\' - and returns the end of what was written.  Text
+  // between characters that need escaping is copied a run at a time.
+  char * formatField( char * out, std::string const & field ) noexcept
+  {
+    char const * text = field.data();
+    char const * end  = text + field.size();
+
+    *out++ = '"';
+    while( true )
+    {
+      char const * special = text;
+      while( special != end && !needsEscape( *special ) )  ++special;
+
+      std::memcpy( out, text, static_cast<std::size_t>( special - text ) );
+      out += special - text;
+      if( special == end )  break;
+
+      *out++ = '\\';
+      *out++ = *special;
+      text   = special + 1;
+    }
+    *out++ = '"';
+    return out;
+  }
+
+
+  char * formatPrice( char * out, double price, PriceFormat priceFormat ) noexcept
+  {
+    // The default ostream formatting of a double is printf's %g with precision 6, which is exactly to_chars' general format
+    auto result = priceFormat == PriceFormat::stream ? std::to_chars( out, out + maxPriceLength, price, std::chars_format::general, 6 )
+                                                     : std::to_chars( out, out + maxPriceLength, price );
+    return result.ptr;
+  }
+
+
+  char * formatSeparator( char * out ) noexcept
+  {
+    std::memcpy( out, separator, sizeof separator - 1 );
+    return out + sizeof separator - 1;
+  }
+
+
+  // One record, without its newline, into at least recordBound( groceryItem ) bytes
+  char * formatRecord( char * out, GroceryItem const & groceryItem, PriceFormat priceFormat ) noexcept
+  {
+    out = formatField    ( out, groceryItem.upcCode()     );
+    out = formatSeparator( out                            );
+    out = formatField    ( out, groceryItem.brandName()   );
+    out = formatSeparator( out                            );
+    out = formatField    ( out, groceryItem.productName() );
+    out = formatSeparator( out                            );
+    return formatPrice   ( out, groceryItem.price(), priceFormat );
+  }
+
+
+  int openForWriting( std::filesystem::path const & path )
+  {
+    int fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if( fd < 0 )  throw std::system_error( errno, std::generic_category(), "CatalogWriter: cannot open " + path.string() );
+    return fd;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Single record formatting
+*******************************************************************************/
+
+void appendRecord( std::string & text, GroceryItem const & groceryItem, PriceFormat priceFormat )
+{
+  auto start = text.size();
+  text.resize( start + recordBound( groceryItem ) );
+  char * end = formatRecord( text.data() + start, groceryItem, priceFormat );
+  text.resize( static_cast<std::size_t>( end - text.data() ) );
+}
+
+
+
+
+/*******************************************************************************
+**  Constructors and destructor
+*******************************************************************************/
+
+CatalogWriter::CatalogWriter( int fileDescriptor, std::size_t bufferSize, PriceFormat priceFormat )
+  : _fileDescriptor( fileDescriptor                                ),
+    _ownsDescriptor( false                                         ),
+    _priceFormat   ( priceFormat                                   ),
+    _buffer        ( std::max<std::size_t>( bufferSize, 4 * 1024 ) )
+{}
+
+
+CatalogWriter::CatalogWriter( std::filesystem::path const & path, std::size_t bufferSize, PriceFormat priceFormat )
+  : CatalogWriter( openForWriting( path ), bufferSize, priceFormat )
+{ _ownsDescriptor = true; }
+
+
+CatalogWriter::~CatalogWriter() noexcept
+{
+  try
+  {
+    flush();
+  }
+  catch( ... )
+  {}                                                                  // Nowhere to report it from here - see the class comment
+
+  if( _ownsDescriptor )  ::close( _fileDescriptor );
+}
+
+
+
+
+/*******************************************************************************
+**  Output
+*******************************************************************************/
+
+void CatalogWriter::write( GroceryItem const & groceryItem )
+{
+  IngestMetrics::count( IngestCounter::recordsWritten );
+
+  // Usual case:  format the whole record straight into the buffer, with no bounds checks along the way
+  if( auto bound = recordBound( groceryItem ) + 1;  bound <= _buffer.size() )
+  {
+    char * start = reserve( bound );
+    char * end;
+    {
+      IngestTimer timer( IngestStage::format );
+      end    = formatRecord( start, groceryItem, _priceFormat );
+      *end++ = '\n';
+    }
+
+    _used         += static_cast<std::size_t>( end - start );
+    _bytesWritten += static_cast<std::size_t>( end - start );
+    return;
+  }
+
+  // A record that might not fit in the buffer at all, a field at a time
+  char price[maxPriceLength];
+  appendField( groceryItem.upcCode()     );    append( separator, sizeof separator - 1 );
+  appendField( groceryItem.brandName()   );    append( separator, sizeof separator - 1 );
+  appendField( groceryItem.productName() );    append( separator, sizeof separator - 1 );
+  append( price, static_cast<std::size_t>( formatPrice( price, groceryItem.price(), _priceFormat ) - price ) );
+  append( "\n", 1 );
+
+  if( !_pieces.empty() )  flush();                                    // In-place fields must go out while groceryItem still exists
+}
+
+
+void CatalogWriter::write( std::span<GroceryItem const> items )
+{
+  for( auto const & item : items )  write( item );
+}
+
+
+void CatalogWriter::flush()
+{
+  // What was buffered is done with even if the write fails:  sending it again (from the destructor, say) would repeat whatever part
+  // did reach the file, and the in-place fields may belong to items that are gone by then
+  auto discard = [&]
+  {
+    _used         = 0;
+    _segmentStart = 0;
+    _pieces.clear();
+  };
+
+  try
+  {
+    if( _pieces.empty() )
+    {
+      iovec whole{ _buffer.data(), _used };
+      if( _used != 0 )  writeAll( &whole, 1 );
+    }
+    else
+    {
+      if( _used != _segmentStart )  _pieces.push_back( { _buffer.data() + _segmentStart, _used - _segmentStart } );
+      writeAll( _pieces.data(), _pieces.size() );
+    }
+  }
+  catch( ... )
+  {
+    discard();
+    throw;
+  }
+  discard();
+}
+
+
+std::size_t CatalogWriter::bytesWritten() const noexcept
+{ return _bytesWritten; }
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+
+char * CatalogWriter::reserve( std::size_t size )
+{
+  if( _buffer.size() - _used < size )  flush();
+  return _buffer.data() + _used;
+}
+
+
+void CatalogWriter::append( char const * text, std::size_t size )
+{
+  _bytesWritten += size;
+  while( size != 0 )
+  {
+    if( _used == _buffer.size() )  flush();
+
+    auto count = std::min( size, _buffer.size() - _used );
+    std::memcpy( _buffer.data() + _used, text, count );
+    _used += count;
+    text  += count;
+    size  -= count;
+  }
+}
+
+
+void CatalogWriter::appendField( std::string const & field )
+{
+  // Small enough to format in one go
+  if( 2 * field.size() + 2 <= _buffer.size() / 2 )
+  {
+    char * start = reserve( 2 * field.size() + 2 );
+    char * end   = formatField( start, field );
+    _used         += static_cast<std::size_t>( end - start );
+    _bytesWritten += static_cast<std::size_t>( end - start );
+    return;
+  }
+
+  // Large, with nothing to escape:  don't copy it, send it from where it is
+  if( std::none_of( field.begin(), field.end(), needsEscape ) )
+  {
+    append( "\"", 1 );
+    sendInPlace( field );
+    append( "\"", 1 );
+    return;
+  }
+
+  // Large and escaped:  a run at a time through the buffer
+  append( "\"", 1 );
+  for( auto text = field.begin(), special = text;  text != field.end();  text = special )
+  {
+    special = std::find_if( text, field.end(), needsEscape );
+    append( &*text, static_cast<std::size_t>( special - text ) );
+    if( special != field.end() )
+    {
+      char escaped[2] = { '\\', *special++ };
+      append( escaped, 2 );
+    }
+  }
+  append( "\"", 1 );
+}
+
+
+void CatalogWriter::sendInPlace( std::string const & field )
+{
+  if( _used != _segmentStart )  _pieces.push_back( { _buffer.data() + _segmentStart, _used - _segmentStart } );
+  _pieces.push_back( { const_cast<char *>( field.data() ), field.size() } );   // iovec isn't const-correct; writev only reads it
+  _segmentStart  = _used;
+  _bytesWritten += field.size();
+}
+
+
+void CatalogWriter::writeAll( iovec * pieces, std::size_t count )
+{
+  // Both write() and writev() may write less than asked (and writev() takes at most IOV_MAX pieces), so keep going until every
+  // piece has been written in full
+  while( count != 0 )
+  {
+    ssize_t written;
+    {
+      IngestTimer timer( IngestStage::write, true );
+      written = count == 1 ? ::write ( _fileDescriptor, pieces->iov_base, pieces->iov_len )
+                           : ::writev( _fileDescriptor, pieces, static_cast<int>( std::min<std::size_t>( count, IOV_MAX ) ) );
+    }
+    if( written < 0 )
+    {
+      if( errno == EINTR )  continue;
+      throw std::system_error( errno, std::generic_category(), "CatalogWriter: write failed" );
+    }
+    IngestMetrics::count( IngestCounter::bytesWritten, static_cast<std::size_t>( written ) );
+
+    auto remaining = static_cast<std::size_t>( written );
+    while( count != 0 && remaining >= pieces->iov_len )
+    {
+      remaining -= pieces->iov_len;
+      ++pieces;
+      --count;
+    }
+    if( count != 0 )
+    {
+      pieces->iov_base  = static_cast<char *>( pieces->iov_base ) + remaining;
+      pieces->iov_len  -= remaining;
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <filesystem>                                                         // path
+#include <span>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>                                                          // iovec
+
+#include "GroceryItem.hpp"
+
+
+
+
+// How prices are written
+enum class PriceFormat
+{
+  shortest,                                                                   // The shortest text that reads back as exactly the same double (std::to_chars)
+  stream                                                                      // What operator<< writes with default stream settings:  6 significant digits, %g style
+};
+
+
+// Formats one record onto the end of text in the form operator<<(std::ostream &, GroceryItem const &) writes - three quoted fields
+// and the price, separated by ", " - without a trailing newline.  Fields are escaped exactly as std::quoted escapes them, but only
+// fields that actually contain a '"' or '\' are scanned character by character.  With PriceFormat::stream the text is byte for byte
+// what operator<< writes; with PriceFormat::shortest the price is exact, so operator>> reads back an identical item.
+void appendRecord( std::string & text, GroceryItem const & groceryItem, PriceFormat priceFormat = PriceFormat::shortest );
+
+
+
+
+// Bulk export of grocery items in operator<< text form, one record per line.  Records are formatted straight into one large
+// buffer that is reused for the life of the writer and handed to the kernel in large write() calls.  A field too large to copy
+// through the buffer is not copied at all:  it is sent in place, along with the buffered text around it, by a single writev().
+//
+// Write errors throw std::system_error, from write() or flush(), after which the writer should be discarded.  A failed write drops
+// whatever was buffered, so nothing is sent twice.  The destructor flushes too, but can only swallow an error, so call flush() before
+// destruction when the outcome matters.
+class CatalogWriter
+{
+  public:
+    static constexpr std::size_t defaultBufferSize = std::size_t{ 1 } << 20;
+
+    // Constructors and destructor
+    explicit CatalogWriter( int fileDescriptor,                     std::size_t bufferSize = defaultBufferSize, PriceFormat priceFormat = PriceFormat::shortest );  // Writes to an already open descriptor, which the caller still owns
+    explicit CatalogWriter( std::filesystem::path const & path,     std::size_t bufferSize = defaultBufferSize, PriceFormat priceFormat = PriceFormat::shortest );  // Creates or truncates path.  Throws std::system_error if it can't be opened
+
+    CatalogWriter & operator=( CatalogWriter const & rhs   ) = delete;
+    CatalogWriter            ( CatalogWriter const & other ) = delete;
+   ~CatalogWriter            (                             ) noexcept;
+
+
+    // Output
+    void        write       ( GroceryItem const & groceryItem );             // One record and its newline
+    void        write       ( std::span<GroceryItem const> items );
+    void        flush       ();                                               // Hands everything buffered to the kernel
+    std::size_t bytesWritten() const noexcept;                                // Including text still buffered
+
+  private:
+    char * reserve    ( std::size_t size );                                   // Room for size more bytes in the buffer, flushing first if need be
+    void   append     ( char const * text, std::size_t size );
+    void   appendField( std::string const & field );
+    void   sendInPlace( std::string const & field );                          // Queues field itself, not a copy, for the next flush
+    void   writeAll   ( iovec * pieces, std::size_t count );
+
+    int                _fileDescriptor;
+    bool               _ownsDescriptor;
+    PriceFormat        _priceFormat;
+    std::vector<char>  _buffer;
+    std::size_t        _used         = 0;                                     // Bytes of _buffer holding unwritten text
+    std::size_t        _segmentStart = 0;                                     // Start of the buffered text not yet covered by an entry in _pieces
+    std::vector<iovec> _pieces;                                               // Gather list for the next flush:  buffer segments and in-place fields, in order
+    std::size_t        _bytesWritten = 0;
+};
@@ -0,0 +1,146 @@
+#include <cmath>                                                      // isfinite(), llround(), signbit()
+#include <compare>                                                    // weak_ordering
+#include <cstdint>                                                    // int64_t
+#include <optional>
+#include <stdexcept>                                                  // invalid_argument
+#include <string>
+#include <utility>                                                    // move()
+
+#include "CompactGroceryItem.hpp"
+#include "GroceryItem.hpp"
+#include "PackedUpc.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+
+CompactGroceryItem::CompactGroceryItem( std::string  productName,
+                                        std::string  brandName,
+                                        PackedUpc    upcCode,
+                                        std::int64_t priceCents )
+  : _upcCode    ( upcCode                  ),
+    _priceCents ( priceCents               ),
+    _brandName  ( std::move( brandName   ) ),
+    _productName( std::move( productName ) )
+{}
+
+
+CompactGroceryItem::CompactGroceryItem( GroceryItem const & groceryItem )
+  : _brandName  ( groceryItem.brandName()   ),
+    _productName( groceryItem.productName() )
+{
+  auto upcCode    = PackedUpc::pack( groceryItem.upcCode() );
+  auto priceCents = toCents( groceryItem.price() );
+  if( !upcCode    )  throw std::invalid_argument( "CompactGroceryItem: UPC code \"" + groceryItem.upcCode() + "\" is not 0 to 18 decimal digits" );
+  if( !priceCents )  throw std::invalid_argument( "CompactGroceryItem: price " + std::to_string( groceryItem.price() ) + " is not a whole number of cents" );
+
+  _upcCode    = *upcCode;
+  _priceCents = *priceCents;
+}
+
+
+CompactGroceryItem::operator GroceryItem() const
+{ return GroceryItem( _productName, _brandName, _upcCode.unpack(), price() ); }
+
+
+bool CompactGroceryItem::representable( GroceryItem const & groceryItem ) noexcept
+{ return PackedUpc::pack( groceryItem.upcCode() ) && toCents( groceryItem.price() ); }
+
+
+std::optional<std::int64_t> CompactGroceryItem::toCents( double price ) noexcept
+{
+  // From $1,000,000 up, GroceryItem's relative price epsilon reaches a cent, so neighbouring cent amounts that GroceryItem calls
+  // equal would compare unequal here.  Far inside the range where every whole number of cents is an exact double.
+  constexpr double limit = 1'000'000.0;
+
+  if( !std::isfinite( price ) || std::abs( price ) >= limit )  return std::nullopt;
+
+  std::int64_t cents = std::llround( price * 100.0 );
+  if( static_cast<double>( cents ) / 100.0 != price )  return std::nullopt;   // Not a whole number of cents (Ex: 1.005, 0.1 + 0.2)
+  if( cents == 0 && std::signbit( price ) )             return std::nullopt;   // -0.0 would come back as +0.0
+  return cents;
+}
+
+
+CompactGroceryItem::CompactGroceryItem( CompactGroceryItem const & other )                            = default;
+CompactGroceryItem::CompactGroceryItem( CompactGroceryItem && other ) noexcept                        = default;
+CompactGroceryItem::~CompactGroceryItem() noexcept                                                    = default;
+CompactGroceryItem & CompactGroceryItem::operator=( CompactGroceryItem const & rhs ) &                = default;
+CompactGroceryItem & CompactGroceryItem::operator=( CompactGroceryItem && rhs ) & noexcept            = default;
+
+
+
+
+/*******************************************************************************
+**  Accessors
+*******************************************************************************/
+
+PackedUpc           CompactGroceryItem::upcCode    () const & { return _upcCode;                                    }
+std::string const & CompactGroceryItem::brandName  () const & { return _brandName;                                  }
+std::string const & CompactGroceryItem::productName() const & { return _productName;                                }
+double              CompactGroceryItem::price      () const & { return static_cast<double>( _priceCents ) / 100.0;  }
+std::int64_t        CompactGroceryItem::priceCents () const & { return _priceCents;                                 }
+
+std::string         CompactGroceryItem::brandName  ()       && { return std::move( _brandName   ); }
+std::string         CompactGroceryItem::productName()       && { return std::move( _productName ); }
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+
+CompactGroceryItem & CompactGroceryItem::upcCode( PackedUpc newUpcCode ) &
+{
+  _upcCode = newUpcCode;
+  return *this;
+}
+
+
+CompactGroceryItem & CompactGroceryItem::brandName( std::string newBrandName ) &
+{
+  _brandName = std::move( newBrandName );
+  return *this;
+}
+
+
+CompactGroceryItem & CompactGroceryItem::productName( std::string newProductName ) &
+{
+  _productName = std::move( newProductName );
+  return *this;
+}
+
+
+CompactGroceryItem & CompactGroceryItem::priceCents( std::int64_t newPriceCents ) &
+{
+  _priceCents = newPriceCents;
+  return *this;
+}
+
+
+
+
+/*******************************************************************************
+**  Relational Operators
+*******************************************************************************/
+
+std::weak_ordering CompactGroceryItem::operator<=>( CompactGroceryItem const & rhs ) const noexcept
+{
+  if( auto cmp = _upcCode     <=> rhs._upcCode;      cmp != 0 )  return cmp;
+  if( auto cmp = _productName <=> rhs._productName;  cmp != 0 )  return cmp;
+  if( auto cmp = _brandName   <=> rhs._brandName;    cmp != 0 )  return cmp;
+  return _priceCents <=> rhs._priceCents;
+}
+
+
+bool CompactGroceryItem::operator==( CompactGroceryItem const & rhs ) const noexcept
+{
+  // Cheapest and most likely to differ first, as in GroceryItem
+  return  _priceCents  == rhs._priceCents
+       && _upcCode     == rhs._upcCode
+       && _brandName   == rhs._brandName
+       && _productName == rhs._productName;
+}
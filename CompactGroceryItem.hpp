@@ -0,0 +1,69 @@
+#pragma once                                                                  // include guard
+
+#include <compare>                                                            // std::weak_ordering
+#include <cstdint>                                                            // int64_t
+#include <optional>
+#include <string>
+
+#include "GroceryItem.hpp"
+#include "PackedUpc.hpp"
+
+
+
+
+// A GroceryItem with its UPC code packed into 64 bits (see PackedUpc) and its price held as a whole number of cents.  UPC codes
+// compare as integers and prices compare exactly, so sorting and searching need far fewer branches and no string or floating point
+// comparisons until the UPC codes tie.
+//
+// Only items whose UPC code is up to 18 decimal digits and whose price is a whole number of cents below $1,000,000 (in magnitude)
+// have a compact form.  For those, conversion is lossless in both directions and the ordering agrees with GroceryItem's, because
+// below $1,000,000 two different cent amounts are always further apart than GroceryItem's price epsilon.
+class CompactGroceryItem
+{
+  public:
+    // Constructors, assignments, and destructor
+    CompactGroceryItem( std::string  productName = {},
+                        std::string  brandName   = {},
+                        PackedUpc    upcCode     = {},
+                        std::int64_t priceCents  = 0 );
+    explicit CompactGroceryItem( GroceryItem const & groceryItem );          // Throws std::invalid_argument unless representable( groceryItem )
+    explicit operator GroceryItem() const;
+
+    static bool                        representable( GroceryItem const & groceryItem ) noexcept;
+    static std::optional<std::int64_t> toCents      ( double price )                    noexcept;   // Empty unless price is exactly a whole number of cents, below $1,000,000
+
+    CompactGroceryItem & operator=( CompactGroceryItem const  & rhs   ) &;
+    CompactGroceryItem & operator=( CompactGroceryItem       && rhs   ) & noexcept;
+    CompactGroceryItem            ( CompactGroceryItem const  & other );
+    CompactGroceryItem            ( CompactGroceryItem       && other )   noexcept;
+   ~CompactGroceryItem            (                                   )   noexcept;
+
+
+    // Accessors
+    PackedUpc           upcCode    () const &;                                // The packed code.  Use upcCode().unpack() for its text
+    std::string const & brandName  () const &;
+    std::string const & productName() const &;
+    double              price      () const &;                                // priceCents() / 100.0, which is exactly the double the price was converted from
+    std::int64_t        priceCents () const &;
+
+    std::string         brandName  ()       &&;
+    std::string         productName()       &&;
+
+
+    // Modifiers
+    CompactGroceryItem & upcCode    ( PackedUpc    newUpcCode     ) &;
+    CompactGroceryItem & brandName  ( std::string  newBrandName   ) &;
+    CompactGroceryItem & productName( std::string  newProductName ) &;
+    CompactGroceryItem & priceCents ( std::int64_t newPriceCents  ) &;
+
+
+    // Relational Operators - same order as GroceryItem:  UPC code, product name, brand name, then price
+    std::weak_ordering operator<=>( CompactGroceryItem const & rhs ) const noexcept;
+    bool               operator== ( CompactGroceryItem const & rhs ) const noexcept;
+
+  private:
+    PackedUpc    _upcCode;
+    std::int64_t _priceCents = 0;
+    std::string  _brandName;
+    std::string  _productName;
+};
@@ -0,0 +1,582 @@
+#include <algorithm>                                                  // sort(), lower_bound(), fill_n(), min(), max()
+#include <bit>                                                        // bit_width(), bit_cast(), popcount()
+#include <cmath>                                                      // isfinite(), llround(), abs()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t, int64_t, uint32_t
+#include <cstring>                                                    // memcpy()
+#include <limits>                                                     // numeric_limits
+#include <optional>
+#include <span>
+#include <stdexcept>                                                  // length_error
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  #include <immintrin.h>                                              // _pext_u64()
+  #define COMPRESSED_CATALOG_HAVE_BMI2 1
+#endif
+
+#include "CatalogSort.hpp"                                            // sortedOrder()
+#include "CompressedCatalog.hpp"
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
+#include "GroceryItem.hpp"
+#include "StringMemory.hpp"                                           // heapBytes()
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // The first of values 0 to count - 1 for which isTrue is, given that it's false below some value and true from there on
+  template< typename Predicate >
+  std::uint64_t firstWhere( std::uint64_t count, Predicate isTrue )
+  {
+    std::uint64_t low = 0,  high = count;
+    while( low < high )
+    {
+      std::uint64_t middle = low + ( high - low ) / 2;
+      if( isTrue( middle ) )  high = middle;
+      else                    low  = middle + 1;
+    }
+    return low;
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Front-coded UPC codes
+  *****************************************************************************/
+  std::size_t sharedPrefix( std::string_view lhs, std::string_view rhs ) noexcept
+  {
+    std::size_t length = std::min( lhs.size(), rhs.size() ),  shared = 0;
+    while( shared < length && lhs[shared] == rhs[shared] )  ++shared;
+    return shared;
+  }
+
+
+  // A block of front-coded codes:  a byte saying how wide the block's numbers are, then for each code the length of the prefix it shares
+  // with the code before it (0 for the first), then for each code where its characters after that end, then all those characters.
+  // Numbers are single bytes when the characters fit in 255 bytes, as they always do for UPC codes, otherwise 4 bytes each.  A
+  // code's pieces are found straight from the tables, without walking the block.
+  constexpr std::size_t upcBlockSize = 16;
+
+  void appendUpcBlock( std::string & text, std::span<std::size_t const> shared, std::span<std::size_t const> ends, std::string_view characters )
+  {
+    bool wide = characters.size() > 255;                              // Shared prefixes are never longer than the characters before them
+    text.push_back( static_cast<char>( wide ) );
+    for( auto numbers : { shared, ends } )
+    {
+      for( auto number : numbers )
+      {
+        if( !wide )  text.push_back( static_cast<char>( number ) );
+        else
+        {
+          auto value = static_cast<std::uint32_t>( number );
+          text.append( reinterpret_cast<char const *>( &value ), sizeof value );
+        }
+      }
+    }
+    text.append( characters );
+  }
+
+
+  class UpcBlock
+  {
+    public:
+      UpcBlock( char const * block, std::size_t count ) noexcept
+        : _count( count ), _width( block[0] != 0 ? 4 : 1 ),
+          _shared( reinterpret_cast<unsigned char const *>( block ) + 1 ), _ends( _shared + count * _width ),
+          _text( reinterpret_cast<char const *>( _ends + count * _width ) )
+      {}
+
+      std::size_t      size() const noexcept { return _count; }
+      std::string_view head() const noexcept { return std::string_view( _text, end( 0 ) ); }
+
+      // Turns code, the code before index, into the one at index
+      void next( std::size_t index, std::string & code ) const
+      {
+        code.resize( shared( index ) );
+        code.append( _text + begin( index ), end( index ) - begin( index ) );
+      }
+
+      // The code at index, assembled from it back to the first code, each earlier code supplying just the characters before those
+      // already copied
+      std::string code( std::size_t index ) const
+      {
+        std::size_t length = shared( index ) + end( index ) - begin( index );
+        std::string code( length, '\0' );
+        for( std::size_t i = index + 1, copied = length; copied > 0; )     // Characters [copied, length) are done
+        {
+          std::size_t start = shared( --i );
+          if( start >= copied )  continue;
+          std::memcpy( code.data() + start, _text + begin( i ), copied - start );
+          copied = start;
+        }
+        return code;
+      }
+
+    private:
+      std::size_t number( unsigned char const * numbers, std::size_t index ) const noexcept
+      {
+        if( _width == 1 )  return numbers[index];
+        std::uint32_t value;
+        std::memcpy( &value, numbers + index * 4, sizeof value );
+        return value;
+      }
+
+      std::size_t shared( std::size_t index ) const noexcept { return number( _shared, index ); }
+      std::size_t end   ( std::size_t index ) const noexcept { return number( _ends,   index ); }
+      std::size_t begin ( std::size_t index ) const noexcept { return index == 0 ? 0 : end( index - 1 ); }
+
+      std::size_t           _count;
+      std::size_t           _width;
+      unsigned char const * _shared;
+      unsigned char const * _ends;
+      char const *          _text;
+  };
+
+
+
+
+  /*****************************************************************************
+  **  Packed field scans
+  *****************************************************************************/
+  // Bits a field needs to hold 0 to largest
+  unsigned widthFor( std::uint64_t largest ) noexcept
+  { return std::max( static_cast<unsigned>( std::bit_width( largest ) ), 1u ); }
+
+
+  // Where the fields of a packed word are:  field j holds bits [j * stride, j * stride + width), and its spare bit is the one above
+  struct FieldLayout
+  {
+    unsigned      width;
+    unsigned      stride;
+    unsigned      perWord;
+    std::uint64_t spares;                                             // Every field's spare bit
+    std::uint64_t ones;                                               // 1 in every field
+
+    FieldLayout( unsigned width, unsigned perWord ) noexcept
+      : width( width ), stride( width + 1 ), perWord( perWord ), spares( 0 ), ones( 0 )
+    {
+      for( unsigned j = 0; j < perWord; ++j )
+      {
+        ones   |= std::uint64_t{ 1 } << j * stride;
+        spares |= std::uint64_t{ 1 } << ( j * stride + width );
+      }
+    }
+
+    std::uint64_t broadcast( std::uint64_t value ) const noexcept { return value * ones; }   // value in every field
+  };
+
+
+  // With every field below its spare bit, adding the spare bit before subtracting keeps each field's borrow to itself, and the spare
+  // bit survives exactly when the difference isn't negative.  So, one subtraction compares every field of a word.
+  struct FieldsEqual
+  {
+    std::uint64_t target;                                             // The value, broadcast
+    std::uint64_t spares;
+    std::uint64_t ones;
+
+    std::uint64_t operator()( std::uint64_t word ) const noexcept
+    { return ~( ( ( word ^ target ) | spares ) - ones ) & spares; }  // field ^ value is 0, so 0 - 1 borrows the spare bit
+  };
+
+
+  struct FieldsInRange
+  {
+    std::uint64_t low;                                                // The bounds, broadcast
+    std::uint64_t high;
+    std::uint64_t spares;
+
+    std::uint64_t operator()( std::uint64_t word ) const noexcept
+    { return ( ( word | spares ) - low ) & ( ( high | spares ) - word ) & spares; }
+  };
+
+
+  // The spare bits of a word, one per field, packed down into its low perWord bits
+  struct PortableGather
+  {
+    static std::uint64_t gather( std::uint64_t bits, FieldLayout const & layout ) noexcept
+    {
+      std::uint64_t packed = 0;
+      for( unsigned j = 0; j < layout.perWord; ++j )  packed |= ( bits >> ( j * layout.stride + layout.width ) & 1 ) << j;
+      return packed;
+    }
+  };
+
+  #ifdef COMPRESSED_CATALOG_HAVE_BMI2
+    struct PextGather
+    {
+      __attribute__(( target( "bmi2" ) ))
+      static std::uint64_t gather( std::uint64_t bits, FieldLayout const & layout ) noexcept
+      { return _pext_u64( bits, layout.spares ); }
+    };
+  #endif
+
+
+  // Writes one mask bit per field from each word's matching spare bits, and counts them
+  template< typename Gather, typename WordMatch >
+  std::size_t scanFields( std::span<std::uint64_t const> words, FieldLayout const & layout, std::size_t fieldCount,
+                          std::span<std::uint64_t> mask, WordMatch matchWord ) noexcept
+  {
+    std::uint64_t pending = 0;                                        // Mask bits not yet stored, from bit 0 up
+    unsigned      filled  = 0;
+    std::size_t   stored  = 0,  count = 0;
+
+    for( std::size_t i = 0; i < words.size(); ++i )
+    {
+      std::uint64_t bits = Gather::gather( matchWord( words[i] ), layout );
+      if( i + 1 == words.size() )                                     // The last word's fields past the end are padding
+      {
+        std::size_t live = fieldCount - i * layout.perWord;
+        if( live < 64 )  bits &= ( std::uint64_t{ 1 } << live ) - 1;
+      }
+
+      pending |= bits << filled;
+      filled  += layout.perWord;
+      if( filled >= 64 )                                              // perWord <= 32, so filled was > 0
+      {
+        count         += static_cast<std::size_t>( std::popcount( pending ) );
+        mask[stored++] = pending;
+        filled        -= 64;
+        pending        = filled > 0 ? bits >> ( layout.perWord - filled ) : 0;
+      }
+    }
+
+    if( stored < ( fieldCount + 63 ) / 64 )
+    {
+      count         += static_cast<std::size_t>( std::popcount( pending ) );
+      mask[stored++] = pending;
+    }
+    return count;
+  }
+
+
+  // Flattened so the gather and the match inline into the loop, which for PextGather they may only do inside a BMI2 function
+  template< typename WordMatch >
+  __attribute__(( flatten ))
+  std::size_t scanPortable( std::span<std::uint64_t const> words, FieldLayout const & layout, std::size_t fieldCount, std::span<std::uint64_t> mask, WordMatch matchWord ) noexcept
+  { return scanFields<PortableGather>( words, layout, fieldCount, mask, matchWord ); }
+
+  #ifdef COMPRESSED_CATALOG_HAVE_BMI2
+    template< typename WordMatch >
+    __attribute__(( target( "bmi2" ), flatten ))
+    std::size_t scanBmi2( std::span<std::uint64_t const> words, FieldLayout const & layout, std::size_t fieldCount, std::span<std::uint64_t> mask, WordMatch matchWord ) noexcept
+    { return scanFields<PextGather>( words, layout, fieldCount, mask, matchWord ); }
+  #endif
+
+
+  template< typename WordMatch >
+  std::size_t scan( std::span<std::uint64_t const> words, FieldLayout const & layout, std::size_t fieldCount, std::span<std::uint64_t> mask, WordMatch matchWord ) noexcept
+  {
+    #ifdef COMPRESSED_CATALOG_HAVE_BMI2
+      static bool const haveBmi2 = __builtin_cpu_supports( "bmi2" );
+      if( haveBmi2 )  return scanBmi2( words, layout, fieldCount, mask, matchWord );
+    #endif
+    return scanPortable( words, layout, fieldCount, mask, matchWord );
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Prices
+  *****************************************************************************/
+  constexpr double largestCents = 9'007'199'254'740'992.0 / 100;     // Beyond 2^53 cents, cents are no longer exact in a double
+
+
+  // price as a whole number of cents, if it is one:  if cents / 100.0 gives back exactly price's bits
+  std::optional<std::int64_t> wholeCents( double price ) noexcept
+  {
+    if( !std::isfinite( price ) || std::abs( price ) >= largestCents )  return std::nullopt;
+
+    std::int64_t cents = std::llround( price * 100.0 );
+    if( std::bit_cast<std::uint64_t>( static_cast<double>( cents ) / 100.0 ) != std::bit_cast<std::uint64_t>( price ) )  return std::nullopt;
+    return cents;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Packed fields
+*******************************************************************************/
+
+CompressedCatalog::PackedFields::PackedFields( std::span<std::uint64_t const> values, unsigned width )
+  : _width( width ), _perWord( 64 / ( width + 1 ) ), _reciprocal( _perWord > 1 ? std::numeric_limits<std::uint64_t>::max() / _perWord + 1 : 0 )
+{
+  _words.assign( ( values.size() + _perWord - 1 ) / _perWord, 0 );
+  for( std::size_t i = 0; i < values.size(); ++i )  _words[i / _perWord] |= values[i] << ( i % _perWord * ( _width + 1 ) );
+}
+
+
+std::uint64_t CompressedCatalog::PackedFields::operator[]( size_type index ) const noexcept
+{
+  // For index < 2^32, the high half of index * ceil(2^64 / perWord) is exactly index / perWord (Lemire, Kaser, and Kurz, "Faster
+  // Remainder by Direct Computation")
+  __extension__ using Product = unsigned __int128;
+  std::uint64_t word  = _perWord > 1 ? static_cast<std::uint64_t>( static_cast<Product>( index ) * _reciprocal >> 64 ) : index;
+  auto          shift = static_cast<unsigned>( index - word * _perWord ) * ( _width + 1 );
+  return _words[word] >> shift & ( ( std::uint64_t{ 1 } << _width ) - 1 );
+}
+
+
+unsigned                       CompressedCatalog::PackedFields::width  () const noexcept { return _width;   }
+unsigned                       CompressedCatalog::PackedFields::perWord() const noexcept { return _perWord; }
+std::span<std::uint64_t const> CompressedCatalog::PackedFields::words  () const noexcept { return _words;   }
+
+
+
+
+/*******************************************************************************
+**  Constructors
+*******************************************************************************/
+
+CompressedCatalog::CompressedCatalog( std::span<GroceryItem const> items, unsigned threadCount )
+  : _size( items.size() )
+{
+  if( items.size() > std::numeric_limits<std::uint32_t>::max() )  throw std::length_error( "CompressedCatalog:  too many items" );
+
+  auto order = sortedOrder( items, threadCount );
+  std::vector<std::uint64_t> fields( _size );
+
+  // UPC codes, front coded
+  std::string_view         previous;
+  std::vector<std::size_t> shared,  ends;
+  std::string              characters;
+  for( std::size_t row = 0; row < _size; ++row )
+  {
+    std::string_view code = items[order[row]].upcCode();
+    shared.push_back( row % upcBlockSize == 0 ? 0 : sharedPrefix( previous, code ) );
+    characters.append( code.substr( shared.back() ) );
+    ends.push_back( characters.size() );
+    previous = code;
+
+    if( row % upcBlockSize == upcBlockSize - 1 || row + 1 == _size )
+    {
+      _upcBlocks.push_back( _upcText.size() );
+      appendUpcBlock( _upcText, shared, ends, characters );
+      shared.clear();
+      ends.clear();
+      characters.clear();
+    }
+  }
+
+  // Brand names, as indices into a dictionary
+  std::unordered_map<std::string_view, std::uint64_t> brandIndex;
+  for( auto const & item : items )  brandIndex.emplace( item.brandName(), 0 );
+  _brands.reserve( brandIndex.size() );
+  for( auto const & [brand, index] : brandIndex )  _brands.emplace_back( brand );
+  std::sort( _brands.begin(), _brands.end() );
+  for( std::size_t i = 0; i < _brands.size(); ++i )  brandIndex[_brands[i]] = i;
+  for( std::size_t row = 0; row < _size; ++row )  fields[row] = brandIndex.find( items[order[row]].brandName() )->second;
+  _brandIndices = PackedFields( fields, widthFor( _brands.empty() ? 0 : _brands.size() - 1 ) );
+
+  // Product names, in one blob
+  for( std::size_t row = 0; row < _size; ++row )
+  {
+    _productText.append( items[order[row]].productName() );
+    fields[row] = _productText.size();
+  }
+  _productEnds = PackedFields( fields, widthFor( _productText.size() ) );
+
+  // Prices, as cents above the smallest, except for those that aren't whole cents
+  std::int64_t lowest = std::numeric_limits<std::int64_t>::max(),  highest = std::numeric_limits<std::int64_t>::min();
+  for( std::size_t row = 0; row < _size; ++row )
+  {
+    double price = items[order[row]].price();
+    if( auto cents = wholeCents( price ) )
+    {
+      lowest  = std::min( lowest,  *cents );
+      highest = std::max( highest, *cents );
+    }
+    else  _priceExceptions.push_back( { static_cast<std::uint32_t>( row ), price } );
+  }
+
+  // With exceptions, the largest field value is kept to mark them, so reading a whole-cent price needn't search them
+  std::uint64_t range = lowest <= highest ? static_cast<std::uint64_t>( highest - lowest ) : 0;
+  unsigned      width = widthFor( _priceExceptions.empty() ? range : range + 1 );
+  _baseCents          = lowest <= highest ? lowest : 0;
+  for( std::size_t row = 0; row < _size; ++row )
+  {
+    auto cents  = wholeCents( items[order[row]].price() );
+    fields[row] = cents ? static_cast<std::uint64_t>( *cents - _baseCents ) : ( std::uint64_t{ 1 } << width ) - 1;
+  }
+  _priceCents = PackedFields( fields, width );
+
+  _upcText        .shrink_to_fit();
+  _upcBlocks      .shrink_to_fit();
+  _productText    .shrink_to_fit();
+  _priceExceptions.shrink_to_fit();
+}
+
+
+
+
+/*******************************************************************************
+**  Size and row access
+*******************************************************************************/
+
+CompressedCatalog::size_type CompressedCatalog::size() const noexcept
+{ return _size; }
+
+
+bool CompressedCatalog::empty() const noexcept
+{ return _size == 0; }
+
+
+std::string CompressedCatalog::upcCode( size_type row ) const
+{
+  std::size_t block = row / upcBlockSize;
+  return UpcBlock( _upcText.data() + _upcBlocks[block], std::min( upcBlockSize, _size - block * upcBlockSize ) ).code( row % upcBlockSize );
+}
+
+
+std::string const & CompressedCatalog::brandName( size_type row ) const noexcept
+{ return _brands[_brandIndices[row]]; }
+
+
+std::string_view CompressedCatalog::productName( size_type row ) const noexcept
+{
+  std::size_t begin = row == 0 ? 0 : _productEnds[row - 1];
+  return std::string_view( _productText ).substr( begin, _productEnds[row] - begin );
+}
+
+
+double CompressedCatalog::price( size_type row ) const noexcept
+{
+  std::uint64_t cents = _priceCents[row];
+  if( cents == ( std::uint64_t{ 1 } << _priceCents.width() ) - 1 && !_priceExceptions.empty() )
+  {
+    auto exception = std::lower_bound( _priceExceptions.begin(), _priceExceptions.end(), row,
+                                       []( PriceException const & entry, size_type row ) { return entry.row < row; } );
+    if( exception != _priceExceptions.end() && exception->row == row )  return exception->price;
+  }
+  return static_cast<double>( _baseCents + static_cast<std::int64_t>( cents ) ) / 100.0;
+}
+
+
+GroceryItem CompressedCatalog::item( size_type row ) const
+{ return GroceryItem( std::string( productName( row ) ), brandName( row ), upcCode( row ), price( row ) ); }
+
+
+std::vector<GroceryItem> CompressedCatalog::toItems() const
+{
+  std::vector<GroceryItem> items;
+  items.reserve( _size );
+
+  // Decoding the UPC codes in order, each from the one before, rather than each from the start of its block
+  std::string code;
+  for( std::size_t block = 0; block < _upcBlocks.size(); ++block )
+  {
+    UpcBlock codes( _upcText.data() + _upcBlocks[block], std::min( upcBlockSize, _size - block * upcBlockSize ) );
+    for( std::size_t i = 0; i < codes.size(); ++i )
+    {
+      std::size_t row = block * upcBlockSize + i;
+      codes.next( i, code );
+      items.emplace_back( std::string( productName( row ) ), brandName( row ), code, price( row ) );
+    }
+  }
+  return items;
+}
+
+
+std::optional<CompressedCatalog::size_type> CompressedCatalog::findUpc( std::string_view upcCode ) const
+{
+  auto blockAt = [&]( std::size_t block ) { return UpcBlock( _upcText.data() + _upcBlocks[block], std::min( upcBlockSize, _size - block * upcBlockSize ) ); };
+
+  // The first block starting at or after upcCode.  Its predecessor, if any, may hold the code's first row; if not, it starts there.
+  std::size_t block = firstWhere( _upcBlocks.size(), [&]( std::size_t block ) { return blockAt( block ).head() >= upcCode; } );
+  if( block > 0 )
+  {
+    auto        codes = blockAt( block - 1 );
+    std::string code;
+    for( std::size_t i = 0; i < codes.size(); ++i )
+    {
+      codes.next( i, code );
+      if( code == upcCode )  return ( block - 1 ) * upcBlockSize + i;
+      if( code >  upcCode )  return std::nullopt;
+    }
+  }
+  if( block < _upcBlocks.size() && blockAt( block ).head() == upcCode )  return block * upcBlockSize;
+  return std::nullopt;
+}
+
+
+std::span<std::string const> CompressedCatalog::brands() const noexcept
+{ return _brands; }
+
+
+
+
+/*******************************************************************************
+**  Filters
+*******************************************************************************/
+
+CompressedCatalog::size_type CompressedCatalog::matchBrand( std::string_view brandName, std::span<std::uint64_t> mask ) const noexcept
+{
+  auto brand = std::lower_bound( _brands.begin(), _brands.end(), brandName );
+  if( brand == _brands.end() || *brand != brandName )
+  {
+    std::fill_n( mask.begin(), ( _size + 63 ) / 64, std::uint64_t{ 0 } );
+    return 0;
+  }
+
+  FieldLayout layout( _brandIndices.width(), _brandIndices.perWord() );
+  auto        index = static_cast<std::uint64_t>( brand - _brands.begin() );
+  return scan( _brandIndices.words(), layout, _size, mask, FieldsEqual{ layout.broadcast( index ), layout.spares, layout.ones } );
+}
+
+
+CompressedCatalog::size_type CompressedCatalog::matchPriceBand( double low, double high, std::span<std::uint64_t> mask, long double epsilon1, long double epsilon2 ) const noexcept
+{
+  auto notBelowLow  = [&]( double price ) { return price > low  || floating_point_is_equal( price, low,  epsilon1, epsilon2 ); };
+  auto notAboveHigh = [&]( double price ) { return price < high || floating_point_is_equal( price, high, epsilon1, epsilon2 ); };
+  auto priceOf      = [&]( std::uint64_t field ) { return static_cast<double>( _baseCents + static_cast<std::int64_t>( field ) ) / 100.0; };
+
+  // Both tests are monotonic in the price, so the band is a range of packed fields, found by binary search.  Not including the
+  // field marking exceptions.
+  std::uint64_t fieldCount = ( std::uint64_t{ 1 } << _priceCents.width() ) - ( _priceExceptions.empty() ? 0 : 1 );
+  std::uint64_t first      = firstWhere( fieldCount, [&]( std::uint64_t field ) { return  notBelowLow ( priceOf( field ) ); } );
+  std::uint64_t end        = firstWhere( fieldCount, [&]( std::uint64_t field ) { return !notAboveHigh( priceOf( field ) ); } );
+
+  std::size_t count = 0;
+  if( first < end )
+  {
+    FieldLayout layout( _priceCents.width(), _priceCents.perWord() );
+    count = scan( _priceCents.words(), layout, _size, mask, FieldsInRange{ layout.broadcast( first ), layout.broadcast( end - 1 ), layout.spares } );
+  }
+  else  std::fill_n( mask.begin(), ( _size + 63 ) / 64, std::uint64_t{ 0 } );
+
+  for( auto const & [row, price] : _priceExceptions )
+  {
+    if( !notBelowLow( price ) || !notAboveHigh( price ) )  continue;
+    mask[row / 64] |= std::uint64_t{ 1 } << row % 64;
+    ++count;
+  }
+  return count;
+}
+
+
+
+
+/*******************************************************************************
+**  Memory
+*******************************************************************************/
+
+CompressedCatalog::ColumnBytes CompressedCatalog::bytes() const noexcept
+{
+  ColumnBytes columns;
+  columns.upcCodes     = heapBytes( _upcText ) + _upcBlocks.capacity() * sizeof( std::uint64_t );
+  columns.brandNames   = _brands.capacity() * sizeof( std::string ) + _brandIndices.words().size() * sizeof( std::uint64_t );
+  for( auto const & brand : _brands )  columns.brandNames += heapBytes( brand );
+  columns.productNames = heapBytes( _productText ) + _productEnds.words().size() * sizeof( std::uint64_t );
+  columns.prices       = _priceCents.words().size() * sizeof( std::uint64_t ) + _priceExceptions.capacity() * sizeof( PriceException );
+  return columns;
+}
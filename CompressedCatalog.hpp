@@ -0,0 +1,120 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint32_t, uint64_t, int64_t
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// A read-only catalog compressed column by column, for catalogs too large to keep as GroceryItems or even as GroceryCatalog's
+// uncompressed columns, where most of the memory goes to repeated brand names and to 8-byte prices that hold whole cents.
+//
+// Rows are in operator<=> order (see sortedOrder()), so UPC codes are sorted:
+//   o)  UPC codes       front coded:  blocks of 16 codes, the first in full and each other as the length of the prefix it shares with
+//                       the code before it plus the rest of its characters, with a block's lengths kept together ahead of its characters
+//   o)  brand names     dictionary encoded:  the distinct names, ascending, and one bit-packed index into them per row
+//   o)  product names   one text blob and bit-packed offsets into it
+//   o)  prices          integer cents less the smallest, bit-packed.  Prices that aren't whole cents are kept exactly in a short list
+//                       of exceptions, so every price reads back bit for bit
+//
+// Bit-packed columns hold as many fixed-width fields as fit in each 64-bit word, each with a spare (zero) bit above it.  The spare
+// bits let matchBrand() and matchPriceBand() test every field of a word at once with a few integer operations, without unpacking a
+// field, looking a brand up, or converting a price:  the brand is looked up once, the price band converted once to a range of cents.
+//
+// Random access is a multiply, a shift, and a mask for packed columns, a dictionary index for brand names, and for a UPC code, a walk
+// over its block's lengths and a copy of the pieces of the codes before it that it shares.
+class CompressedCatalog
+{
+  public:
+    using size_type = std::size_t;
+
+    struct ColumnBytes                                                        // Heap bytes held by each column
+    {
+      std::size_t upcCodes     = 0;
+      std::size_t brandNames   = 0;
+      std::size_t productNames = 0;
+      std::size_t prices       = 0;
+
+      std::size_t total() const noexcept { return upcCodes + brandNames + productNames + prices; }
+    };
+
+
+    // Constructors.  Throws std::length_error for 2^32 or more items.
+    CompressedCatalog() = default;
+    explicit CompressedCatalog( std::span<GroceryItem const> items, unsigned threadCount = 0 );   // threadCount is for the sort (see sortedOrder())
+
+
+    // Size and row access
+    size_type                 size       (                 ) const noexcept;
+    bool                      empty      (                 ) const noexcept;
+    std::string               upcCode    ( size_type row   ) const;
+    std::string const &       brandName  ( size_type row   ) const noexcept;
+    std::string_view          productName( size_type row   ) const noexcept;
+    double                    price      ( size_type row   ) const noexcept;
+    GroceryItem               item       ( size_type row   ) const;
+    std::vector<GroceryItem>  toItems    (                 ) const;
+
+    std::optional<size_type>  findUpc    ( std::string_view upcCode ) const;  // The first row with upcCode, if any
+    std::span<std::string const> brands  (                 ) const noexcept;  // The brand dictionary, ascending
+
+
+    // Filters, evaluated on the packed columns.  Bit i % 64 of mask[i / 64] is set when row i matches; mask must hold at least
+    // (size() + 63) / 64 words, and bits past the last row are cleared.  Both return the number of matching rows.
+    //
+    // matchPriceBand() matches what matchPriceBand() in PriceKernels.hpp matches:  prices not below low and not above high in
+    // GroceryItem's price ordering, for the same tolerances.
+    size_type matchBrand    ( std::string_view brandName,   std::span<std::uint64_t> mask ) const noexcept;
+    size_type matchPriceBand( double low, double high,      std::span<std::uint64_t> mask, long double epsilon1 = 1e-4L, long double epsilon2 = 1e-8L ) const noexcept;
+
+
+    // Memory
+    ColumnBytes bytes() const noexcept;
+
+  private:
+    // Unsigned fields of up to 63 bits, each followed by a spare bit, as many to a 64-bit word as fit
+    class PackedFields
+    {
+      public:
+        PackedFields() = default;
+        PackedFields( std::span<std::uint64_t const> values, unsigned width );
+
+        std::uint64_t                  operator[]( size_type index ) const noexcept;
+        unsigned                       width     (                 ) const noexcept;  // Bits per field, not counting the spare
+        unsigned                       perWord   (                 ) const noexcept;  // Fields per word
+        std::span<std::uint64_t const> words     (                 ) const noexcept;
+
+      private:
+        std::vector<std::uint64_t> _words;
+        unsigned                   _width      = 1;
+        unsigned                   _perWord    = 32;
+        std::uint64_t              _reciprocal = std::uint64_t{ 1 } << 59;    // ceil(2^64 / _perWord), so index / _perWord is a multiply.  0 when _perWord is 1
+    };
+
+    struct PriceException
+    {
+      std::uint32_t row;
+      double        price;
+    };
+
+    size_type                   _size = 0;
+
+    std::string                 _upcText;                                     // The front-coded blocks
+    std::vector<std::uint64_t>  _upcBlocks;                                   // Offset of each block in _upcText
+
+    std::vector<std::string>    _brands;
+    PackedFields                _brandIndices;
+
+    std::string                 _productText;
+    PackedFields                _productEnds;                                 // Row i's name is [end of row i - 1, end of row i)
+
+    std::int64_t                _baseCents = 0;
+    PackedFields                _priceCents;                                  // Cents above _baseCents.  All ones for exceptions, if there are any
+    std::vector<PriceException> _priceExceptions;                             // Ascending by row
+};
@@ -0,0 +1,272 @@
+#include <algorithm>                                                  // min(), ranges::find_if()
+#include <atomic>
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t
+#include <memory>                                                     // unique_ptr, make_unique()
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>                                                  // length_error
+#include <string_view>
+#include <utility>                                                    // move(), exchange()
+#include <vector>
+
+#include "ConcurrentCatalog.hpp"
+#include "GroceryItem.hpp"
+
+
+
+// How reclamation stays safe.  All accesses to _epoch, _current, and the Readers' epochs are sequentially consistent.
+//
+//   Reader:  e = _epoch;  slot.epoch = e;  v = _current;  ... use v ...;  slot.epoch = idle
+//   Writer:  _current = next;  tag = _epoch++;  retire( old, tag );  free every retired version whose tag < min( slot.epoch )
+//
+// A Reader that loaded the old version loaded _current before the writer stored next, so it loaded _epoch before the increment
+// and announced an epoch no greater than tag:  the old version stays until that Reader goes idle.  A Reader whose announcement the
+// writer misses (still idle when scanned) announces afterwards, so its load of _current comes after the store of next and can't
+// return the old version.  Later versions are retired with later, larger tags, so one announcement protects every version the Reader
+// loads until it goes idle, nested snapshots included.
+
+
+
+/*******************************************************************************
+**  Constructors and destructor
+*******************************************************************************/
+
+ConcurrentCatalog::ConcurrentCatalog( std::span<GroceryItem const> items, size_type maxReaders )
+  : _index    ( items                                        ),
+    _slots    ( std::make_unique<ReaderSlot[]>( maxReaders ) ),
+    _slotCount( maxReaders                                   )
+{
+  auto names      = _index.items();
+  auto chunkCount = ( names.size() + chunkSize - 1 ) / chunkSize;
+
+  auto version = std::make_unique<Version>();
+  version->chunks.reserve( chunkCount );
+  _chunks.reserve( chunkCount );
+  for( size_type chunk = 0; chunk < chunkCount; ++chunk )
+  {
+    auto prices = std::make_unique<PriceChunk>();
+    for( size_type i = chunk * chunkSize; i < std::min( names.size(), ( chunk + 1 ) * chunkSize ); ++i )
+    {
+      prices->prices[i % chunkSize] = names[i].price();
+    }
+    version->chunks.push_back( prices.get() );
+    _chunks.push_back( std::move( prices ) );
+  }
+
+  _currentVersion = std::move( version );
+  _current.store( _currentVersion.get() );
+}
+
+
+ConcurrentCatalog::~ConcurrentCatalog() noexcept = default;
+
+
+
+
+/*******************************************************************************
+**  Reading
+*******************************************************************************/
+
+ConcurrentCatalog::Reader ConcurrentCatalog::reader()
+{
+  for( size_type i = 0; i < _slotCount; ++i )
+  {
+    bool unclaimed = false;
+    if( _slots[i].claimed.compare_exchange_strong( unclaimed, true, std::memory_order_acquire ) )  return Reader( *this, _slots[i] );
+  }
+  throw std::length_error( "ConcurrentCatalog::reader:  every reader slot is in use" );
+}
+
+
+
+
+/*******************************************************************************
+**  Writing
+*******************************************************************************/
+
+ConcurrentCatalog::size_type ConcurrentCatalog::update( std::span<PriceUpdate const> updates )
+{
+  std::lock_guard lock( _writerMutex );
+
+  // Build the next version off to the side.  Nothing shared is changed until everything that can throw has been done.
+  Version const & current = *_currentVersion;
+  auto            next    = std::make_unique<Version>( Version{ current.number + 1, current.chunks } );
+
+  std::vector<std::unique_ptr<PriceChunk>> copies( _chunks.size() );  // Chunk copies made for this batch, by chunk number
+  size_type applied = 0,  copied = 0;
+  for( auto const & [upcCode, price] : updates )
+  {
+    GroceryItem const * item = _index.find( upcCode );
+    if( item == nullptr )  continue;
+
+    auto position = static_cast<size_type>( item - _index.items().data() );
+    auto chunk    = position / chunkSize;
+    if( !copies[chunk] )
+    {
+      if( _spareChunks.empty() )  copies[chunk] = std::make_unique<PriceChunk>( *_chunks[chunk] );
+      else                        { copies[chunk] = std::move( _spareChunks.back() );  _spareChunks.pop_back();  *copies[chunk] = *_chunks[chunk]; }
+      next->chunks[chunk] = copies[chunk].get();
+      ++copied;
+    }
+    copies[chunk]->prices[position % chunkSize] = price;
+    ++applied;
+  }
+  if( applied == 0 )  return 0;
+
+  Retired retired;
+  retired.chunks.reserve( copied );
+  _retired.reserve( _retired.size() + 1 );
+
+
+  // Commit
+  for( size_type chunk = 0; chunk < copies.size(); ++chunk )
+  {
+    if( !copies[chunk] )  continue;
+    retired.chunks.push_back( std::exchange( _chunks[chunk], std::move( copies[chunk] ) ) );
+  }
+
+  _current.store( next.get() );
+  retired.version = std::exchange( _currentVersion, std::move( next ) );
+  retired.epoch   = _epoch.fetch_add( 1 );
+  _retired.push_back( std::move( retired ) );
+
+  reclaim();
+  return applied;
+}
+
+
+std::uint64_t ConcurrentCatalog::version() const noexcept
+{ return _current.load( std::memory_order_acquire )->number; }
+
+
+ConcurrentCatalog::size_type ConcurrentCatalog::retiredPending() const
+{
+  std::lock_guard lock( _writerMutex );
+  return _retired.size();
+}
+
+
+ConcurrentCatalog::size_type ConcurrentCatalog::size() const noexcept
+{ return _index.size(); }
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+
+void ConcurrentCatalog::reclaim()
+{
+  std::uint64_t oldest = ReaderSlot::idle;
+  for( size_type i = 0; i < _slotCount; ++i )  oldest = std::min( oldest, _slots[i].epoch.load() );
+
+  // Freed chunks are kept for reuse, up to as many as a version has, sparing the allocator a malloc/free pair per chunk copied
+  auto freed = std::ranges::find_if( _retired, [&]( Retired const & retired ) { return retired.epoch >= oldest; } );
+  for( auto retired = _retired.begin(); retired != freed; ++retired )
+  {
+    for( auto & chunk : retired->chunks )
+    {
+      if( _spareChunks.size() >= _chunks.size() )  break;
+      _spareChunks.push_back( std::move( chunk ) );
+    }
+  }
+  _retired.erase( _retired.begin(), freed );
+}
+
+
+
+
+/*******************************************************************************
+**  Reader
+*******************************************************************************/
+
+ConcurrentCatalog::Reader::Reader( ConcurrentCatalog const & catalog, ReaderSlot & slot ) noexcept
+  : _catalog( &catalog ), _slot( &slot )
+{}
+
+
+ConcurrentCatalog::Reader::Reader( Reader && other ) noexcept
+  : _catalog( std::exchange( other._catalog, nullptr ) ),
+    _slot   ( std::exchange( other._slot,    nullptr ) )
+{}
+
+
+ConcurrentCatalog::Reader & ConcurrentCatalog::Reader::operator=( Reader && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    if( _slot != nullptr )  _slot->claimed.store( false, std::memory_order_release );
+    _catalog = std::exchange( rhs._catalog, nullptr );
+    _slot    = std::exchange( rhs._slot,    nullptr );
+  }
+  return *this;
+}
+
+
+ConcurrentCatalog::Reader::~Reader() noexcept
+{
+  if( _slot != nullptr )  _slot->claimed.store( false, std::memory_order_release );
+}
+
+
+ConcurrentCatalog::Snapshot ConcurrentCatalog::Reader::snapshot() const noexcept
+{ return Snapshot( *_catalog, *_slot ); }
+
+
+
+
+/*******************************************************************************
+**  Snapshot
+*******************************************************************************/
+
+ConcurrentCatalog::Snapshot::Snapshot( ConcurrentCatalog const & catalog, ReaderSlot & slot ) noexcept
+  : _catalog( catalog ), _slot( slot )
+{
+  if( _slot.depth++ == 0 )  _slot.epoch.store( _catalog._epoch.load() );
+  _version = _catalog._current.load();
+}
+
+
+ConcurrentCatalog::Snapshot::~Snapshot() noexcept
+{
+  if( --_slot.depth == 0 )  _slot.epoch.store( ReaderSlot::idle, std::memory_order_release );
+}
+
+
+std::uint64_t ConcurrentCatalog::Snapshot::version() const noexcept
+{ return _version->number; }
+
+
+ConcurrentCatalog::size_type ConcurrentCatalog::Snapshot::size() const noexcept
+{ return _catalog._index.size(); }
+
+
+double ConcurrentCatalog::Snapshot::price( size_type position ) const noexcept
+{ return _version->chunks[position / chunkSize]->prices[position % chunkSize]; }
+
+
+std::optional<double> ConcurrentCatalog::Snapshot::price( std::string_view upcCode ) const noexcept
+{
+  GroceryItem const * found = _catalog._index.find( upcCode );
+  if( found == nullptr )  return std::nullopt;
+  return price( static_cast<size_type>( found - _catalog._index.items().data() ) );
+}
+
+
+GroceryItem ConcurrentCatalog::Snapshot::item( size_type position ) const
+{
+  GroceryItem groceryItem = _catalog._index.items()[position];
+  groceryItem.price( price( position ) );
+  return groceryItem;
+}
+
+
+std::optional<GroceryItem> ConcurrentCatalog::Snapshot::find( std::string_view upcCode ) const
+{
+  GroceryItem const * found = _catalog._index.find( upcCode );
+  if( found == nullptr )  return std::nullopt;
+  return item( static_cast<size_type>( found - _catalog._index.items().data() ) );
+}
@@ -0,0 +1,161 @@
+#pragma once                                                                  // include guard
+
+#include <array>
+#include <atomic>
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint64_t
+#include <memory>                                                             // unique_ptr
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "UpcIndex.hpp"
+
+
+
+
+// A catalog that many threads read while price updates keep arriving, without a lock on the read side.
+//
+// UPC codes, brand names, and product names never change after construction; prices do.  Prices live in fixed-size chunks, and a
+// version of the catalog is a table of pointers to chunks.  A writer applies a whole batch of updates by copying just the chunks the
+// batch touches, building a new table that shares every other chunk with the current version, and publishing it with one atomic
+// pointer store.  Nothing a reader can see is ever modified, so every read is of one consistent version:  either all of a batch's
+// updates or none of them.
+//
+// Readers take a Snapshot through their own Reader handle.  Taking and dropping a snapshot is a few atomic loads and stores with no
+// loops and no locks (wait-free), and lookups inside it touch only immutable data.  Superseded versions and chunks are reclaimed
+// by epoch:  each Reader announces the epoch it entered in, and a writer frees a retired version only once no Reader can still be
+// looking at it.  A Reader that holds a snapshot for a long time therefore delays reclamation, never a writer.
+//
+// Writers are serialized by a mutex; batching updates amortizes both it and the copying.  At most maxReaders Readers may exist at once.
+class ConcurrentCatalog
+{
+  public:
+    class Reader;
+    class Snapshot;
+
+    using size_type = std::size_t;
+
+    static constexpr size_type chunkSize = 128;                               // Prices per copy-on-write chunk (1 KiB)
+
+    struct PriceUpdate
+    {
+      std::string upcCode;
+      double      price = 0.0;
+    };
+
+
+    // Constructors and destructor
+    explicit ConcurrentCatalog( std::span<GroceryItem const> items, size_type maxReaders = 256 );   // Where UPC codes repeat, the first item is kept
+    ConcurrentCatalog            ( ConcurrentCatalog const & ) = delete;
+    ConcurrentCatalog & operator=( ConcurrentCatalog const & ) = delete;
+   ~ConcurrentCatalog() noexcept;                                             // No Reader may outlive the catalog
+
+
+    // Reading
+    Reader reader();                                                          // Throws std::length_error if maxReaders Readers already exist
+
+
+    // Writing
+    size_type     update        ( std::span<PriceUpdate const> updates );     // Publishes all of updates as one new version.  Unknown UPC codes are skipped; returns how many updates were applied
+    std::uint64_t version       () const noexcept;                            // The latest published version, starting from 0
+    size_type     retiredPending() const;                                     // Versions superseded but not yet freed because some Reader might still see them
+    size_type     size          () const noexcept;
+
+  private:
+    struct PriceChunk
+    {
+      std::array<double, chunkSize> prices{};
+    };
+
+    struct Version
+    {
+      std::uint64_t                    number = 0;
+      std::vector<PriceChunk const *>  chunks;
+    };
+
+    struct Retired                                                            // A version and the chunks the next version replaced
+    {
+      std::uint64_t                            epoch = 0;
+      std::unique_ptr<Version>                 version;
+      std::vector<std::unique_ptr<PriceChunk>> chunks;
+    };
+
+    struct alignas( 64 ) ReaderSlot                                           // One cache line per Reader, so Readers don't contend
+    {
+      static constexpr std::uint64_t idle = UINT64_MAX;
+
+      std::atomic<std::uint64_t> epoch{ idle };                               // Epoch the Reader entered its snapshot in, or idle
+      std::atomic<bool>          claimed{ false };
+      unsigned                   depth = 0;                                   // Snapshots the Reader holds, touched only by the Reader's own thread
+    };
+
+    void reclaim();                                                           // Frees retired versions no Reader can see.  Requires _writerMutex
+
+    UpcIndex                                 _index;                          // Immutable:  UPC code -> position, and the names at each position
+    std::unique_ptr<ReaderSlot[]>            _slots;
+    size_type                                _slotCount = 0;
+
+    std::atomic<Version const *>             _current{ nullptr };
+    std::atomic<std::uint64_t>               _epoch{ 0 };
+
+    mutable std::mutex                       _writerMutex;                    // Guards everything below
+    std::unique_ptr<Version>                 _currentVersion;                 // Owns what _current points to
+    std::vector<std::unique_ptr<PriceChunk>> _chunks;                         // Owns the current version's chunks
+    std::vector<Retired>                     _retired;                        // Oldest first
+    std::vector<std::unique_ptr<PriceChunk>> _spareChunks;                    // Reclaimed, ready to be copied into
+};
+
+
+
+
+// A registration for one reading thread.  Use it from one thread at a time; take snapshots from it as often as needed.
+class ConcurrentCatalog::Reader
+{
+  public:
+    Reader            ( Reader && other ) noexcept;
+    Reader & operator=( Reader && rhs   ) noexcept;
+   ~Reader() noexcept;
+
+    Snapshot snapshot() const noexcept;                                       // Wait-free
+
+  private:
+    friend class ConcurrentCatalog;
+    Reader( ConcurrentCatalog const & catalog, ReaderSlot & slot ) noexcept;
+
+    ConcurrentCatalog const * _catalog = nullptr;
+    ReaderSlot              * _slot    = nullptr;
+};
+
+
+
+
+// One consistent version of the catalog, and everything in it, stays valid for as long as the Snapshot lives.  Snapshots may nest,
+// but must not outlive their Reader.
+class ConcurrentCatalog::Snapshot
+{
+  public:
+    Snapshot            ( Snapshot const & ) = delete;
+    Snapshot & operator=( Snapshot const & ) = delete;
+   ~Snapshot() noexcept;
+
+    std::uint64_t              version() const noexcept;
+    size_type                  size   () const noexcept;
+
+    std::optional<double>      price  ( std::string_view upcCode ) const noexcept;   // Empty if the UPC code isn't in the catalog
+    std::optional<GroceryItem> find   ( std::string_view upcCode ) const;
+    double                     price  ( size_type position ) const noexcept;         // Positions are 0 through size()-1, in no particular order
+    GroceryItem                item   ( size_type position ) const;
+
+  private:
+    friend class Reader;
+    Snapshot( ConcurrentCatalog const & catalog, ReaderSlot & slot ) noexcept;
+
+    ConcurrentCatalog const & _catalog;
+    ReaderSlot              & _slot;
+    Version           const * _version;
+};
@@ -0,0 +1,26 @@
+#pragma once                                                                  // include guard
+
+#include <algorithm>                                                          // max()
+#include <cmath>                                                              // abs()
+#include <type_traits>                                                        // is_floating_point_v, common_type_t
+
+
+
+
+// Avoid direct equality comparisons on floating point numbers. Two values are equal if they are "close enough", which is
+// represented by Epsilon.  Usually, this is a pretty small number, but since we are dealing with money (only two, maybe three
+// decimal places) we need to be a bit more tolerant.
+//
+// The two values are "close enough" to be considered equal if the distance between lhs and rhs is less than:
+// o)  EPSILON1, otherwise
+// o)  EPSILON2 percentage of the larger value's magnitude
+//
+// Shared by GroceryItem and every other type that has to agree with GroceryItem on when two prices are the same.
+template< typename T,  typename U >   requires std::is_floating_point_v<std::common_type_t<U, T> >
+constexpr bool floating_point_is_equal( T const lhs,  U const rhs,  long double const EPSILON1 = /*1e-12L*/ 1e-4L,  long double const EPSILON2 = 1e-8L ) noexcept
+{
+  // Avoid multiple calls to abs(...) or max(...). Use local variables:
+  long double diff   = std::abs(lhs - rhs);
+  long double larger = std::max(std::abs(lhs), std::abs(rhs));
+  return (diff <= EPSILON1) || (diff <= (EPSILON2 * larger));
+}
@@ -0,0 +1,331 @@
+#include <algorithm>                                                  // min(), max(), upper_bound()
+#include <array>
+#include <compare>                                                    // weak_ordering
+#include <cstddef>                                                    // size_t
+#include <iomanip>                                                    // quoted()
+#include <iostream>                                                   // ostream
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>                                                    // move()
+#include <vector>
+
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
+#include "GroceryCatalog.hpp"
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, appending, and bulk loading
+*******************************************************************************/
+
+GroceryCatalog::GroceryCatalog( std::span<GroceryItem const> items )
+{ append( items ); }
+
+
+void GroceryCatalog::reserve( size_type capacity )
+{
+  _upcCodes    .reserve( capacity );
+  _brandNames  .reserve( capacity );
+  _productNames.reserve( capacity );
+  _prices      .reserve( capacity );
+}
+
+
+void GroceryCatalog::push_back( GroceryItem const & groceryItem )
+{ emplace_back( groceryItem.productName(), groceryItem.brandName(), groceryItem.upcCode(), groceryItem.price() ); }
+
+
+void GroceryCatalog::push_back( GroceryItem && groceryItem )
+{
+  double price = groceryItem.price();
+  emplace_back( std::move( groceryItem ).productName(), std::move( groceryItem ).brandName(), std::move( groceryItem ).upcCode(), price );
+}
+
+
+void GroceryCatalog::emplace_back( std::string productName, std::string brandName, std::string upcCode, double price )
+{
+  // Strong exception guarantee:  make room in every column first, so the pushes below cannot throw part way through a row
+  if( _prices.size() == _prices.capacity() )  reserve( std::max<size_type>( 16, _prices.size() * 2 ) );
+
+  _upcCodes    .push_back( std::move( upcCode     ) );
+  _brandNames  .push_back( std::move( brandName   ) );
+  _productNames.push_back( std::move( productName ) );
+  _prices      .push_back( price );
+}
+
+
+void GroceryCatalog::append( std::span<GroceryItem const> items )
+{
+  reserve( size() + items.size() );
+  for( auto const & item : items )  push_back( item );
+}
+
+
+ParseStatus GroceryCatalog::appendText( std::string_view text )
+{
+  char const * cursor = text.data();
+  char const * end    = cursor + text.size();
+
+  RecordView  record;
+  ParseStatus status;
+  while( ( status = parseRecord( cursor, end, record ) ) == ParseStatus::ok )
+  {
+    emplace_back( unescape( record.productName ), unescape( record.brandName ), unescape( record.upcCode ), record.price );
+  }
+  return status;
+}
+
+
+void GroceryCatalog::clear() noexcept
+{
+  _upcCodes    .clear();
+  _brandNames  .clear();
+  _productNames.clear();
+  _prices      .clear();
+}
+
+
+
+
+/*******************************************************************************
+**  Size and row access
+*******************************************************************************/
+
+GroceryCatalog::size_type GroceryCatalog::size() const noexcept
+{ return _prices.size(); }
+
+
+bool GroceryCatalog::empty() const noexcept
+{ return _prices.empty(); }
+
+
+GroceryCatalog::Row GroceryCatalog::operator[]( size_type row ) noexcept
+{ return Row( this, row ); }
+
+
+GroceryCatalog::ConstRow GroceryCatalog::operator[]( size_type row ) const noexcept
+{ return ConstRow( this, row ); }
+
+
+GroceryItem GroceryCatalog::item( size_type row ) const
+{ return GroceryItem( _productNames[row], _brandNames[row], _upcCodes[row], _prices[row] ); }
+
+
+GroceryCatalog::iterator       GroceryCatalog::begin()       noexcept { return iterator      ( this, 0      ); }
+GroceryCatalog::iterator       GroceryCatalog::end  ()       noexcept { return iterator      ( this, size() ); }
+GroceryCatalog::const_iterator GroceryCatalog::begin() const noexcept { return const_iterator( this, 0      ); }
+GroceryCatalog::const_iterator GroceryCatalog::end  () const noexcept { return const_iterator( this, size() ); }
+
+
+
+
+/*******************************************************************************
+**  Columns
+*******************************************************************************/
+
+std::span<std::string const> GroceryCatalog::upcCodes    () const noexcept { return _upcCodes;     }
+std::span<std::string const> GroceryCatalog::brandNames  () const noexcept { return _brandNames;   }
+std::span<std::string const> GroceryCatalog::productNames() const noexcept { return _productNames; }
+std::span<double      const> GroceryCatalog::prices      () const noexcept { return _prices;       }
+
+
+
+
+/*******************************************************************************
+**  Column aggregates
+*******************************************************************************/
+
+double GroceryCatalog::priceSum() const noexcept
+{
+  // Independent running sums let the additions overlap (and vectorize) instead of each waiting on the one before it
+  constexpr std::size_t lanes = 8;
+
+  std::array<double, lanes> sums{};
+  std::size_t const         count = _prices.size();
+  std::size_t               i     = 0;
+  for( ; i + lanes <= count; i += lanes )
+  {
+    for( std::size_t lane = 0; lane < lanes; ++lane )  sums[lane] += _prices[i + lane];
+  }
+  for( ; i < count; ++i )  sums[0] += _prices[i];
+
+  double sum = 0.0;
+  for( auto laneSum : sums )  sum += laneSum;
+  return sum;
+}
+
+
+std::optional<GroceryCatalog::PriceRange> GroceryCatalog::priceRange() const noexcept
+{
+  if( _prices.empty() )  return std::nullopt;
+
+  PriceRange range{ _prices.front(), _prices.front() };
+  for( double price : _prices )
+  {
+    range.min = std::min( range.min, price );
+    range.max = std::max( range.max, price );
+  }
+  return range;
+}
+
+
+std::map<std::string, GroceryCatalog::PriceStatistics> GroceryCatalog::priceStatisticsByBrand() const
+{
+  // Group under views of the brand column, and copy each brand name only once at the end
+  std::unordered_map<std::string_view, PriceStatistics> groups;
+  for( std::size_t row = 0; row < _prices.size(); ++row )
+  {
+    double price = _prices[row];
+    auto [group, added] = groups.try_emplace( _brandNames[row], PriceStatistics{ 0, 0.0, price, price } );
+    auto & statistics   = group->second;
+    statistics.count += 1;
+    statistics.sum   += price;
+    statistics.min    = std::min( statistics.min, price );
+    statistics.max    = std::max( statistics.max, price );
+  }
+
+  std::map<std::string, PriceStatistics> result;
+  for( auto const & [brand, statistics] : groups )  result.emplace( brand, statistics );
+  return result;
+}
+
+
+std::vector<std::size_t> GroceryCatalog::priceHistogram( std::span<double const> bandEdges ) const
+{
+  std::vector<std::size_t> counts( bandEdges.size() < 2 ? 0 : bandEdges.size() - 1, 0 );
+  if( counts.empty() )  return counts;
+
+  for( double price : _prices )
+  {
+    // upper_bound finds the first edge above price; the band is the one just before it
+    auto edge = std::upper_bound( bandEdges.begin(), bandEdges.end(), price );
+    if( edge != bandEdges.begin() && edge != bandEdges.end() )  ++counts[static_cast<std::size_t>( edge - bandEdges.begin() ) - 1];
+  }
+  return counts;
+}
+
+
+
+
+/*******************************************************************************
+**  Row views
+*******************************************************************************/
+
+GroceryCatalog::ConstRow::ConstRow( GroceryCatalog const * catalog, size_type row ) noexcept
+  : _catalog( catalog ),
+    _row    ( row     )
+{}
+
+
+std::string const & GroceryCatalog::ConstRow::upcCode    () const noexcept { return _catalog->_upcCodes    [_row]; }
+std::string const & GroceryCatalog::ConstRow::brandName  () const noexcept { return _catalog->_brandNames  [_row]; }
+std::string const & GroceryCatalog::ConstRow::productName() const noexcept { return _catalog->_productNames[_row]; }
+double              GroceryCatalog::ConstRow::price      () const noexcept { return _catalog->_prices      [_row]; }
+
+
+GroceryCatalog::ConstRow::operator GroceryItem() const
+{ return _catalog->item( _row ); }
+
+
+std::weak_ordering GroceryCatalog::ConstRow::operator<=>( ConstRow const & rhs ) const noexcept
+{
+  // Same as GroceryItem::operator<=>:  UPC code, product name, brand name, then price (within epsilon)
+  if( auto cmp = upcCode()     <=> rhs.upcCode();      cmp != 0 )  return cmp;
+  if( auto cmp = productName() <=> rhs.productName();  cmp != 0 )  return cmp;
+  if( auto cmp = brandName()   <=> rhs.brandName();    cmp != 0 )  return cmp;
+
+  if( floating_point_is_equal( price(), rhs.price() ) )  return std::weak_ordering::equivalent;
+  return ( price() < rhs.price() ) ? std::weak_ordering::less : std::weak_ordering::greater;
+}
+
+
+bool GroceryCatalog::ConstRow::operator==( ConstRow const & rhs ) const noexcept
+{
+  return  floating_point_is_equal( price(), rhs.price() )
+       && upcCode()     == rhs.upcCode()
+       && brandName()   == rhs.brandName()
+       && productName() == rhs.productName();
+}
+
+
+GroceryCatalog::Row::Row( GroceryCatalog * catalog, size_type row ) noexcept
+  : ConstRow( catalog, row )
+{}
+
+
+GroceryCatalog * GroceryCatalog::Row::mutableCatalog() const noexcept
+{ return const_cast<GroceryCatalog *>( _catalog ); }                  // Rows are only ever made from a non-const catalog
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::upcCode( std::string newUpcCode ) const
+{
+  mutableCatalog()->_upcCodes[_row] = std::move( newUpcCode );
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::brandName( std::string newBrandName ) const
+{
+  mutableCatalog()->_brandNames[_row] = std::move( newBrandName );
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::productName( std::string newProductName ) const
+{
+  mutableCatalog()->_productNames[_row] = std::move( newProductName );
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::price( double newPrice ) const
+{
+  mutableCatalog()->_prices[_row] = newPrice;
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::operator=( GroceryItem const & groceryItem ) const
+{
+  upcCode    ( groceryItem.upcCode()     );
+  brandName  ( groceryItem.brandName()   );
+  productName( groceryItem.productName() );
+  price      ( groceryItem.price()       );
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::operator=( ConstRow const & row ) const
+{
+  // Copied before assigning, so a row assigned to itself (or from a row the assignment moves) reads the fields it started with
+  upcCode    ( std::string( row.upcCode()     ) );
+  brandName  ( std::string( row.brandName()   ) );
+  productName( std::string( row.productName() ) );
+  price      ( row.price() );
+  return *this;
+}
+
+
+GroceryCatalog::Row const & GroceryCatalog::Row::operator=( Row const & row ) const
+{ return *this = static_cast<ConstRow const &>( row ); }
+
+
+
+
+/*******************************************************************************
+**  Insertion Operator
+*******************************************************************************/
+
+std::ostream & operator<<( std::ostream & stream, GroceryCatalog::ConstRow const & row )
+{
+  return stream << std::quoted( row.upcCode()     ) << ", "
+                << std::quoted( row.brandName()   ) << ", "
+                << std::quoted( row.productName() ) << ", "
+                << row.price();
+}
@@ -0,0 +1,205 @@
+#pragma once                                                                  // include guard
+
+#include <compare>                                                            // std::weak_ordering
+#include <cstddef>                                                            // size_t, ptrdiff_t
+#include <iostream>
+#include <iterator>                                                           // random_access_iterator_tag, input_iterator_tag
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>                                                        // conditional_t, is_same_v
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+
+
+
+
+// A collection of grocery items stored as columns (structure of arrays):  all UPC codes together, all brand names together, all
+// product names together, and all prices together.  A scan over one attribute, the prices in particular, touches only that attribute's
+// memory instead of dragging three std::string headers through the cache along with every 8-byte price.
+//
+// Rows are exposed through lightweight views with the same accessors (and, for mutable rows, modifiers) as GroceryItem, and convert to
+// GroceryItem when a real object is needed.
+class GroceryCatalog
+{
+  public:
+    class ConstRow;
+    class Row;
+    template< typename RowType >  class Iterator;
+
+    using size_type      = std::size_t;
+    using iterator       = Iterator<Row>;
+    using const_iterator = Iterator<ConstRow>;
+
+    struct PriceRange                                                         // Smallest and largest price
+    {
+      double min = 0.0;
+      double max = 0.0;
+    };
+
+    struct PriceStatistics                                                    // Summary of a group of prices
+    {
+      std::size_t count = 0;
+      double      sum   = 0.0;
+      double      min   = 0.0;
+      double      max   = 0.0;
+    };
+
+
+    // Constructors
+    GroceryCatalog() = default;
+    explicit GroceryCatalog( std::span<GroceryItem const> items );
+
+
+    // Appending, bulk loading
+    void        reserve     ( size_type capacity );
+    void        push_back   ( GroceryItem const & groceryItem );
+    void        push_back   ( GroceryItem      && groceryItem );
+    void        emplace_back( std::string productName, std::string brandName, std::string upcCode, double price );
+    void        append      ( std::span<GroceryItem const> items );
+    ParseStatus appendText  ( std::string_view text );                        // Parses operator<< text straight into the columns.  Records before a failure are kept; returns endOfInput on success
+    void        clear       () noexcept;
+
+
+    // Size and row access
+    size_type   size () const noexcept;
+    bool        empty() const noexcept;
+
+    Row         operator[]( size_type row )       noexcept;
+    ConstRow    operator[]( size_type row ) const noexcept;
+    GroceryItem item      ( size_type row ) const;                            // A copy of the row as a GroceryItem
+
+    iterator       begin()       noexcept;
+    iterator       end  ()       noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end  () const noexcept;
+
+
+    // Columns
+    std::span<std::string const> upcCodes    () const noexcept;
+    std::span<std::string const> brandNames  () const noexcept;
+    std::span<std::string const> productNames() const noexcept;
+    std::span<double      const> prices      () const noexcept;
+
+
+    // Column aggregates
+    double                                 priceSum              () const noexcept;
+    std::optional<PriceRange>              priceRange            () const noexcept;   // Empty for an empty catalog
+    std::map<std::string, PriceStatistics> priceStatisticsByBrand() const;
+    std::vector<std::size_t>               priceHistogram        ( std::span<double const> bandEdges ) const;   // Count of prices in each [bandEdges[i], bandEdges[i+1]).  bandEdges must be ascending
+
+  private:
+    std::vector<std::string> _upcCodes;
+    std::vector<std::string> _brandNames;
+    std::vector<std::string> _productNames;
+    std::vector<double>      _prices;
+};
+
+
+
+
+// A read-only view of one row, with GroceryItem's accessors.  Valid until the catalog is resized or destroyed.
+class GroceryCatalog::ConstRow
+{
+  friend class GroceryCatalog;
+
+  public:
+    std::string const & upcCode    () const noexcept;
+    std::string const & brandName  () const noexcept;
+    std::string const & productName() const noexcept;
+    double              price      () const noexcept;
+
+    operator GroceryItem() const;
+
+    std::weak_ordering operator<=>( ConstRow const & rhs ) const noexcept;   // Same ordering and equality as GroceryItem
+    bool               operator== ( ConstRow const & rhs ) const noexcept;
+
+  protected:
+    ConstRow( GroceryCatalog const * catalog, size_type row ) noexcept;
+
+    GroceryCatalog const * _catalog;
+    size_type              _row;
+};
+
+
+
+
+// A mutable view of one row, adding GroceryItem's modifiers
+class GroceryCatalog::Row : public GroceryCatalog::ConstRow
+{
+  friend class GroceryCatalog;
+
+  public:
+    Row const & upcCode    ( std::string newUpcCode     ) const;
+    Row const & brandName  ( std::string newBrandName   ) const;
+    Row const & productName( std::string newProductName ) const;
+    Row const & price      ( double      newPrice       ) const;
+
+    using ConstRow::upcCode;
+    using ConstRow::brandName;
+    using ConstRow::productName;
+    using ConstRow::price;
+
+    Row const & operator=( GroceryItem const & groceryItem ) const;           // Overwrites the whole row
+    Row const & operator=( ConstRow    const & row         ) const;           // Overwrites the whole row with another row's fields (Ex:  catalog[i] = catalog[j])
+    Row const & operator=( Row         const & row         ) const;           // The same:  a Row is a view, so assigning one copies fields rather than rebinding the view
+
+    Row( Row const & ) noexcept = default;
+
+  private:
+    Row( GroceryCatalog * catalog, size_type row ) noexcept;
+
+    GroceryCatalog * mutableCatalog() const noexcept;
+};
+
+
+
+
+// Random access iterator over rows, yielding Row or ConstRow views by value
+template< typename RowType >
+class GroceryCatalog::Iterator
+{
+  public:
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;                        // Rows are returned by value, which the legacy categories above input don't allow
+    using value_type        = RowType;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = RowType;
+    using pointer           = void;
+    using CatalogPointer    = std::conditional_t<std::is_same_v<RowType, Row>, GroceryCatalog *, GroceryCatalog const *>;
+
+    Iterator() noexcept = default;
+    Iterator( CatalogPointer catalog, size_type row ) noexcept : _catalog( catalog ), _row( row ) {}
+
+    RowType    operator* (                   ) const noexcept { return ( *_catalog )[_row];                                   }
+    RowType    operator[]( difference_type n ) const noexcept { return ( *_catalog )[_row + static_cast<size_type>( n )];     }
+    Iterator & operator++(                   )       noexcept { ++_row;  return *this;                                       }
+    Iterator   operator++( int               )       noexcept { auto copy = *this;  ++_row;  return copy;                    }
+    Iterator & operator--(                   )       noexcept { --_row;  return *this;                                       }
+    Iterator   operator--( int               )       noexcept { auto copy = *this;  --_row;  return copy;                    }
+    Iterator & operator+=( difference_type n )       noexcept { _row += static_cast<size_type>( n );  return *this;          }
+    Iterator & operator-=( difference_type n )       noexcept { _row -= static_cast<size_type>( n );  return *this;          }
+
+    friend Iterator        operator+( Iterator it, difference_type n ) noexcept { return it += n; }
+    friend Iterator        operator+( difference_type n, Iterator it ) noexcept { return it += n; }
+    friend Iterator        operator-( Iterator it, difference_type n ) noexcept { return it -= n; }
+    friend difference_type operator-( Iterator const & lhs, Iterator const & rhs ) noexcept
+    { return static_cast<difference_type>( lhs._row ) - static_cast<difference_type>( rhs._row ); }
+
+    friend bool                 operator== ( Iterator const & lhs, Iterator const & rhs ) noexcept { return lhs._row == rhs._row;  }
+    friend std::strong_ordering operator<=>( Iterator const & lhs, Iterator const & rhs ) noexcept { return lhs._row <=> rhs._row; }
+
+  private:
+    CatalogPointer _catalog = nullptr;
+    size_type      _row     = 0;
+};
+
+
+
+
+// Insertion Operator - the same text form GroceryItem writes
+std::ostream & operator<<( std::ostream & stream, GroceryCatalog::ConstRow const & row );
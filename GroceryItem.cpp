@@ -1,49 +1,17 @@
-#include <algorithm>                                                  // max()
-#include <cmath>                                                      // abs(), pow()
 #include <compare>                                                    // weak_ordering
+#include <cstddef>                                                    // size_t
+#include <functional>                                                 // hash
 #include <iomanip>                                                    // quoted(), ios::failbit
 #include <iostream>                                                   // istream, ostream, ws()
 #include <string>
-#include <type_traits>                                                // is_floating_point_v, common_type_t
+#include <string_view>
 #include <utility>                                                    // move()
 
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
 #include "GroceryItem.hpp"
 
 
 
-/*******************************************************************************
-**  Implementation of non-member private types, objects, and functions
-*******************************************************************************/
-namespace    // unnamed, anonymous namespace
-{
-  // Avoid direct equality comparisons on floating point numbers. Two values are equal if they are "close enough", which is
-  // represented by Epsilon.  Usually, this is a pretty small number, but since we are dealing with money (only two, maybe three
-  // decimal places) we need to be a bit more tolerant.
-  //
-  // The two values are "close enough" to be considered equal if the distance between lhs and rhs is less than:
-  // o)  EPSILON1, otherwise
-  // o)  EPSILON2 percentage of the larger value's magnitude
-
-  template< typename T,  typename U >   requires std::is_floating_point_v<std::common_type_t<U, T> >
-  constexpr bool floating_point_is_equal( T const lhs,  U const rhs,  long double const EPSILON1 = /*1e-12L*/ 1e-4L,  long double const EPSILON2 = 1e-8L ) noexcept
-  {
-    ///////////////////////// TO-DO (1) //////////////////////////////
-    {
-    // Avoid multiple calls to abs(...) or max(...). Use local variables:
-    long double diff   = std::abs(lhs - rhs);
-    long double larger = std::max(std::abs(lhs), std::abs(rhs));
-    return (diff <= EPSILON1) || (diff <= (EPSILON2 * larger));
-}
-    /////////////////////// END-TO-DO (1) ////////////////////////////
-  }
-}    // unnamed, anonymous namespace
-
-
-
-
-
-
-
 /*******************************************************************************
 **  Constructors, assignments, and destructor
 *******************************************************************************/
@@ -339,7 +307,7 @@ std::istream & operator>>( std::istream & stream, GroceryItem & groceryItem )
   //
   // This function should be symmetrical with operator<< below.  Read what your write, and write what you read
 
-  char delimiter = '\x{00}';                                          // C++23 delimited escape sequence for the character whose value is zero (the null character)
+  char delimiter = '\0';                                              // the null character (not '\x{00}':  GCC 12 doesn't support C++23 delimited escapes)
   ///////////////////////// TO-DO (21) //////////////////////////////
   std::string upc, brand, product;
   double priceVal{};
@@ -384,3 +352,25 @@ stream << std::quoted(groceryItem.upcCode())
 return stream;
   /////////////////////// END-TO-DO (22) ////////////////////////////
 }
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Hash support
+*******************************************************************************/
+
+std::size_t std::hash<GroceryItem>::operator()( GroceryItem const & groceryItem ) const noexcept
+{
+  // Must agree with operator==, so hash exactly the attributes operator== compares exactly - everything but the price
+  std::hash<std::string_view> hashText;
+  auto combine = []( std::size_t seed, std::size_t value ) { return seed ^ ( value + 0x9e3779b97f4a7c15ULL + ( seed << 6 ) + ( seed >> 2 ) ); };
+
+  std::size_t seed = hashText( groceryItem.upcCode() );
+  seed = combine( seed, hashText( groceryItem.brandName()   ) );
+  seed = combine( seed, hashText( groceryItem.productName() ) );
+  return seed;
+}
@@ -1,6 +1,8 @@
 #pragma once                                                                  // include guard
 
 #include <compare>                                                            // std::weak_ordering
+#include <cstddef>                                                            // size_t
+#include <functional>                                                         // std::hash
 #include <iostream>
 #include <string>
 
@@ -45,8 +47,8 @@ class GroceryItem
     GroceryItem & price      ( double      newPrice       ) &;                // Error:  GroceryItem{}.price(13.99);           (The default constructed GrocerItem is an r-value, i.e., an unnamed temporary object)
 
 
-    // Relational Operators
-    std::weak_ordering operator<=>( GroceryItem const & rhs ) const noexcept;
+    // Relational Operators                                                  // UPC codes compare as spelled:  a UPC-A code and its GTIN-14 form ("00" + code) differ
+    std::weak_ordering operator<=>( GroceryItem const & rhs ) const noexcept;  // until normalized (normalizeUpcs(), or a load with UpcHandling::normalize)
     bool               operator== ( GroceryItem const & rhs ) const noexcept;
 
   private:
@@ -55,3 +57,15 @@ class GroceryItem
     std::string _productName;                                                 // the name of the product (Ex: Heinz Tomato Ketchup - 2 Ct, Boston Market Spaghetti With Meatballs)
     double      _price{ 0.0 };                                                // the cost of the item in US Dollars (Ex:  2.29, 1.19)
 };
+
+
+
+
+// Hash support, consistent with operator==:  grocery items that compare equal have equal hashes.  The price is deliberately left out.
+// Prices within epsilon of each other compare equal, and no hash of a double can put every such pair in the same bucket (equality
+// within epsilon isn't even transitive), so only the UPC code, brand name, and product name contribute.
+template<>
+struct std::hash<GroceryItem>
+{
+  std::size_t operator()( GroceryItem const & groceryItem ) const noexcept;
+};
@@ -0,0 +1,212 @@
+#include <charconv>                                                   // from_chars()
+#include <cmath>                                                      // isinf()
+#include <cstdlib>                                                    // strtod()
+#include <string>
+#include <string_view>
+#include <system_error>                                               // errc
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "IngestMetrics.hpp"
+#include "StringMemory.hpp"                                           // onHeap()
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // std::isspace() in the "C" locale, without the locale lookup
+  constexpr bool isWhitespace( char c ) noexcept
+  { return c == ' ' || ( c >= '\t' && c <= '\r' ); }
+
+
+  // std::quoted( std::string & ) extraction, including its fallback to plain std::string extraction when the field doesn't start
+  // with a quote
+  ParseStatus extractField( char const * & cursor, char const * end, FieldView & field ) noexcept
+  {
+    cursor = skipWhitespace( cursor, end );
+    if( cursor == end )  return ParseStatus::truncatedRecord;
+
+    if( *cursor != '"' )
+    {
+      char const * first = cursor;
+      while( cursor != end && !isWhitespace( *cursor ) )  ++cursor;
+      field = { { first, cursor }, false };
+      return ParseStatus::ok;
+    }
+
+    char const * first   = ++cursor;
+    bool         escaped = false;
+    for( ; cursor != end; ++cursor )
+    {
+      if( *cursor == '\\' )
+      {
+        escaped = true;
+        if( ++cursor == end )  break;                                 // An escape with nothing left to escape
+      }
+      else if( *cursor == '"' )
+      {
+        field = { { first, cursor }, escaped };
+        ++cursor;
+        return ParseStatus::ok;
+      }
+    }
+    return ParseStatus::unterminatedQuote;
+  }
+
+
+  // operator>>( std::istream &, char & ) - any single non-whitespace character
+  ParseStatus extractDelimiter( char const * & cursor, char const * end ) noexcept
+  {
+    cursor = skipWhitespace( cursor, end );
+    if( cursor == end )  return ParseStatus::truncatedRecord;
+    ++cursor;
+    return ParseStatus::ok;
+  }
+
+
+  // operator>>( std::istream &, double & ).  The scan below accepts exactly the characters libstdc++'s num_get<char> accumulates
+  // in the "C" locale:  an optional sign, then digits with at most one decimal point, then (only after at least one digit) at most
+  // one 'e' or 'E' optionally followed by a sign.  Like num_get, the whole accumulated text must then convert, so "1e" and "." fail.
+  ParseStatus extractPrice( char const * & cursor, char const * end, double & price ) noexcept
+  {
+    cursor = skipWhitespace( cursor, end );
+    if( cursor == end )  return ParseStatus::truncatedRecord;
+
+    char const * first = cursor;
+    if( *cursor == '+' || *cursor == '-' )  ++cursor;
+
+    bool foundDecimalPoint = false;
+    bool foundExponent     = false;
+    bool foundMantissa     = false;
+    while( cursor != end )
+    {
+      char c = *cursor;
+      if     ( c >= '0' && c <= '9' )                                  foundMantissa     = true;
+      else if( c == '.' && !foundDecimalPoint && !foundExponent )     foundDecimalPoint = true;
+      else if( ( c == 'e' || c == 'E' ) && !foundExponent && foundMantissa )
+      {
+        foundExponent = true;
+        if( ++cursor == end )  break;
+        if( *cursor != '+' && *cursor != '-' )  continue;             // Look at the character following the 'e' again
+      }
+      else break;
+      ++cursor;
+    }
+
+    char const * number = ( *first == '+' ) ? first + 1 : first;      // from_chars() rejects an explicit '+'
+    double       value  = 0.0;
+    auto [last, error]  = std::from_chars( number, cursor, value );
+    if( last != cursor || number == cursor )  return ParseStatus::badPrice;
+
+    if( error == std::errc::result_out_of_range )
+    {
+      // num_get rejects overflow but quietly accepts underflow (to zero or a subnormal), and from_chars() reports both the same way.
+      // This is rare enough to simply ask strtod() for the value num_get would have produced.
+      std::string text( number, cursor );
+      value = std::strtod( text.c_str(), nullptr );
+      if( std::isinf( value ) )  return ParseStatus::badPrice;
+    }
+    else if( error != std::errc{} )  return ParseStatus::badPrice;
+
+    price = value;
+    return ParseStatus::ok;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Parsing
+*******************************************************************************/
+
+char const * skipWhitespace( char const * cursor, char const * end ) noexcept
+{
+  while( cursor != end && isWhitespace( *cursor ) )  ++cursor;
+  return cursor;
+}
+
+
+char const * describe( ParseStatus status ) noexcept
+{
+  switch( status )
+  {
+    case ParseStatus::ok:                return "ok";
+    case ParseStatus::endOfInput:        return "end of input";
+    case ParseStatus::truncatedRecord:   return "input ended part way through a record";
+    case ParseStatus::unterminatedQuote: return "unterminated quoted field";
+    case ParseStatus::badPrice:          return "price is not a valid number";
+  }
+  return "unknown parse status";
+}
+
+
+void unescape( FieldView field, std::string & value )
+{
+  if( !field.escaped )
+  {
+    value.assign( field.text );
+    return;
+  }
+
+  value.clear();
+  value.reserve( field.text.size() );
+  for( auto c = field.text.begin();  c != field.text.end();  ++c )
+  {
+    if( *c == '\\' )  ++c;                                            // extractField() guarantees an escape is always followed by a character
+    value += *c;
+  }
+}
+
+
+std::string unescape( FieldView field )
+{
+  std::string value;
+  unescape( field, value );
+  return value;
+}
+
+
+ParseStatus parseRecord( char const * & cursor, char const * end, RecordView & record ) noexcept
+{
+  cursor = skipWhitespace( cursor, end );
+  if( cursor == end )  return ParseStatus::endOfInput;
+
+  record.begin = cursor;
+
+  ParseStatus status = ParseStatus::ok;
+  {
+    IngestTimer timer( IngestStage::fields );
+    if(    ( status = extractField    ( cursor, end, record.upcCode     ) ) != ParseStatus::ok
+        || ( status = extractDelimiter( cursor, end                     ) ) != ParseStatus::ok
+        || ( status = extractField    ( cursor, end, record.brandName   ) ) != ParseStatus::ok
+        || ( status = extractDelimiter( cursor, end                     ) ) != ParseStatus::ok
+        || ( status = extractField    ( cursor, end, record.productName ) ) != ParseStatus::ok
+        || ( status = extractDelimiter( cursor, end                     ) ) != ParseStatus::ok )
+    {
+      return status;
+    }
+  }
+
+  IngestTimer timer( IngestStage::price );
+  return extractPrice( cursor, end, record.price );
+}
+
+
+GroceryItem toGroceryItem( RecordView const & record )
+{
+  IngestTimer timer( IngestStage::construct );
+  GroceryItem groceryItem( unescape( record.productName ),
+                           unescape( record.brandName   ),
+                           unescape( record.upcCode     ),
+                           record.price );
+
+  if constexpr( IngestMetrics::enabled )
+  {
+    IngestMetrics::count( IngestCounter::heapStrings, onHeap( groceryItem.upcCode() ) + onHeap( groceryItem.brandName() ) + onHeap( groceryItem.productName() ) );
+  }
+  return groceryItem;
+}
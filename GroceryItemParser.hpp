@@ -0,0 +1,69 @@
+#pragma once                                                                  // include guard
+
+#include <string>
+#include <string_view>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// In-place parsing of the text form written by operator<<(std::ostream &, GroceryItem const &).  parseRecord() accepts exactly
+// what operator>>(std::istream &, GroceryItem &) accepts, character for character, but works directly on a contiguous buffer
+// (typically a memory-mapped file) instead of through a stream:
+//   o)  whitespace is what the "C" locale calls whitespace (space, \t, \n, \v, \f, \r)
+//   o)  a field starting with '"' is read like std::quoted - up to the next unescaped '"' where '\' escapes the next character;
+//       any other field is read like std::string extraction - up to the next whitespace
+//   o)  the delimiter after each field is the next non-whitespace character, whatever it is
+//   o)  the price accepts the same characters std::num_get<char>::get(double) does, and converts them with std::from_chars
+
+
+
+
+// Why parseRecord() did, or did not, produce a record
+enum class ParseStatus : unsigned char
+{
+  ok,                                                                         // A record was parsed
+  endOfInput,                                                                 // Only whitespace remained.  Not an error - an extraction loop simply ends here
+  truncatedRecord,                                                            // The input ended part way through a record
+  unterminatedQuote,                                                          // A quoted field, or an escape inside one, ran off the end of the input
+  badPrice                                                                    // The price was missing, not a number, or out of range for a double
+};
+
+char const * describe( ParseStatus status ) noexcept;                          // A short, human readable explanation (Ex: "unterminated quoted field")
+
+
+
+
+// A view of one field inside the parsed buffer.  When escaped is false, text is the field's final value; otherwise text still
+// holds the '\' escape characters and must be passed through unescape().
+struct FieldView
+{
+  std::string_view text;
+  bool             escaped = false;
+};
+
+std::string unescape( FieldView field );                                      // The field's value with escapes removed
+void        unescape( FieldView field, std::string & value );                 // Same, but reuses value's capacity
+
+
+
+
+// One record, still pointing into the parsed buffer
+struct RecordView
+{
+  char const * begin = nullptr;                                               // The record's first non-whitespace character
+  FieldView    upcCode;
+  FieldView    brandName;
+  FieldView    productName;
+  double       price = 0.0;
+};
+
+// std::ws:  the first non-whitespace character at or after cursor, or end
+char const * skipWhitespace( char const * cursor, char const * end ) noexcept;
+
+// Parses the record starting at cursor (leading whitespace is skipped) and advances cursor past it.  On failure cursor is left where
+// the error was detected and record.begin still identifies the record that failed.
+ParseStatus parseRecord( char const * & cursor, char const * end, RecordView & record ) noexcept;
+
+GroceryItem toGroceryItem( RecordView const & record );
@@ -0,0 +1,412 @@
+#include <algorithm>                                                  // find()
+#include <array>
+#include <atomic>
+#include <bit>                                                        // bit_width()
+#include <charconv>                                                   // to_chars()
+#include <chrono>
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GroceryItemParser.hpp"
+#include "IngestMetrics.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  using Snapshot = IngestMetrics::Snapshot;
+  using Counter  = std::atomic<std::uint64_t>;
+
+
+  // One thread's metrics.  Only the owning thread writes them, so a plain load and store bumps a counter (no locked read-modify-write);
+  // they're atomic only so a snapshot can read them while the owner carries on.
+  struct Shard
+  {
+    std::array<Counter, ingestCounterCount>                                        counters    = {};
+    std::array<Counter, parseStatusCount  >                                        parseErrors = {};
+    std::array<std::array<Counter, LatencyHistogram::bucketCount>, ingestStageCount> buckets     = {};
+    std::array<Counter, ingestStageCount  >                                        nanos       = {};
+  };
+
+
+  void bump( Counter & counter, std::uint64_t amount ) noexcept
+  { counter.store( counter.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed ); }
+
+
+  void accumulate( Shard const & shard, Snapshot & totals ) noexcept
+  {
+    for( std::size_t i = 0; i < ingestCounterCount; ++i )  totals.counters   [i] += shard.counters   [i].load( std::memory_order_relaxed );
+    for( std::size_t i = 0; i < parseStatusCount;   ++i )  totals.parseErrors[i] += shard.parseErrors[i].load( std::memory_order_relaxed );
+    for( std::size_t stage = 0; stage < ingestStageCount; ++stage )
+    {
+      auto & histogram = totals.stages[stage];
+      for( std::size_t bucket = 0; bucket < LatencyHistogram::bucketCount; ++bucket )
+      {
+        auto count = shard.buckets[stage][bucket].load( std::memory_order_relaxed );
+        histogram.buckets[bucket] += count;
+        histogram.total           += count;
+      }
+      histogram.nanos += shard.nanos[stage].load( std::memory_order_relaxed );
+    }
+  }
+
+
+  void subtract( Snapshot & totals, Snapshot const & baseline ) noexcept
+  {
+    for( std::size_t i = 0; i < ingestCounterCount; ++i )  totals.counters   [i] -= baseline.counters   [i];
+    for( std::size_t i = 0; i < parseStatusCount;   ++i )  totals.parseErrors[i] -= baseline.parseErrors[i];
+    for( std::size_t stage = 0; stage < ingestStageCount; ++stage )
+    {
+      for( std::size_t bucket = 0; bucket < LatencyHistogram::bucketCount; ++bucket )  totals.stages[stage].buckets[bucket] -= baseline.stages[stage].buckets[bucket];
+      totals.stages[stage].total -= baseline.stages[stage].total;
+      totals.stages[stage].nanos -= baseline.stages[stage].nanos;
+    }
+  }
+
+
+  // Every thread's shard.  A thread's totals move into retired when it ends.  reset() can't zero counters other threads own, so it
+  // remembers the totals at that moment in baseline instead, and snapshots report the difference.
+  struct Registry
+  {
+    std::mutex                            mutex;
+    std::vector<Shard *>                  live;
+    Snapshot                              retired;
+    Snapshot                              baseline;
+    std::chrono::steady_clock::time_point since = std::chrono::steady_clock::now();
+
+    Snapshot totals() const noexcept                                  // Call with mutex held
+    {
+      Snapshot result = retired;
+      for( auto shard : live )  accumulate( *shard, result );
+      return result;
+    }
+  };
+
+
+  Registry & registry()
+  {
+    static auto * instance = new Registry;                            // Never destroyed:  threads may still be ending after static destruction begins
+    return *instance;
+  }
+
+
+  struct LocalShard
+  {
+    Shard *                        shard  = new Shard;
+    std::atomic<std::uint64_t> * * cached = nullptr;                   // IngestMetrics::_counters once attached, cleared with the shard so it can't dangle
+
+    LocalShard()
+    {
+      std::lock_guard lock( registry().mutex );
+      registry().live.push_back( shard );
+    }
+
+   ~LocalShard() noexcept
+    {
+      auto &          shared = registry();
+      std::lock_guard lock( shared.mutex );
+      accumulate( *shard, shared.retired );
+      shared.live.erase( std::find( shared.live.begin(), shared.live.end(), shard ) );
+      if( cached != nullptr )  *cached = nullptr;
+      delete shard;
+    }
+  };
+
+
+  LocalShard & localShardOwner()
+  {
+    thread_local LocalShard local;
+    return local;
+  }
+
+
+  Shard & localShard()
+  { return *localShardOwner().shard; }
+
+
+
+
+  char const * statusName( ParseStatus status ) noexcept
+  {
+    switch( status )
+    {
+      case ParseStatus::ok:                return "ok";
+      case ParseStatus::endOfInput:        return "end_of_input";
+      case ParseStatus::truncatedRecord:   return "truncated_record";
+      case ParseStatus::unterminatedQuote: return "unterminated_quote";
+      case ParseStatus::badPrice:          return "bad_price";
+    }
+    return "unknown";
+  }
+
+  constexpr ParseStatus errorStatuses[] = { ParseStatus::truncatedRecord, ParseStatus::unterminatedQuote, ParseStatus::badPrice };
+
+  constexpr struct { char const * label;  char const * key;  double fraction; } quantiles[] = { { "0.5",   "p50_ns",  0.5   },   // Prometheus label, JSON key
+                                                                                             { "0.9",   "p90_ns",  0.9   },
+                                                                                             { "0.99",  "p99_ns",  0.99  },
+                                                                                             { "0.999", "p999_ns", 0.999 } };
+
+
+  // Shortest round-trip text, which is valid JSON and Prometheus alike
+  std::string number( double value )
+  {
+    char text[32];
+    return std::string( text, std::to_chars( text, text + sizeof text, value ).ptr );
+  }
+
+  std::string number( std::uint64_t value )
+  { return std::to_string( value ); }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Names
+*******************************************************************************/
+
+char const * name( IngestStage stage ) noexcept
+{
+  switch( stage )
+  {
+    case IngestStage::read:      return "read";
+    case IngestStage::fields:    return "fields";
+    case IngestStage::price:     return "price";
+    case IngestStage::construct: return "construct";
+    case IngestStage::format:    return "format";
+    case IngestStage::write:     return "write";
+  }
+  return "unknown";
+}
+
+
+char const * name( IngestCounter counter ) noexcept
+{
+  switch( counter )
+  {
+    case IngestCounter::recordsRead:    return "records_read";
+    case IngestCounter::bytesRead:      return "bytes_read";
+    case IngestCounter::recordsWritten: return "records_written";
+    case IngestCounter::bytesWritten:   return "bytes_written";
+    case IngestCounter::heapStrings:    return "heap_strings";
+  }
+  return "unknown";
+}
+
+
+
+
+/*******************************************************************************
+**  Latency histograms
+*******************************************************************************/
+
+std::size_t LatencyHistogram::bucketOf( std::uint64_t nanoseconds ) noexcept
+{
+  if( nanoseconds < 2 * subBuckets )  return static_cast<std::size_t>( nanoseconds );
+
+  // The top five bits, 1xxxx, pick one of 16 buckets within the value's power of two
+  auto shift = static_cast<std::size_t>( std::bit_width( nanoseconds ) ) - 5;
+  return shift * subBuckets + static_cast<std::size_t>( nanoseconds >> shift );
+}
+
+
+std::uint64_t LatencyHistogram::lowestIn( std::size_t bucket ) noexcept
+{
+  if( bucket < 2 * subBuckets )  return bucket;
+
+  auto shift = bucket / subBuckets - 1;
+  return std::uint64_t{ bucket % subBuckets + subBuckets } << shift;
+}
+
+
+std::uint64_t LatencyHistogram::highestIn( std::size_t bucket ) noexcept
+{
+  if( bucket < 2 * subBuckets )  return bucket;
+  return lowestIn( bucket ) + ( ( std::uint64_t{ 1 } << ( bucket / subBuckets - 1 ) ) - 1 );
+}
+
+
+void LatencyHistogram::record( std::uint64_t nanoseconds ) noexcept
+{
+  ++buckets[bucketOf( nanoseconds )];
+  ++total;
+  nanos += nanoseconds;
+}
+
+
+std::uint64_t LatencyHistogram::count() const noexcept
+{ return total; }
+
+
+std::uint64_t LatencyHistogram::sum() const noexcept
+{ return nanos; }
+
+
+std::uint64_t LatencyHistogram::max() const noexcept
+{
+  for( auto bucket = bucketCount; bucket-- > 0; )  if( buckets[bucket] != 0 )  return highestIn( bucket );
+  return 0;
+}
+
+
+std::uint64_t LatencyHistogram::percentile( double fraction ) const noexcept
+{
+  if( total == 0 )  return 0;
+
+  // The smallest value with at least fraction of the samples at or below it
+  auto          rank = static_cast<std::uint64_t>( fraction * static_cast<double>( total ) );
+  std::uint64_t seen = 0;
+  for( std::size_t bucket = 0; bucket < bucketCount; ++bucket )
+  {
+    seen += buckets[bucket];
+    if( seen > rank || seen == total )  return highestIn( bucket );
+  }
+  return max();
+}
+
+
+
+
+/*******************************************************************************
+**  Recording
+*******************************************************************************/
+
+std::atomic<std::uint64_t> * IngestMetrics::attach() noexcept
+{
+  auto & local  = localShardOwner();
+  local.cached  = &_counters;
+  return _counters = local.shard->counters.data();
+}
+
+
+void IngestMetrics::addParseError( ParseStatus status ) noexcept
+{ bump( localShard().parseErrors[static_cast<std::size_t>( status )], 1 ); }
+
+
+void IngestMetrics::addLatency( IngestStage stage, std::uint64_t nanoseconds ) noexcept
+{
+  auto & shard = localShard();
+  bump( shard.buckets[static_cast<std::size_t>( stage )][LatencyHistogram::bucketOf( nanoseconds )], 1 );
+  bump( shard.nanos  [static_cast<std::size_t>( stage )],                                          nanoseconds );
+}
+
+
+
+
+/*******************************************************************************
+**  Collection
+*******************************************************************************/
+
+IngestMetrics::Snapshot IngestMetrics::snapshot()
+{
+  auto &          shared = registry();
+  std::lock_guard lock( shared.mutex );
+
+  auto result = shared.totals();
+  subtract( result, shared.baseline );
+  result.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - shared.since ).count();
+  return result;
+}
+
+
+void IngestMetrics::reset()
+{
+  auto &          shared = registry();
+  std::lock_guard lock( shared.mutex );
+
+  shared.baseline = shared.totals();
+  shared.since    = std::chrono::steady_clock::now();
+}
+
+
+
+
+/*******************************************************************************
+**  Snapshots
+*******************************************************************************/
+
+std::uint64_t IngestMetrics::Snapshot::operator[]( IngestCounter counter ) const noexcept
+{ return counters[static_cast<std::size_t>( counter )]; }
+
+
+std::uint64_t IngestMetrics::Snapshot::operator[]( ParseStatus status ) const noexcept
+{ return parseErrors[static_cast<std::size_t>( status )]; }
+
+
+double IngestMetrics::Snapshot::perSecond( IngestCounter counter ) const noexcept
+{ return seconds > 0.0 ? static_cast<double>( ( *this )[counter] ) / seconds : 0.0; }
+
+
+std::string IngestMetrics::Snapshot::toJson() const
+{
+  std::string json = "{\n  \"enabled\": " + std::string( enabled ? "true" : "false" )
+                   + ",\n  \"seconds\": " + number( seconds )
+                   + ",\n  \"sample_interval\": " + number( std::uint64_t{ sampleInterval } );
+
+  json += ",\n  \"counters\": {";
+  for( std::size_t i = 0; i < ingestCounterCount; ++i )
+  {
+    auto counter = static_cast<IngestCounter>( i );
+    json += std::string( i == 0 ? "" : "," ) + "\n    \"" + name( counter ) + "\": { \"total\": " + number( ( *this )[counter] )
+          + ", \"per_second\": " + number( perSecond( counter ) ) + " }";
+  }
+
+  json += "\n  },\n  \"parse_errors\": {";
+  for( auto status : errorStatuses )
+  {
+    json += std::string( status == errorStatuses[0] ? "" : "," ) + "\n    \"" + statusName( status ) + "\": " + number( ( *this )[status] );
+  }
+
+  json += "\n  },\n  \"stages\": {";
+  for( std::size_t i = 0; i < ingestStageCount; ++i )
+  {
+    auto const & histogram = stages[i];
+    json += std::string( i == 0 ? "" : "," ) + "\n    \"" + name( static_cast<IngestStage>( i ) ) + "\": { \"samples\": " + number( histogram.count() )
+          + ", \"sum_ns\": " + number( histogram.sum() );
+    for( auto const & quantile : quantiles )  json += ", \"" + std::string( quantile.key ) + "\": " + number( histogram.percentile( quantile.fraction ) );
+    json += ", \"max_ns\": " + number( histogram.max() ) + " }";
+  }
+  json += "\n  }\n}\n";
+  return json;
+}
+
+
+std::string IngestMetrics::Snapshot::toPrometheus() const
+{
+  std::string text;
+  for( std::size_t i = 0; i < ingestCounterCount; ++i )
+  {
+    auto counter = static_cast<IngestCounter>( i );
+    auto metric  = std::string( "grocery_ingest_" ) + name( counter ) + "_total";
+    text += "# TYPE " + metric + " counter\n" + metric + ' ' + number( ( *this )[counter] ) + '\n';
+  }
+
+  text += "# HELP grocery_ingest_parse_errors_total Loads that stopped at a malformed record, by reason\n"
+          "# TYPE grocery_ingest_parse_errors_total counter\n";
+  for( auto status : errorStatuses )
+  {
+    text += "grocery_ingest_parse_errors_total{reason=\"" + std::string( statusName( status ) ) + "\"} " + number( ( *this )[status] ) + '\n';
+  }
+
+  text += "# HELP grocery_ingest_stage_seconds Time spent per call in each stage of reading and writing records (per-record stages sampled)\n"
+          "# TYPE grocery_ingest_stage_seconds summary\n";
+  for( std::size_t i = 0; i < ingestStageCount; ++i )
+  {
+    auto const & histogram = stages[i];
+    auto         stage     = std::string( "stage=\"" ) + name( static_cast<IngestStage>( i ) ) + '"';
+    for( auto const & quantile : quantiles )
+    {
+      text += "grocery_ingest_stage_seconds{" + stage + ",quantile=\"" + quantile.label + "\"} "
+            + number( static_cast<double>( histogram.percentile( quantile.fraction ) ) / 1e9 ) + '\n';
+    }
+    text += "grocery_ingest_stage_seconds_sum{"   + stage + "} " + number( static_cast<double>( histogram.sum() ) / 1e9 ) + '\n'
+          + "grocery_ingest_stage_seconds_count{" + stage + "} " + number( histogram.count() ) + '\n';
+  }
+  return text;
+}
@@ -0,0 +1,188 @@
+#pragma once                                                                  // include guard
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint32_t, uint64_t
+#include <string>
+
+#include "GroceryItemParser.hpp"                                              // ParseStatus
+
+
+// Build with -DGROCERY_INGEST_METRICS=1 (CMake:  -DGROCERY_INGEST_METRICS=ON) to turn the instrumentation on.  Off, every hook below
+// is an empty inline function the optimizer removes, so the load and export paths compile to exactly what they were without it.
+#ifndef GROCERY_INGEST_METRICS
+  #define GROCERY_INGEST_METRICS 0
+#endif
+
+
+
+
+// Where the time goes when reading and writing catalogs
+enum class IngestStage : unsigned char
+{
+  read,                                                                       // Waiting on input:  RecordSource's stream reads
+  fields,                                                                     // Finding the three quoted fields and their delimiters, escapes and all
+  price,                                                                      // Converting the price text to a double
+  construct,                                                                  // Building the GroceryItem:  unescaping the fields into strings
+  format,                                                                     // CatalogWriter formatting a record into its buffer
+  write                                                                       // CatalogWriter's write() and writev() calls
+};
+
+// Things counted
+enum class IngestCounter : unsigned char
+{
+  recordsRead,
+  bytesRead,                                                                  // Input text consumed, including whitespace
+  recordsWritten,
+  bytesWritten,
+  heapStrings                                                                 // Strings of constructed items too long for the small-string buffer, so held on the heap
+};
+
+inline constexpr std::size_t ingestStageCount   = 6;
+inline constexpr std::size_t ingestCounterCount = 5;
+inline constexpr std::size_t parseStatusCount   = 5;
+
+char const * name( IngestStage   stage   ) noexcept;                          // Ex: "fields"
+char const * name( IngestCounter counter ) noexcept;                          // Ex: "records_read"
+
+
+
+
+// Latencies in nanoseconds, bucketed the way HdrHistogram does:  exact below 32, then 16 buckets per power of two, so any value is
+// known to within 1/16 (6.25%) however large, in a fixed 7.5 KiB
+class LatencyHistogram
+{
+  public:
+    static constexpr std::size_t subBuckets  = 16;
+    static constexpr std::size_t bucketCount = ( 64 - 4 + 1 ) * subBuckets;
+
+    static std::size_t   bucketOf   ( std::uint64_t nanoseconds ) noexcept;
+    static std::uint64_t lowestIn   ( std::size_t bucket ) noexcept;          // The smallest value counted in bucket
+    static std::uint64_t highestIn  ( std::size_t bucket ) noexcept;          // The largest value counted in bucket
+
+    void          record    ( std::uint64_t nanoseconds ) noexcept;
+    std::uint64_t count     () const noexcept;
+    std::uint64_t sum       () const noexcept;                                // Nanoseconds, summed exactly
+    std::uint64_t max       () const noexcept;                                // Within the resolution above
+    std::uint64_t percentile( double fraction ) const noexcept;               // Ex: percentile( 0.99 ) for p99, within the resolution above.  0 when empty
+
+    std::array<std::uint64_t, bucketCount> buckets = {};
+    std::uint64_t                          total   = 0;                       // Samples recorded
+    std::uint64_t                          nanos   = 0;                       // Their sum
+};
+
+
+
+
+// Process-wide ingest metrics, gathered per thread without locks or shared cache lines and summed only when a snapshot is taken.
+//
+// Counters and parse errors are counted exactly.  Per-record stages are sampled:  a thread times one call in sampleInterval to each,
+// since reading the clock around every field of every record would cost more than parsing them.  The read and write stages, a system
+// call on a large buffer each, are timed on every call.  Parse errors are counted by ParseStatus where a load stops (loadCatalog(),
+// the parallel loaders, RecordSource), so a failed load says what went wrong even where operator>> would only set failbit.
+//
+//     IngestMetrics::reset();
+//     auto catalog = loadCatalogFile( path );
+//     std::cout << IngestMetrics::snapshot().toPrometheus();
+class IngestMetrics
+{
+  public:
+    static constexpr bool          enabled        = GROCERY_INGEST_METRICS != 0;
+    static constexpr std::uint32_t sampleInterval = 64;
+
+    struct Snapshot
+    {
+      std::array<std::uint64_t,    ingestCounterCount> counters    = {};
+      std::array<std::uint64_t,    parseStatusCount  > parseErrors = {};      // By ParseStatus.  ok and endOfInput stay 0
+      std::array<LatencyHistogram, ingestStageCount  > stages      = {};
+      double                                           seconds     = 0.0;     // Since the last reset(), or since the first thread recorded anything
+
+      std::uint64_t operator[]( IngestCounter counter ) const noexcept;
+      std::uint64_t operator[]( ParseStatus   status  ) const noexcept;
+      double        perSecond ( IngestCounter counter ) const noexcept;      // Ex: perSecond( IngestCounter::recordsRead )
+
+      std::string   toJson      () const;
+      std::string   toPrometheus() const;                                     // Text exposition format, metrics prefixed "grocery_ingest_"
+    };
+
+    // Hooks for the load and export paths.  No-ops unless enabled.
+    static void count     ( IngestCounter counter, std::uint64_t amount = 1 ) noexcept;
+    static void parseError( ParseStatus status ) noexcept;                    // ok and endOfInput aren't errors and are ignored
+    static void record    ( IngestStage stage, std::uint64_t nanoseconds ) noexcept;
+    static bool sample    ( IngestStage stage ) noexcept;                     // Whether to time this call:  true once per sampleInterval calls to stage on each thread
+
+    static Snapshot snapshot();                                               // Everything since the last reset(), across every thread, including those that have ended
+    static void     reset   ();                                               // Starts a new measurement window
+
+  private:
+    static std::atomic<std::uint64_t> * attach       () noexcept;             // This thread's counters, registering the thread on first use
+    static void                         addParseError( ParseStatus status ) noexcept;
+    static void                         addLatency   ( IngestStage stage, std::uint64_t nanoseconds ) noexcept;
+
+    static inline thread_local std::atomic<std::uint64_t> * _counters = nullptr;   // Cached, since count() is called once or more per record.  Cleared when the thread's counters are retired
+
+    static inline thread_local std::array<std::uint32_t, ingestStageCount> _sampleTicks = {};
+};
+
+
+
+
+// Times the enclosing scope into a stage's histogram:  every call, or only the sampled ones
+class IngestTimer
+{
+  public:
+    explicit IngestTimer( IngestStage stage, bool everyCall = false ) noexcept
+      : _stage( stage )
+    {
+      if constexpr( IngestMetrics::enabled )  if( everyCall || IngestMetrics::sample( stage ) )  _start = std::chrono::steady_clock::now();
+    }
+
+    IngestTimer            ( IngestTimer const & ) = delete;
+    IngestTimer & operator=( IngestTimer const & ) = delete;
+
+   ~IngestTimer() noexcept
+    {
+      if constexpr( IngestMetrics::enabled )
+      {
+        if( _start != std::chrono::steady_clock::time_point{} )
+        {
+          auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - _start );
+          IngestMetrics::record( _stage, static_cast<std::uint64_t>( elapsed.count() ) );
+        }
+      }
+    }
+
+  private:
+    IngestStage                           _stage;
+    std::chrono::steady_clock::time_point _start = {};
+};
+
+
+
+
+inline void IngestMetrics::count( IngestCounter counter, std::uint64_t amount ) noexcept
+{
+  if constexpr( enabled )
+  {
+    // Only this thread writes its counters, so no locked read-modify-write is needed
+    auto & total = ( _counters != nullptr ? _counters : attach() )[static_cast<std::size_t>( counter )];
+    total.store( total.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+  }
+}
+
+
+inline void IngestMetrics::parseError( ParseStatus status ) noexcept
+{ if constexpr( enabled )  if( status != ParseStatus::ok && status != ParseStatus::endOfInput )  addParseError( status ); }
+
+
+inline void IngestMetrics::record( IngestStage stage, std::uint64_t nanoseconds ) noexcept
+{ if constexpr( enabled )  addLatency( stage, nanoseconds ); }
+
+
+inline bool IngestMetrics::sample( IngestStage stage ) noexcept
+{
+  if constexpr( enabled )  return ++_sampleTicks[static_cast<std::size_t>( stage )] % sampleInterval == 0;
+  else                     return false;
+}
@@ -0,0 +1,239 @@
+#include <compare>                                                    // weak_ordering
+#include <iomanip>                                                    // quoted()
+#include <iostream>                                                   // istream, ostream
+#include <string>
+#include <string_view>
+#include <utility>                                                    // move()
+
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
+#include "GroceryItem.hpp"
+#include "InternedGroceryItem.hpp"
+#include "StringPool.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  StringPool::Symbol internBrand  ( std::string_view brandName   ) { return StringPool::brandNames  ().intern( brandName   ); }
+  StringPool::Symbol internProduct( std::string_view productName ) { return StringPool::productNames().intern( productName ); }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::BasicInternedGroceryItem( std::string      productName,
+                                                                       std::string_view brandName,
+                                                                       std::string      upcCode,
+                                                                       double           price )
+  : _upcCode  ( std::move( upcCode ) ),
+    _brandName( internBrand( brandName ) ),
+    _price    ( price )
+{
+  if constexpr( InternProductName )  _productName = internProduct( productName );
+  else                               _productName = std::move( productName );
+}
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::BasicInternedGroceryItem( GroceryItem const & groceryItem )
+  : BasicInternedGroceryItem( groceryItem.productName(), groceryItem.brandName(), groceryItem.upcCode(), groceryItem.price() )
+{}
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::operator GroceryItem() const
+{ return GroceryItem( productName(), brandName(), _upcCode, _price ); }
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::BasicInternedGroceryItem( BasicInternedGroceryItem const & other )      = default;
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::BasicInternedGroceryItem( BasicInternedGroceryItem && other ) noexcept  = default;
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName>::~BasicInternedGroceryItem() noexcept                                   = default;
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::operator=( BasicInternedGroceryItem const & rhs ) &     = default;
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::operator=( BasicInternedGroceryItem && rhs ) & noexcept = default;
+
+
+
+
+/*******************************************************************************
+**  Accessors
+*******************************************************************************/
+
+template< bool InternProductName >
+std::string const & BasicInternedGroceryItem<InternProductName>::upcCode() const &
+{ return _upcCode; }
+
+
+template< bool InternProductName >
+std::string const & BasicInternedGroceryItem<InternProductName>::brandName() const &
+{ return StringPool::brandNames().text( _brandName ); }
+
+
+template< bool InternProductName >
+std::string const & BasicInternedGroceryItem<InternProductName>::productName() const &
+{
+  if constexpr( InternProductName )  return StringPool::productNames().text( _productName );
+  else                               return _productName;
+}
+
+
+template< bool InternProductName >
+double BasicInternedGroceryItem<InternProductName>::price() const &
+{ return _price; }
+
+
+template< bool InternProductName >
+std::string BasicInternedGroceryItem<InternProductName>::upcCode() &&
+{ return std::move( _upcCode ); }
+
+
+template< bool InternProductName >
+std::string BasicInternedGroceryItem<InternProductName>::brandName() &&
+{ return StringPool::brandNames().text( _brandName ); }
+
+
+template< bool InternProductName >
+std::string BasicInternedGroceryItem<InternProductName>::productName() &&
+{
+  if constexpr( InternProductName )  return StringPool::productNames().text( _productName );
+  else                               return std::move( _productName );
+}
+
+
+template< bool InternProductName >
+StringPool::Symbol BasicInternedGroceryItem<InternProductName>::brandSymbol() const noexcept
+{ return _brandName; }
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::upcCode( std::string newUpcCode ) &
+{
+  _upcCode = std::move( newUpcCode );
+  return *this;
+}
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::brandName( std::string_view newBrandName ) &
+{
+  _brandName = internBrand( newBrandName );
+  return *this;
+}
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::productName( std::string newProductName ) &
+{
+  if constexpr( InternProductName )  _productName = internProduct( newProductName );
+  else                               _productName = std::move( newProductName );
+  return *this;
+}
+
+
+template< bool InternProductName >
+BasicInternedGroceryItem<InternProductName> & BasicInternedGroceryItem<InternProductName>::price( double newPrice ) &
+{
+  _price = newPrice;
+  return *this;
+}
+
+
+
+
+/*******************************************************************************
+**  Relational Operators
+*******************************************************************************/
+
+// Same ordering as GroceryItem:  UPC code, product name, brand name, then price (within epsilon)
+template< bool InternProductName >
+std::weak_ordering BasicInternedGroceryItem<InternProductName>::operator<=>( BasicInternedGroceryItem const & rhs ) const noexcept
+{
+  if( auto cmp = _upcCode <=> rhs._upcCode;  cmp != 0 )  return cmp;
+
+  if constexpr( InternProductName )
+  {
+    if( _productName != rhs._productName )
+      if( auto cmp = productName() <=> rhs.productName();  cmp != 0 )  return cmp;
+  }
+  else if( auto cmp = _productName <=> rhs._productName;  cmp != 0 )  return cmp;
+
+  if( _brandName != rhs._brandName )                                  // Same symbol means same text - skip the string comparison
+    if( auto cmp = brandName() <=> rhs.brandName();  cmp != 0 )  return cmp;
+
+  if( floating_point_is_equal( _price, rhs._price ) )  return std::weak_ordering::equivalent;
+  return ( _price < rhs._price ) ? std::weak_ordering::less : std::weak_ordering::greater;
+}
+
+
+template< bool InternProductName >
+bool BasicInternedGroceryItem<InternProductName>::operator==( BasicInternedGroceryItem const & rhs ) const noexcept
+{
+  // Within a pool equal text means equal symbols, so the interned names compare as integers
+  return  floating_point_is_equal( _price, rhs._price )
+       && _brandName   == rhs._brandName
+       && _upcCode     == rhs._upcCode
+       && _productName == rhs._productName;
+}
+
+
+
+
+/*******************************************************************************
+**  Insertion and Extraction Operators
+*******************************************************************************/
+
+template< bool InternProductName >
+std::ostream & operator<<( std::ostream & stream, BasicInternedGroceryItem<InternProductName> const & groceryItem )
+{
+  return stream << std::quoted( groceryItem.upcCode()     ) << ", "
+                << std::quoted( groceryItem.brandName()   ) << ", "
+                << std::quoted( groceryItem.productName() ) << ", "
+                << groceryItem.price();
+}
+
+
+template< bool InternProductName >
+std::istream & operator>>( std::istream & stream, BasicInternedGroceryItem<InternProductName> & groceryItem )
+{
+  // Reads exactly what GroceryItem reads, and like GroceryItem leaves groceryItem untouched if the read fails
+  GroceryItem item;
+  if( stream >> item )  groceryItem = BasicInternedGroceryItem<InternProductName>( item );
+  return stream;
+}
+
+
+
+
+/*******************************************************************************
+**  Explicit instantiations
+*******************************************************************************/
+
+template class BasicInternedGroceryItem<false>;
+template class BasicInternedGroceryItem<true>;
+
+template std::ostream & operator<<( std::ostream &, BasicInternedGroceryItem<false> const & );
+template std::ostream & operator<<( std::ostream &, BasicInternedGroceryItem<true > const & );
+template std::istream & operator>>( std::istream &, BasicInternedGroceryItem<false>       & );
+template std::istream & operator>>( std::istream &, BasicInternedGroceryItem<true >       & );
@@ -0,0 +1,88 @@
+#pragma once                                                                  // include guard
+
+#include <compare>                                                            // std::weak_ordering
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>                                                        // conditional_t
+
+#include "GroceryItem.hpp"
+#include "StringPool.hpp"
+
+
+
+
+// A GroceryItem whose brand name (and, optionally, product name) is interned in a process-wide StringPool.  Items hold a 4-byte
+// Symbol instead of a std::string, so a brand repeated across millions of items is stored once.  The public interface, ordering, and
+// text form are the same as GroceryItem's, and conversions both ways are lossless.
+//
+// Interning the product name only pays off when product names repeat, so it's opt-in:
+//     InternedGroceryItem       - brand name interned
+//     FullyInternedGroceryItem  - brand and product names interned
+template< bool InternProductName >
+class BasicInternedGroceryItem
+{
+  public:
+    // Constructors, assignments, and destructor
+    BasicInternedGroceryItem( std::string      productName = {},
+                              std::string_view brandName   = {},
+                              std::string      upcCode     = {},
+                              double           price       = 0.0 );
+    explicit BasicInternedGroceryItem( GroceryItem const & groceryItem );     // Conversions to and from GroceryItem are lossless
+    explicit operator GroceryItem() const;
+
+    BasicInternedGroceryItem & operator=( BasicInternedGroceryItem const  & rhs   ) &;
+    BasicInternedGroceryItem & operator=( BasicInternedGroceryItem       && rhs   ) & noexcept;
+    BasicInternedGroceryItem            ( BasicInternedGroceryItem const  & other );
+    BasicInternedGroceryItem            ( BasicInternedGroceryItem       && other )   noexcept;
+   ~BasicInternedGroceryItem            (                                         )   noexcept;
+
+
+    // Accessors
+    std::string const & upcCode    () const &;                                // Interned names are returned by reference to the pooled string
+    std::string const & brandName  () const &;
+    std::string const & productName() const &;
+    double              price      () const &;
+
+    std::string         upcCode    ()       &&;
+    std::string         brandName  ()       &&;                               // Pooled strings are shared, so r-values return a copy rather than a moved-from pool entry
+    std::string         productName()       &&;
+
+    StringPool::Symbol  brandSymbol() const noexcept;                         // Equal brand names always have equal symbols
+
+
+    // Modifiers
+    BasicInternedGroceryItem & upcCode    ( std::string      newUpcCode     ) &;
+    BasicInternedGroceryItem & brandName  ( std::string_view newBrandName   ) &;
+    BasicInternedGroceryItem & productName( std::string      newProductName ) &;
+    BasicInternedGroceryItem & price      ( double           newPrice       ) &;
+
+
+    // Relational Operators
+    std::weak_ordering operator<=>( BasicInternedGroceryItem const & rhs ) const noexcept;
+    bool               operator== ( BasicInternedGroceryItem const & rhs ) const noexcept;
+
+  private:
+    using ProductName = std::conditional_t<InternProductName, StringPool::Symbol, std::string>;
+
+    std::string        _upcCode;
+    ProductName        _productName{};
+    StringPool::Symbol _brandName{};
+    double             _price{ 0.0 };
+};
+
+
+// Insertion and Extraction Operators - the same text form GroceryItem reads and writes
+template< bool InternProductName >  std::ostream & operator<<( std::ostream & stream, BasicInternedGroceryItem<InternProductName> const & groceryItem );
+template< bool InternProductName >  std::istream & operator>>( std::istream & stream, BasicInternedGroceryItem<InternProductName>       & groceryItem );
+
+
+using InternedGroceryItem      = BasicInternedGroceryItem<false>;
+using FullyInternedGroceryItem = BasicInternedGroceryItem<true>;
+
+extern template class BasicInternedGroceryItem<false>;                        // Both variants are instantiated once, in InternedGroceryItem.cpp
+extern template class BasicInternedGroceryItem<true>;
+extern template std::ostream & operator<<( std::ostream &, BasicInternedGroceryItem<false> const & );
+extern template std::ostream & operator<<( std::ostream &, BasicInternedGroceryItem<true > const & );
+extern template std::istream & operator>>( std::istream &, BasicInternedGroceryItem<false>       & );
+extern template std::istream & operator>>( std::istream &, BasicInternedGroceryItem<true >       & );
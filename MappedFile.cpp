@@ -0,0 +1,90 @@
+#include <cerrno>                                                     // errno
+#include <filesystem>                                                 // path
+#include <string_view>
+#include <system_error>                                               // system_error, generic_category()
+#include <utility>                                                    // exchange()
+
+#include <fcntl.h>                                                    // open()
+#include <sys/mman.h>                                                 // mmap(), munmap(), madvise()
+#include <sys/stat.h>                                                 // fstat()
+#include <unistd.h>                                                   // close()
+
+#include "MappedFile.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+
+MappedFile::MappedFile( std::filesystem::path const & path, Access access )
+{
+  int fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+  if( fd < 0 )  throw std::system_error( errno, std::generic_category(), "MappedFile: cannot open " + path.string() );
+
+  struct stat status{};
+  if( ::fstat( fd, &status ) != 0 )
+  {
+    int error = errno;
+    ::close( fd );
+    throw std::system_error( error, std::generic_category(), "MappedFile: cannot stat " + path.string() );
+  }
+
+  _size = static_cast<std::size_t>( status.st_size );
+  if( _size != 0 )
+  {
+    void * address = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if( address == MAP_FAILED )
+    {
+      int error = errno;
+      ::close( fd );
+      throw std::system_error( error, std::generic_category(), "MappedFile: cannot map " + path.string() );
+    }
+    _address = address;
+    ::madvise( _address, _size, access == Access::sequential ? MADV_SEQUENTIAL : MADV_RANDOM );   // Only a hint, failure is harmless
+  }
+
+  ::close( fd );                                                      // The mapping keeps its own reference to the file
+}
+
+
+MappedFile::MappedFile( MappedFile && other ) noexcept
+  : _address( std::exchange( other._address, nullptr ) ),
+    _size   ( std::exchange( other._size,    0       ) )
+{}
+
+
+MappedFile & MappedFile::operator=( MappedFile && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    if( _address != nullptr )  ::munmap( _address, _size );
+    _address = std::exchange( rhs._address, nullptr );
+    _size    = std::exchange( rhs._size,    0       );
+  }
+  return *this;
+}
+
+
+MappedFile::~MappedFile() noexcept
+{
+  if( _address != nullptr )  ::munmap( _address, _size );
+}
+
+
+
+
+/*******************************************************************************
+**  Accessors
+*******************************************************************************/
+
+char const * MappedFile::data() const noexcept
+{ return static_cast<char const *>( _address ); }
+
+
+std::size_t MappedFile::size() const noexcept
+{ return _size; }
+
+
+std::string_view MappedFile::view() const noexcept
+{ return _size == 0 ? std::string_view{} : std::string_view{ data(), _size }; }
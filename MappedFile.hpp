@@ -0,0 +1,32 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <filesystem>                                                         // path
+#include <string_view>
+
+
+
+
+// A read-only, memory-mapped view of an entire file.  The mapping lives exactly as long as the MappedFile object, so views handed
+// out by view() must not outlive it.  Construction throws std::system_error if the file cannot be opened or mapped.
+class MappedFile
+{
+  public:
+    enum class Access { sequential, random };                                 // Hint passed on to the kernel (madvise) about how the pages will be touched
+
+    explicit MappedFile( std::filesystem::path const & path, Access access = Access::sequential );
+
+    MappedFile & operator=( MappedFile const  & rhs   ) = delete;             // A mapping has a single owner:  move only
+    MappedFile & operator=( MappedFile       && rhs   ) noexcept;
+    MappedFile            ( MappedFile const  & other ) = delete;
+    MappedFile            ( MappedFile       && other ) noexcept;
+   ~MappedFile            (                           ) noexcept;
+
+    char const *     data() const noexcept;
+    std::size_t      size() const noexcept;
+    std::string_view view() const noexcept;
+
+  private:
+    void *      _address = nullptr;                                           // nullptr for empty files (a zero-length mapping is not allowed)
+    std::size_t _size    = 0;
+};
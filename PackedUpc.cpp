@@ -0,0 +1,87 @@
+#include <array>
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "PackedUpc.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // placeValue[i] is the weight of the code's i-th character:  11^(maxLength-1-i)
+  constexpr auto placeValue = []
+  {
+    std::array<std::uint64_t, PackedUpc::maxLength> weights{};
+    std::uint64_t weight = 1;
+    for( std::size_t i = PackedUpc::maxLength; i-- > 0; )
+    {
+      weights[i] = weight;
+      weight    *= 11;
+    }
+    return weights;
+  }();
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Constructors and conversions
+*******************************************************************************/
+
+PackedUpc::PackedUpc( std::uint64_t value ) noexcept
+  : _value( value )
+{}
+
+
+std::optional<PackedUpc> PackedUpc::pack( std::string_view upcCode ) noexcept
+{
+  if( upcCode.size() > maxLength )  return std::nullopt;
+
+  std::uint64_t value = 0;
+  for( std::size_t i = 0; i < upcCode.size(); ++i )
+  {
+    unsigned digit = static_cast<unsigned char>( upcCode[i] ) - '0';
+    if( digit > 9 )  return std::nullopt;
+    value += ( digit + 1 ) * placeValue[i];
+  }
+  return PackedUpc( value );
+}
+
+
+std::string PackedUpc::unpack() const
+{
+  std::string   upcCode;
+  std::uint64_t rest = _value;
+  for( std::size_t i = 0; i < maxLength && rest != 0; ++i )
+  {
+    auto symbol = rest / placeValue[i];                               // 1 ... 10, never 0 inside the code
+    upcCode    += static_cast<char>( '0' + symbol - 1 );
+    rest       -= symbol * placeValue[i];
+  }
+  return upcCode;
+}
+
+
+
+
+/*******************************************************************************
+**  Accessors
+*******************************************************************************/
+
+std::size_t PackedUpc::length() const noexcept
+{
+  std::size_t length = 0;
+  while( length < maxLength && _value % ( placeValue[length] * 11 ) != 0 )  ++length;   // Trailing (unused) positions are all zero
+  return length;
+}
+
+
+std::uint64_t PackedUpc::value() const noexcept
+{ return _value; }
@@ -0,0 +1,38 @@
+#pragma once                                                                  // include guard
+
+#include <compare>                                                            // strong_ordering
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint64_t
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+
+
+// A decimal UPC code of up to 18 digits packed losslessly into 64 bits.  Leading zeros and the code's length are preserved, and
+// packed codes order exactly like the strings they came from ("0123" < "01230" < "0124" < "1"), so integer comparisons can stand
+// in for string comparisons.
+//
+// Encoding:  each digit d becomes d+1 and positions past the end of the code become 0, giving an 18-digit base-11 number.  A shorter
+// code then compares less than any longer code it prefixes, just as std::string comparison requires.  11^18 < 2^63.
+class PackedUpc
+{
+  public:
+    static constexpr std::size_t maxLength = 18;
+
+    static std::optional<PackedUpc> pack( std::string_view upcCode ) noexcept; // Empty unless upcCode is 0 to maxLength decimal digits
+
+    PackedUpc() noexcept = default;                                           // The empty code
+    std::string   unpack() const;
+    std::size_t   length() const noexcept;
+    std::uint64_t value () const noexcept;                                    // The packed representation (Ex: as a sort or hash key)
+
+    friend constexpr std::strong_ordering operator<=>( PackedUpc, PackedUpc ) noexcept = default;
+    friend constexpr bool                 operator== ( PackedUpc, PackedUpc ) noexcept = default;
+
+  private:
+    explicit PackedUpc( std::uint64_t value ) noexcept;
+
+    std::uint64_t _value = 0;
+};
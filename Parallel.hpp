@@ -0,0 +1,50 @@
+#pragma once                                                                  // include guard
+
+#include <algorithm>                                                          // min()
+#include <atomic>
+#include <cstddef>                                                            // size_t
+#include <exception>                                                          // exception_ptr, current_exception(), rethrow_exception()
+#include <mutex>
+#include <thread>                                                             // jthread, hardware_concurrency()
+#include <vector>
+
+
+
+
+// Runs task(0) ... task(taskCount-1) on up to threadCount threads (the calling thread included), each thread pulling the next task
+// index as soon as it finishes its previous one.  The first exception thrown by a task is rethrown once all threads finish.
+template< typename Task >
+void runInParallel( unsigned threadCount, std::size_t taskCount, Task task )
+{
+  std::atomic<std::size_t> next{ 0 };
+  std::exception_ptr       failure;
+  std::mutex               failureMutex;
+
+  auto worker = [&]
+  {
+    try
+    {
+      for( std::size_t i;  ( i = next.fetch_add( 1, std::memory_order_relaxed ) ) < taskCount; )  task( i );
+    }
+    catch( ... )
+    {
+      std::scoped_lock lock( failureMutex );
+      if( !failure )  failure = std::current_exception();
+      next = taskCount;                                                       // Stop handing out work
+    }
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    auto helpers = std::min<std::size_t>( threadCount, taskCount );
+    for( std::size_t t = 1;  t < helpers;  ++t )  threads.emplace_back( worker );
+    worker();
+  }                                                                           // jthreads join here
+
+  if( failure )  std::rethrow_exception( failure );
+}
+
+
+// The thread count to use when the caller asks for 0, meaning "one per hardware thread"
+inline unsigned resolveThreadCount( unsigned threadCount ) noexcept
+{ return threadCount != 0 ? threadCount : std::max( 1U, std::thread::hardware_concurrency() ); }
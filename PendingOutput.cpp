@@ -0,0 +1,47 @@
+#include <atomic>
+#include <filesystem>                                                 // path, rename(), remove()
+#include <string>                                                     // to_string()
+#include <system_error>                                               // error_code
+#include <utility>                                                    // move()
+
+#include <unistd.h>                                                   // getpid()
+
+#include "PendingOutput.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors and destructor
+*******************************************************************************/
+
+PendingOutput::PendingOutput( std::filesystem::path output )
+  : _output( std::move( output ) )
+{
+  static std::atomic<unsigned> instance{ 0 };
+  _path = _output;
+  _path.replace_filename( '.' + _output.filename().string() + ".partial-" + std::to_string( ::getpid() ) + '-' + std::to_string( instance++ ) );
+}
+
+
+PendingOutput::~PendingOutput() noexcept
+{
+  std::error_code ignored;
+  if( !_committed )  std::filesystem::remove( _path, ignored );
+}
+
+
+
+
+/*******************************************************************************
+**  Queries and modifiers
+*******************************************************************************/
+
+std::filesystem::path const & PendingOutput::path() const noexcept
+{ return _path; }
+
+
+void PendingOutput::commit()
+{
+  std::filesystem::rename( _path, _output );
+  _committed = true;
+}
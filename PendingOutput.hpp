@@ -0,0 +1,34 @@
+#pragma once                                                                  // include guard
+
+#include <filesystem>                                                         // path
+
+
+
+
+// An output file written under a temporary name beside it (in the same directory, so on the same file system) and renamed over it
+// only once complete, so a write that fails part way leaves any previous file as it was, and readers that have it open or mapped
+// never see it truncated or half written.  The temporary is removed on destruction unless commit() was called.
+//
+//     PendingOutput pending( path );
+//     {
+//       std::ofstream file( pending.path() );
+//       ...
+//     }
+//     pending.commit();
+class PendingOutput
+{
+  public:
+    explicit PendingOutput( std::filesystem::path output );
+
+    PendingOutput            ( PendingOutput const & ) = delete;
+    PendingOutput & operator=( PendingOutput const & ) = delete;
+   ~PendingOutput            (                       ) noexcept;
+
+    std::filesystem::path const & path  () const noexcept;                    // Where to write:  a hidden file beside the output
+    void                          commit();                                   // Renames path() over the output.  The file must be closed.  Throws std::filesystem::filesystem_error
+
+  private:
+    std::filesystem::path _output;
+    std::filesystem::path _path;
+    bool                  _committed = false;
+};
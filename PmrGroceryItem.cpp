@@ -0,0 +1,253 @@
+#include <algorithm>                                                  // count()
+#include <compare>                                                    // weak_ordering
+#include <cstddef>                                                    // size_t
+#include <iomanip>                                                    // quoted()
+#include <iostream>                                                   // istream, ostream
+#include <memory_resource>                                            // polymorphic_allocator, pmr::string, pmr::vector
+#include <string>
+#include <string_view>
+#include <utility>                                                    // move()
+
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "PmrGroceryItem.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+
+PmrGroceryItem::PmrGroceryItem() noexcept
+  : PmrGroceryItem( allocator_type{} )
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( allocator_type allocator ) noexcept
+  : _upcCode    ( allocator ),
+    _brandName  ( allocator ),
+    _productName( allocator )
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( std::string_view productName,
+                                std::string_view brandName,
+                                std::string_view upcCode,
+                                double           price,
+                                allocator_type   allocator )
+  : _upcCode    ( upcCode,     allocator ),
+    _brandName  ( brandName,   allocator ),
+    _productName( productName, allocator ),
+    _price      ( price                  )
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( GroceryItem const & groceryItem, allocator_type allocator )
+  : PmrGroceryItem( groceryItem.productName(), groceryItem.brandName(), groceryItem.upcCode(), groceryItem.price(), allocator )
+{}
+
+
+PmrGroceryItem::operator GroceryItem() const
+{ return GroceryItem( std::string( _productName ), std::string( _brandName ), std::string( _upcCode ), _price ); }
+
+
+PmrGroceryItem::PmrGroceryItem( PmrGroceryItem const & other )
+  : PmrGroceryItem( other, allocator_type{} )                         // Not other's resource:  the same rule std::pmr containers follow
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( PmrGroceryItem const & other, allocator_type allocator )
+  : _upcCode    ( other._upcCode,     allocator ),
+    _brandName  ( other._brandName,   allocator ),
+    _productName( other._productName, allocator ),
+    _price      ( other._price                  )
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( PmrGroceryItem && other ) noexcept
+  : _upcCode    ( std::move( other._upcCode     ) ),
+    _brandName  ( std::move( other._brandName   ) ),
+    _productName( std::move( other._productName ) ),
+    _price      ( other._price                    )
+{}
+
+
+PmrGroceryItem::PmrGroceryItem( PmrGroceryItem && other, allocator_type allocator )
+  : _upcCode    ( std::move( other._upcCode     ), allocator ),       // Steals the buffer when the resources are equal, copies when not
+    _brandName  ( std::move( other._brandName   ), allocator ),
+    _productName( std::move( other._productName ), allocator ),
+    _price      ( other._price                               )
+{}
+
+
+// polymorphic_allocator never propagates on assignment, so the strings assigned below keep this item's resource
+PmrGroceryItem & PmrGroceryItem::operator=( PmrGroceryItem const & rhs ) &
+{
+  if( this != &rhs )
+  {
+    _upcCode     = rhs._upcCode;
+    _brandName   = rhs._brandName;
+    _productName = rhs._productName;
+    _price       = rhs._price;
+  }
+  return *this;
+}
+
+
+PmrGroceryItem & PmrGroceryItem::operator=( PmrGroceryItem && rhs ) &
+{
+  if( this != &rhs )
+  {
+    _upcCode     = std::move( rhs._upcCode     );
+    _brandName   = std::move( rhs._brandName   );
+    _productName = std::move( rhs._productName );
+    _price       = rhs._price;
+  }
+  return *this;
+}
+
+
+PmrGroceryItem::~PmrGroceryItem() noexcept
+{}
+
+
+PmrGroceryItem::allocator_type PmrGroceryItem::get_allocator() const noexcept
+{ return _upcCode.get_allocator(); }
+
+
+
+
+/*******************************************************************************
+**  Accessors
+*******************************************************************************/
+
+std::pmr::string const & PmrGroceryItem::upcCode    () const & { return _upcCode;     }
+std::pmr::string const & PmrGroceryItem::brandName  () const & { return _brandName;   }
+std::pmr::string const & PmrGroceryItem::productName() const & { return _productName; }
+double                   PmrGroceryItem::price      () const & { return _price;       }
+
+std::pmr::string         PmrGroceryItem::upcCode    ()       && { return std::move( _upcCode     ); }
+std::pmr::string         PmrGroceryItem::brandName  ()       && { return std::move( _brandName   ); }
+std::pmr::string         PmrGroceryItem::productName()       && { return std::move( _productName ); }
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+
+PmrGroceryItem & PmrGroceryItem::upcCode( std::string_view newUpcCode ) &
+{
+  _upcCode = newUpcCode;
+  return *this;
+}
+
+
+PmrGroceryItem & PmrGroceryItem::brandName( std::string_view newBrandName ) &
+{
+  _brandName = newBrandName;
+  return *this;
+}
+
+
+PmrGroceryItem & PmrGroceryItem::productName( std::string_view newProductName ) &
+{
+  _productName = newProductName;
+  return *this;
+}
+
+
+PmrGroceryItem & PmrGroceryItem::price( double newPrice ) &
+{
+  _price = newPrice;
+  return *this;
+}
+
+
+
+
+/*******************************************************************************
+**  Relational Operators
+*******************************************************************************/
+
+// Same ordering as GroceryItem:  UPC code, product name, brand name, then price (within epsilon)
+std::weak_ordering PmrGroceryItem::operator<=>( PmrGroceryItem const & rhs ) const noexcept
+{
+  if( auto cmp = _upcCode     <=> rhs._upcCode;      cmp != 0 )  return cmp;
+  if( auto cmp = _productName <=> rhs._productName;  cmp != 0 )  return cmp;
+  if( auto cmp = _brandName   <=> rhs._brandName;    cmp != 0 )  return cmp;
+
+  if( floating_point_is_equal( _price, rhs._price ) )  return std::weak_ordering::equivalent;
+  return ( _price < rhs._price ) ? std::weak_ordering::less : std::weak_ordering::greater;
+}
+
+
+bool PmrGroceryItem::operator==( PmrGroceryItem const & rhs ) const noexcept
+{
+  return  floating_point_is_equal( _price, rhs._price )
+       && _upcCode     == rhs._upcCode
+       && _brandName   == rhs._brandName
+       && _productName == rhs._productName;
+}
+
+
+
+
+/*******************************************************************************
+**  Insertion and Extraction Operators
+*******************************************************************************/
+
+std::ostream & operator<<( std::ostream & stream, PmrGroceryItem const & groceryItem )
+{
+  return stream << std::quoted( std::string_view( groceryItem.upcCode()     ) ) << ", "
+                << std::quoted( std::string_view( groceryItem.brandName()   ) ) << ", "
+                << std::quoted( std::string_view( groceryItem.productName() ) ) << ", "
+                << groceryItem.price();
+}
+
+
+std::istream & operator>>( std::istream & stream, PmrGroceryItem & groceryItem )
+{
+  // Reads exactly what GroceryItem reads, and like GroceryItem leaves groceryItem untouched if the read fails
+  GroceryItem item;
+  if( stream >> item )  groceryItem = PmrGroceryItem( item, groceryItem.get_allocator() );
+  return stream;
+}
+
+
+
+
+/*******************************************************************************
+**  Bulk loading
+*******************************************************************************/
+
+ParseStatus appendCatalogText( std::pmr::vector<PmrGroceryItem> & items, std::string_view text )
+{
+  char const * cursor = text.data();
+  char const * end    = cursor + text.size();
+
+  // Escaped fields are unescaped into these, which keep their capacity from record to record; all other fields go straight from
+  // the text into the items' resource
+  std::string upcCode, brandName, productName;
+  auto value = []( FieldView const & field, std::string & scratch ) -> std::string_view
+  {
+    if( !field.escaped )  return field.text;
+    unescape( field, scratch );
+    return scratch;
+  };
+
+  // One record per line, as in loadCatalog().  Growing by doubling would matter even more here:  a monotonic resource never reuses
+  // the blocks a vector grows out of
+  items.reserve( items.size() + static_cast<std::size_t>( std::count( cursor, end, '\n' ) ) + 1 );
+
+  RecordView  record;
+  ParseStatus status;
+  while( ( status = parseRecord( cursor, end, record ) ) == ParseStatus::ok )
+  {
+    // emplace_back passes the vector's allocator on to the item (uses-allocator construction)
+    items.emplace_back( value( record.productName, productName ), value( record.brandName, brandName ), value( record.upcCode, upcCode ), record.price );
+  }
+  return status;
+}
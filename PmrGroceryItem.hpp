@@ -0,0 +1,97 @@
+#pragma once                                                                  // include guard
+
+#include <compare>                                                            // std::weak_ordering
+#include <iostream>
+#include <memory_resource>                                                    // polymorphic_allocator, pmr::string, pmr::vector
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+
+
+
+
+// A GroceryItem whose strings come from a std::pmr::memory_resource.  Load a whole catalog into a std::pmr::vector backed by a
+// std::pmr::monotonic_buffer_resource and every string (and the vector itself) is carved out of a few large blocks, then freed in
+// one step when the resource goes away, instead of up to three malloc/free pairs per item.
+//
+// The type is allocator-aware in the standard way (allocator_type, plus an allocator-extended form of every constructor), so pmr
+// containers hand it their memory resource automatically:
+//   o)  construction uses the allocator passed in, or the default resource if none is
+//   o)  copy construction, like std::pmr::string's, uses the default resource, not the source's
+//   o)  move construction keeps the source's resource; the allocator-extended move moves when the resources are equal and copies when
+//       they aren't
+//   o)  assignment never changes an item's resource.  That's why move assignment isn't noexcept:  between items from different
+//       resources it has to copy
+//
+// Strings are taken as std::string_view, so nothing is allocated except the item's own strings, straight from its resource.  The
+// public interface, ordering, and text form are otherwise the same as GroceryItem's.
+class PmrGroceryItem
+{
+  public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    // Constructors, assignments, and destructor
+    PmrGroceryItem() noexcept;
+    explicit PmrGroceryItem( allocator_type allocator ) noexcept;
+    PmrGroceryItem( std::string_view productName,
+                    std::string_view brandName = {},
+                    std::string_view upcCode   = {},
+                    double           price     = 0.0,
+                    allocator_type   allocator = {} );
+    explicit PmrGroceryItem( GroceryItem const & groceryItem, allocator_type allocator = {} );   // Conversions to and from GroceryItem are lossless
+    explicit operator GroceryItem() const;
+
+    PmrGroceryItem & operator=( PmrGroceryItem const  & rhs   ) &;
+    PmrGroceryItem & operator=( PmrGroceryItem       && rhs   ) &;                                  // Moves when both use the same resource, otherwise copies
+    PmrGroceryItem            ( PmrGroceryItem const  & other );                                    // Uses the default resource
+    PmrGroceryItem            ( PmrGroceryItem const  & other, allocator_type allocator );
+    PmrGroceryItem            ( PmrGroceryItem       && other )   noexcept;                         // Keeps other's resource
+    PmrGroceryItem            ( PmrGroceryItem       && other, allocator_type allocator );
+   ~PmrGroceryItem            (                               )   noexcept;
+
+    allocator_type get_allocator() const noexcept;
+
+
+    // Accessors
+    std::pmr::string const & upcCode    () const &;
+    std::pmr::string const & brandName  () const &;
+    std::pmr::string const & productName() const &;
+    double                   price      () const &;
+
+    std::pmr::string         upcCode    ()       &&;                          // Moved out, still using this item's resource
+    std::pmr::string         brandName  ()       &&;
+    std::pmr::string         productName()       &&;
+
+
+    // Modifiers
+    PmrGroceryItem & upcCode    ( std::string_view newUpcCode     ) &;
+    PmrGroceryItem & brandName  ( std::string_view newBrandName   ) &;
+    PmrGroceryItem & productName( std::string_view newProductName ) &;
+    PmrGroceryItem & price      ( double           newPrice       ) &;
+
+
+    // Relational Operators
+    std::weak_ordering operator<=>( PmrGroceryItem const & rhs ) const noexcept;   // Same ordering and equality as GroceryItem
+    bool               operator== ( PmrGroceryItem const & rhs ) const noexcept;
+
+  private:
+    std::pmr::string _upcCode;
+    std::pmr::string _brandName;
+    std::pmr::string _productName;
+    double           _price{ 0.0 };
+};
+
+
+// Insertion and Extraction Operators - the same text form GroceryItem reads and writes.  Extraction keeps groceryItem's resource.
+std::ostream & operator<<( std::ostream & stream, PmrGroceryItem const & groceryItem );
+std::istream & operator>>( std::istream & stream, PmrGroceryItem       & groceryItem );
+
+
+
+
+// Parses operator<< text (see GroceryItemParser.hpp) onto the end of items, each item and its strings allocated from items' own
+// resource.  Records before a failure are kept; returns endOfInput on success.
+ParseStatus appendCatalogText( std::pmr::vector<PmrGroceryItem> & items, std::string_view text );
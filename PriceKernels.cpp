@@ -0,0 +1,301 @@
+#include <algorithm>                                                  // min()
+#include <atomic>
+#include <bit>                                                        // countr_zero()
+#include <cmath>                                                      // nextafter(), abs()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint64_t
+#include <limits>                                                     // numeric_limits
+#include <span>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  #include <immintrin.h>                                              // AVX2 intrinsics
+  #define PRICE_KERNELS_HAVE_AVX2 1
+#endif
+
+#include "FloatingPoint.hpp"                                          // floating_point_is_equal()
+#include "PriceKernels.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  // The tolerances, in the forms the kernels need
+  struct Tolerance
+  {
+    long double epsilon1;
+    long double epsilon2;
+    double      threshold1;                                           // The largest double <= epsilon1:  for a double diff, diff <= epsilon1 exactly when diff <= threshold1
+    double      epsilon2Double;
+    bool        vectorizable;                                         // Whether the double-precision shortcut for the EPSILON2 test is sound for these tolerances
+  };
+
+
+  Tolerance makeTolerance( long double epsilon1, long double epsilon2 ) noexcept
+  {
+    Tolerance tolerance{ epsilon1, epsilon2, static_cast<double>( epsilon1 ), static_cast<double>( epsilon2 ), true };
+    if( static_cast<long double>( tolerance.threshold1 ) > epsilon1 )
+    {
+      tolerance.threshold1 = std::nextafter( tolerance.threshold1, -std::numeric_limits<double>::infinity() );
+    }
+
+    // The error bound below assumes epsilon2 converts to a double with full (normal) precision
+    tolerance.vectorizable = epsilon2 == 0.0L
+                          || ( epsilon2 >= std::numeric_limits<double>::min() && epsilon2 <= std::numeric_limits<double>::max() );
+    return tolerance;
+  }
+
+
+  bool isEqual( double price, double target, Tolerance const & tolerance ) noexcept
+  { return floating_point_is_equal( price, target, tolerance.epsilon1, tolerance.epsilon2 ); }
+
+
+  bool isInBand( double price, double low, double high, Tolerance const & tolerance ) noexcept
+  {
+    return ( price > low  || isEqual( price, low,  tolerance ) )
+        && ( price < high || isEqual( price, high, tolerance ) );
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Scalar kernels
+  *****************************************************************************/
+  template< typename Predicate >
+  void matchScalar( std::span<double const> prices, std::span<std::uint64_t> mask, Predicate matches ) noexcept
+  {
+    for( std::size_t word = 0; word * 64 < prices.size(); ++word )
+    {
+      std::uint64_t bits = 0;
+      std::size_t   last = std::min<std::size_t>( prices.size(), word * 64 + 64 );
+      for( std::size_t i = word * 64; i < last; ++i )  bits |= std::uint64_t{ matches( prices[i] ) } << ( i % 64 );
+      mask[word] = bits;
+    }
+  }
+
+
+  void equalScalar( std::span<double const> prices, double target, std::span<std::uint64_t> mask, Tolerance const & tolerance ) noexcept
+  { matchScalar( prices, mask, [&]( double price ) { return isEqual( price, target, tolerance ); } ); }
+
+
+  void bandScalar( std::span<double const> prices, double low, double high, std::span<std::uint64_t> mask, Tolerance const & tolerance ) noexcept
+  { matchScalar( prices, mask, [&]( double price ) { return isInBand( price, low, high, tolerance ); } ); }
+
+
+
+
+  /*****************************************************************************
+  **  AVX2 kernels
+  *****************************************************************************/
+  #ifdef PRICE_KERNELS_HAVE_AVX2
+    // The EPSILON2 product computed in double is within about 2 ulps of the long double product floating_point_is_equal() uses, so
+    // widening it by 1e-15 (about 4.5 ulps) either way, plus the smallest normal double to cover underflow, brackets the true
+    // threshold.  Prices whose distance falls inside the bracket are ambiguous and are decided by floating_point_is_equal() itself.
+    struct EqualTest
+    {
+      __m256d target, absoluteTarget, threshold1, epsilon2;
+    };
+
+    constexpr double shrink = 1.0 - 1e-15;
+    constexpr double grow   = 1.0 + 1e-15;
+
+
+    // For four prices, sets matched to the lanes certainly equal to the target and ambiguous to the lanes that need a scalar check
+    __attribute__(( target( "avx2" ) ))
+    inline void testEqual( __m256d price, EqualTest const & test, __m256d & matched, __m256d & ambiguous ) noexcept
+    {
+      __m256d const signBit = _mm256_set1_pd( -0.0 );
+      __m256d const slack   = _mm256_set1_pd( std::numeric_limits<double>::min() );
+
+      __m256d diff      = _mm256_andnot_pd( signBit, _mm256_sub_pd( price, test.target ) );
+      __m256d larger    = _mm256_max_pd   ( _mm256_andnot_pd( signBit, price ), test.absoluteTarget );
+      __m256d threshold = _mm256_mul_pd   ( test.epsilon2, larger );
+      __m256d low       = _mm256_sub_pd   ( _mm256_mul_pd( threshold, _mm256_set1_pd( shrink ) ), slack );
+      __m256d high      = _mm256_add_pd   ( _mm256_mul_pd( threshold, _mm256_set1_pd( grow   ) ), slack );
+
+      matched   = _mm256_or_pd   ( _mm256_cmp_pd( diff, test.threshold1, _CMP_LE_OQ ), _mm256_cmp_pd( diff, low,  _CMP_LE_OQ ) );
+      ambiguous = _mm256_andnot_pd( matched,                                            _mm256_cmp_pd( diff, high, _CMP_LE_OQ ) );
+    }
+
+
+    __attribute__(( target( "avx2" ) ))
+    inline EqualTest makeEqualTest( double target, Tolerance const & tolerance ) noexcept
+    {
+      return { _mm256_set1_pd( target ), _mm256_set1_pd( std::abs( target ) ), _mm256_set1_pd( tolerance.threshold1 ), _mm256_set1_pd( tolerance.epsilon2Double ) };
+    }
+
+
+    // Runs test over whole groups of four prices, one 64-bit mask word at a time, resolving ambiguous lanes with exact(); the leftover
+    // prices go through the scalar kernel
+    template< typename Test, typename Exact >
+    __attribute__(( target( "avx2" ) ))
+    void matchAvx2( std::span<double const> prices, std::span<std::uint64_t> mask, Test test, Exact exact ) noexcept
+    {
+      std::size_t const vectorCount = prices.size() / 64 * 64;
+      double const *    data        = prices.data();
+
+      for( std::size_t word = 0; word * 64 < vectorCount; ++word )
+      {
+        std::uint64_t bits = 0;
+        for( std::size_t lane = 0; lane < 64; lane += 4 )
+        {
+          std::size_t i = word * 64 + lane;
+          __m256d matched, ambiguous;
+          test( _mm256_loadu_pd( data + i ), matched, ambiguous );
+
+          auto matchedBits   = static_cast<unsigned>( _mm256_movemask_pd( matched   ) );
+          auto ambiguousBits = static_cast<unsigned>( _mm256_movemask_pd( ambiguous ) );
+          while( ambiguousBits != 0 )
+          {
+            unsigned which = static_cast<unsigned>( std::countr_zero( ambiguousBits ) );
+            if( exact( data[i + which] ) )  matchedBits |= 1U << which;
+            ambiguousBits &= ambiguousBits - 1;
+          }
+          bits |= std::uint64_t{ matchedBits } << lane;
+        }
+        mask[word] = bits;
+      }
+
+      if( vectorCount < prices.size() )  matchScalar( prices.subspan( vectorCount ), mask.subspan( vectorCount / 64 ), exact );
+    }
+
+
+    __attribute__(( target( "avx2" ) ))
+    void equalAvx2( std::span<double const> prices, double target, std::span<std::uint64_t> mask, Tolerance const & tolerance ) noexcept
+    {
+      EqualTest equal = makeEqualTest( target, tolerance );
+      matchAvx2( prices, mask,
+                 [&]( __m256d price, __m256d & matched, __m256d & ambiguous ) __attribute__(( target( "avx2" ) )) { testEqual( price, equal, matched, ambiguous ); },
+                 [&]( double price ) { return isEqual( price, target, tolerance ); } );
+    }
+
+
+    __attribute__(( target( "avx2" ) ))
+    void bandAvx2( std::span<double const> prices, double low, double high, std::span<std::uint64_t> mask, Tolerance const & tolerance ) noexcept
+    {
+      EqualTest equalLow  = makeEqualTest( low,  tolerance );
+      EqualTest equalHigh = makeEqualTest( high, tolerance );
+      __m256d   lowBound  = _mm256_set1_pd( low  );
+      __m256d   highBound = _mm256_set1_pd( high );
+
+      auto test = [&]( __m256d price, __m256d & matched, __m256d & ambiguous ) __attribute__(( target( "avx2" ) ))
+      {
+        __m256d lowMatched,  lowAmbiguous,  highMatched,  highAmbiguous;
+        testEqual( price, equalLow,  lowMatched,  lowAmbiguous  );
+        testEqual( price, equalHigh, highMatched, highAmbiguous );
+
+        __m256d aboveLow  = _mm256_or_pd( _mm256_cmp_pd( price, lowBound,  _CMP_GT_OQ ), lowMatched  );   // Certainly not below low
+        __m256d belowHigh = _mm256_or_pd( _mm256_cmp_pd( price, highBound, _CMP_LT_OQ ), highMatched );   // Certainly not above high
+        lowAmbiguous  = _mm256_andnot_pd( aboveLow,  lowAmbiguous  );
+        highAmbiguous = _mm256_andnot_pd( belowHigh, highAmbiguous );
+
+        matched   = _mm256_and_pd( aboveLow, belowHigh );
+        ambiguous = _mm256_and_pd( _mm256_or_pd ( lowAmbiguous, highAmbiguous ),
+                                   _mm256_and_pd( _mm256_or_pd( aboveLow, lowAmbiguous ), _mm256_or_pd( belowHigh, highAmbiguous ) ) );
+      };
+      matchAvx2( prices, mask, test, [&]( double price ) { return isInBand( price, low, high, tolerance ); } );
+    }
+  #endif
+
+
+
+
+  /*****************************************************************************
+  **  Dispatch
+  *****************************************************************************/
+  bool cpuSupports( PriceKernelIsa isa ) noexcept
+  {
+    switch( isa )
+    {
+      case PriceKernelIsa::scalar:  return true;
+      #ifdef PRICE_KERNELS_HAVE_AVX2
+        case PriceKernelIsa::avx2:  return __builtin_cpu_supports( "avx2" );
+      #else
+        case PriceKernelIsa::avx2:  return false;
+      #endif
+    }
+    return false;
+  }
+
+
+  std::atomic<PriceKernelIsa> & activeIsa() noexcept
+  {
+    static std::atomic<PriceKernelIsa> isa{ cpuSupports( PriceKernelIsa::avx2 ) ? PriceKernelIsa::avx2 : PriceKernelIsa::scalar };
+    return isa;
+  }
+
+
+  template< typename Kernel >
+  std::vector<std::size_t> indicesOf( std::size_t count, Kernel matchInto )
+  {
+    std::vector<std::uint64_t> mask( ( count + 63 ) / 64 );
+    matchInto( std::span<std::uint64_t>( mask ) );
+
+    std::vector<std::size_t> indices;
+    for( std::size_t word = 0; word < mask.size(); ++word )
+    {
+      for( std::uint64_t bits = mask[word];  bits != 0;  bits &= bits - 1 )  indices.push_back( word * 64 + static_cast<std::size_t>( std::countr_zero( bits ) ) );
+    }
+    return indices;
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Kernel selection
+*******************************************************************************/
+
+PriceKernelIsa activePriceKernelIsa() noexcept
+{ return activeIsa().load( std::memory_order_relaxed ); }
+
+
+bool setPriceKernelIsa( PriceKernelIsa isa ) noexcept
+{
+  if( !cpuSupports( isa ) )  return false;
+  activeIsa().store( isa, std::memory_order_relaxed );
+  return true;
+}
+
+
+
+
+/*******************************************************************************
+**  Filters
+*******************************************************************************/
+
+void matchPriceEqual( std::span<double const> prices, double target, std::span<std::uint64_t> mask, long double epsilon1, long double epsilon2 ) noexcept
+{
+  Tolerance tolerance = makeTolerance( epsilon1, epsilon2 );
+  #ifdef PRICE_KERNELS_HAVE_AVX2
+    if( tolerance.vectorizable && activePriceKernelIsa() == PriceKernelIsa::avx2 )  return equalAvx2( prices, target, mask, tolerance );
+  #endif
+  equalScalar( prices, target, mask, tolerance );
+}
+
+
+void matchPriceBand( std::span<double const> prices, double low, double high, std::span<std::uint64_t> mask, long double epsilon1, long double epsilon2 ) noexcept
+{
+  Tolerance tolerance = makeTolerance( epsilon1, epsilon2 );
+  #ifdef PRICE_KERNELS_HAVE_AVX2
+    if( tolerance.vectorizable && activePriceKernelIsa() == PriceKernelIsa::avx2 )  return bandAvx2( prices, low, high, mask, tolerance );
+  #endif
+  bandScalar( prices, low, high, mask, tolerance );
+}
+
+
+std::vector<std::size_t> findPricesEqual( std::span<double const> prices, double target, long double epsilon1, long double epsilon2 )
+{
+  return indicesOf( prices.size(), [&]( std::span<std::uint64_t> mask ) { matchPriceEqual( prices, target, mask, epsilon1, epsilon2 ); } );
+}
+
+
+std::vector<std::size_t> findPricesInBand( std::span<double const> prices, double low, double high, long double epsilon1, long double epsilon2 )
+{
+  return indicesOf( prices.size(), [&]( std::span<std::uint64_t> mask ) { matchPriceBand( prices, low, high, mask, epsilon1, epsilon2 ); } );
+}
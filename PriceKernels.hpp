@@ -0,0 +1,40 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint64_t
+#include <span>
+#include <vector>
+
+
+
+
+// Batch price filters over a contiguous array of prices, giving exactly the answers floating_point_is_equal() (FloatingPoint.hpp)
+// gives one pair at a time, for the same EPSILON1 / EPSILON2 tolerances.
+//
+//   o)  "equal"  - floating_point_is_equal( price, target, epsilon1, epsilon2 )
+//   o)  "band"   - price is not below low and not above high in GroceryItem's price ordering, i.e.
+//                  ( price > low || equal( price, low ) ) && ( price < high || equal( price, high ) )
+//
+// floating_point_is_equal() works in long double, which keeps the compiler on x87 code and away from vector registers.  The AVX2
+// kernels work in double instead:  the EPSILON1 test is made exact by rounding EPSILON1 down to a double, and the EPSILON2 test is
+// decided in double whenever the price is clear of the boundary by more than double rounding could account for.  The rare prices
+// within a few ulps of the boundary are handed to floating_point_is_equal() itself, so the results always match it bit for bit.
+//
+// The kernel used is picked at run time:  AVX2 when the CPU has it, otherwise a scalar loop over floating_point_is_equal().
+
+enum class PriceKernelIsa { scalar, avx2 };
+
+PriceKernelIsa activePriceKernelIsa() noexcept;
+bool           setPriceKernelIsa   ( PriceKernelIsa isa ) noexcept;            // Returns false, changing nothing, if this CPU can't run isa
+
+
+
+
+// Match masks:  bit i % 64 of mask[i / 64] is set when prices[i] matches.  mask must hold at least (prices.size() + 63) / 64 words;
+// bits past the last price are cleared.  The epsilons default to floating_point_is_equal()'s defaults.
+void matchPriceEqual( std::span<double const> prices, double target,           std::span<std::uint64_t> mask, long double epsilon1 = 1e-4L, long double epsilon2 = 1e-8L ) noexcept;
+void matchPriceBand ( std::span<double const> prices, double low, double high, std::span<std::uint64_t> mask, long double epsilon1 = 1e-4L, long double epsilon2 = 1e-8L ) noexcept;
+
+// The same filters, returning the ascending indices of the matching prices
+std::vector<std::size_t> findPricesEqual ( std::span<double const> prices, double target,           long double epsilon1 = 1e-4L, long double epsilon2 = 1e-8L );
+std::vector<std::size_t> findPricesInBand( std::span<double const> prices, double low, double high, long double epsilon1 = 1e-4L, long double epsilon2 = 1e-8L );
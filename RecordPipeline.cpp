@@ -0,0 +1,101 @@
+#include <algorithm>                                                  // push_heap(), pop_heap(), sort(), min(), max()
+#include <cstddef>                                                    // size_t
+#include <string>
+#include <string_view>
+#include <utility>                                                    // move(), pair
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "RecordPipeline.hpp"
+#include "RecordSource.hpp"
+
+
+
+/*******************************************************************************
+**  BrandAggregate
+*******************************************************************************/
+
+void BrandAggregate::operator()( ItemView const & item )
+{ add( item.brandName, item.price ); }
+
+
+void BrandAggregate::add( std::string_view brandName, double price )
+{
+  auto brand = _brands.find( brandName );
+  if( brand == _brands.end() )  brand = _brands.emplace( std::string( brandName ), Statistics{ 0, 0.0, price, price } ).first;
+
+  auto & statistics = brand->second;
+  ++statistics.count;
+  statistics.sum += price;
+  statistics.min  = std::min( statistics.min, price );
+  statistics.max  = std::max( statistics.max, price );
+}
+
+
+std::size_t BrandAggregate::size() const noexcept
+{ return _brands.size(); }
+
+
+BrandAggregate::Statistics const * BrandAggregate::find( std::string_view brandName ) const noexcept
+{
+  auto brand = _brands.find( brandName );
+  return brand == _brands.end() ? nullptr : &brand->second;
+}
+
+
+std::vector<std::pair<std::string, BrandAggregate::Statistics>> BrandAggregate::results() const
+{
+  std::vector<std::pair<std::string, Statistics>> brands( _brands.begin(), _brands.end() );
+  std::sort( brands.begin(), brands.end(), []( auto const & lhs, auto const & rhs ) { return lhs.first < rhs.first; } );
+  return brands;
+}
+
+
+
+
+/*******************************************************************************
+**  TopK
+*******************************************************************************/
+
+TopK::TopK( std::size_t k )
+  : _k( k )
+{ _heap.reserve( k ); }
+
+
+void TopK::operator()( ItemView const & item )
+{
+  auto sequence = _seen++;
+  if( _heap.size() < _k )
+  {
+    _heap.emplace_back();
+  }
+  else if( _k != 0 && item.price > _heap.front().price )              // An equal price came later, so ranks lower
+  {
+    std::pop_heap( _heap.begin(), _heap.end(), ranksAbove );          // The entry pushed out is now at the back, to be written over
+  }
+  else return;
+
+  auto & entry = _heap.back();
+  entry.price    = item.price;
+  entry.sequence = sequence;
+  entry.upcCode    .assign( item.upcCode     );
+  entry.brandName  .assign( item.brandName   );
+  entry.productName.assign( item.productName );
+  std::push_heap( _heap.begin(), _heap.end(), ranksAbove );
+}
+
+
+std::vector<GroceryItem> TopK::results() const
+{
+  std::vector<Entry> entries = _heap;
+  std::sort( entries.begin(), entries.end(), ranksAbove );
+
+  std::vector<GroceryItem> items;
+  items.reserve( entries.size() );
+  for( auto & entry : entries )  items.emplace_back( std::move( entry.productName ), std::move( entry.brandName ), std::move( entry.upcCode ), entry.price );
+  return items;
+}
+
+
+bool TopK::ranksAbove( Entry const & lhs, Entry const & rhs ) noexcept
+{ return lhs.price > rhs.price || ( lhs.price == rhs.price && lhs.sequence < rhs.sequence ); }
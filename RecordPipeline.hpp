@@ -0,0 +1,137 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint64_t
+#include <functional>                                                         // hash, equal_to
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>                                                            // move(), pair
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "RecordSource.hpp"
+
+
+
+
+// Streaming operators over the ItemViews a RecordSource produces.  An operator is anything callable with an ItemView const &; it
+// sees each record once and must copy whatever it wants to keep, since the views die with the record.  Chain them and run them
+// against a source in one pass:
+//
+//     BrandAggregate byBrand;
+//     TopK           priciest( 10 );
+//     auto           both    = fanOut( byBrand, priciest );
+//     auto           organic = filter( []( ItemView const & item ) { return item.productName.contains( "Organic" ); }, both );
+//     ParseStatus    status  = run( source, organic );
+//
+// Memory is the source's buffer plus whatever the operators keep:  a BrandAggregate one entry per distinct brand, a TopK k items.
+
+
+// Feeds every record from source to sink.  Returns source.status():  endOfInput if the whole input was read.
+template< typename Sink >
+ParseStatus run( RecordSource & source, Sink && sink )
+{
+  ItemView item;
+  while( source.next( item ) )  sink( item );
+  return source.status();
+}
+
+
+
+
+// Passes on only the records predicate accepts
+template< typename Predicate, typename Sink >
+class Filter
+{
+  public:
+    Filter( Predicate predicate, Sink & sink )
+      : _predicate( std::move( predicate ) ), _sink( sink )
+    {}
+
+    void operator()( ItemView const & item )
+    {
+      if( _predicate( item ) )  _sink( item );
+    }
+
+  private:
+    Predicate _predicate;
+    Sink &    _sink;
+};
+
+template< typename Predicate, typename Sink >
+Filter<Predicate, Sink> filter( Predicate predicate, Sink & sink )
+{ return Filter<Predicate, Sink>( std::move( predicate ), sink ); }
+
+
+
+
+// Passes every record to each of sinks, in order
+template< typename... Sinks >
+auto fanOut( Sinks &... sinks )
+{
+  return [&sinks...]( ItemView const & item ) { ( sinks( item ), ... ); };
+}
+
+
+
+
+// Count, sum, smallest, and largest price per brand name.  Sums are accumulated in input order, so they match a loop over the same
+// items in the same order exactly.
+class BrandAggregate
+{
+  public:
+    struct Statistics
+    {
+      std::size_t count = 0;
+      double      sum   = 0.0;
+      double      min   = 0.0;
+      double      max   = 0.0;
+    };
+
+    void operator()( ItemView const & item );
+    void add       ( std::string_view brandName, double price );
+
+    std::size_t                                     size   () const noexcept; // Distinct brand names seen
+    Statistics const *                              find   ( std::string_view brandName ) const noexcept;   // nullptr if the brand never appeared
+    std::vector<std::pair<std::string, Statistics>> results() const;          // Every brand, ordered by brand name
+
+  private:
+    struct TransparentHash
+    {
+      using is_transparent = void;
+      std::size_t operator()( std::string_view text ) const noexcept { return std::hash<std::string_view>{}( text ); }
+    };
+
+    std::unordered_map<std::string, Statistics, TransparentHash, std::equal_to<>> _brands;   // Looked up by std::string_view:  only a new brand allocates
+};
+
+
+
+
+// The k most expensive items.  Prices are compared exactly (no epsilon); among equal prices the item given first wins.  An item
+// is copied only when it enters the top k, and then into storage reused from the item it pushed out.
+class TopK
+{
+  public:
+    explicit TopK( std::size_t k );
+
+    void operator()( ItemView const & item );
+
+    std::vector<GroceryItem> results() const;                                 // Most expensive first
+
+  private:
+    struct Entry
+    {
+      double        price    = 0.0;
+      std::uint64_t sequence = 0;                                             // Position among the items this TopK was given
+      std::string   upcCode, brandName, productName;
+    };
+
+    static bool ranksAbove( Entry const & lhs, Entry const & rhs ) noexcept; // A higher price, or the same price earlier in the input
+
+    std::size_t        _k;
+    std::uint64_t      _seen = 0;
+    std::vector<Entry> _heap;                                                 // Min-heap:  the lowest ranked entry, the one to push out next, at the front
+};
@@ -0,0 +1,131 @@
+#include <algorithm>                                                  // count(), max()
+#include <cstddef>                                                    // size_t
+#include <cstring>                                                    // memmove()
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "GroceryItemParser.hpp"
+#include "IngestMetrics.hpp"
+#include "RecordSource.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors
+*******************************************************************************/
+
+RecordSource::RecordSource( std::istream & stream, std::size_t bufferSize )
+  : _stream( &stream ),
+    _buffer( std::max<std::size_t>( bufferSize, 1 ) )
+{
+  _begin = _cursor = _end = _buffer.data();
+  refill( _cursor );
+}
+
+
+RecordSource::RecordSource( std::string_view text )
+  : _begin ( text.data()               ),
+    _cursor( text.data()               ),
+    _end   ( text.data() + text.size() ),
+    _atEnd ( true                      )
+{}
+
+
+
+
+/*******************************************************************************
+**  Reading
+*******************************************************************************/
+
+bool RecordSource::next( ItemView & item )
+{
+  if( _status != ParseStatus::ok )  return false;
+
+  RecordView  record;
+  ParseStatus status;
+  char const * cursor;
+  auto         position = _discardedBytes + static_cast<std::size_t>( _cursor - _begin );   // In the whole input:  refills move the buffer
+  while( true )
+  {
+    cursor = _cursor;
+    status = parseRecord( cursor, _end, record );
+
+    // The parser stops at the end of what it was given only when the record might go on past it:  a field or price cut short, or
+    // nothing but whitespace.  Stopping anywhere else, more input couldn't change the outcome.
+    if( _atEnd || cursor != _end )  break;
+    refill( status == ParseStatus::endOfInput ? _end : record.begin );
+  }
+
+  if( status != ParseStatus::ok )
+  {
+    _status = status;
+    if( status != ParseStatus::endOfInput )
+    {
+      _errorOffset = _discardedBytes + static_cast<std::size_t>( record.begin - _begin );
+      _errorLine   = _discardedLines + static_cast<std::size_t>( std::count( _begin, record.begin, '\n' ) ) + 1;
+    }
+    IngestMetrics::count     ( IngestCounter::bytesRead, ( status == ParseStatus::endOfInput ? _discardedBytes + static_cast<std::size_t>( _end - _begin ) : _errorOffset ) - position );
+    IngestMetrics::parseError( status );
+    return false;
+  }
+
+  auto value = []( FieldView const & field, std::string & scratch ) -> std::string_view
+  {
+    if( !field.escaped )  return field.text;
+    unescape( field, scratch );
+    return scratch;
+  };
+
+  item.upcCode     = value( record.upcCode,     _upcCode     );
+  item.brandName   = value( record.brandName,   _brandName   );
+  item.productName = value( record.productName, _productName );
+  item.price       = record.price;
+
+  IngestMetrics::count( IngestCounter::recordsRead );
+  IngestMetrics::count( IngestCounter::bytesRead, _discardedBytes + static_cast<std::size_t>( cursor - _begin ) - position );
+
+  _cursor = cursor;
+  ++_recordCount;
+  return true;
+}
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+
+ParseStatus RecordSource::status     () const noexcept { return _status;      }
+std::size_t RecordSource::recordCount() const noexcept { return _recordCount; }
+std::size_t RecordSource::errorLine  () const noexcept { return _errorLine;   }
+std::size_t RecordSource::errorOffset() const noexcept { return _errorOffset; }
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+
+void RecordSource::refill( char const * keepFrom )
+{
+  // Forget everything before keepFrom, remembering how many bytes and lines that was
+  _discardedBytes += static_cast<std::size_t>( keepFrom - _begin );
+  _discardedLines += static_cast<std::size_t>( std::count( _begin, keepFrom, '\n' ) );
+
+  auto kept = static_cast<std::size_t>( _end - keepFrom );
+  std::memmove( _buffer.data(), keepFrom, kept );
+  if( kept == _buffer.size() )  _buffer.resize( _buffer.size() * 2 ); // One record fills the whole buffer
+
+  {
+    IngestTimer timer( IngestStage::read, true );
+    _stream->read( _buffer.data() + kept, static_cast<std::streamsize>( _buffer.size() - kept ) );
+  }
+  auto added = static_cast<std::size_t>( _stream->gcount() );
+
+  _begin = _cursor = _buffer.data();
+  _end   = _begin + kept + added;
+  _atEnd = !*_stream;                                                 // read() fails only when it runs out of input
+}
@@ -0,0 +1,69 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItemParser.hpp"
+
+
+
+
+// A grocery item's fields as views, not owned strings:  valid only until the RecordSource that produced them moves on
+struct ItemView
+{
+  std::string_view upcCode;
+  std::string_view brandName;
+  std::string_view productName;
+  double           price = 0.0;
+};
+
+
+
+
+// Reads operator<< text one record at a time through a fixed-size buffer, without ever building a GroceryItem.  Each record reads
+// exactly as operator>> would read it (see GroceryItemParser.hpp), and the source stops at the same record, with the same status,
+// line, and offset, that loadCatalog() reports.
+//
+// Fields point straight into the read buffer; only fields containing escapes are copied, once each, to have their escapes removed.
+// Memory use is the buffer, which grows only if a single record is longer than it, no matter how long the input is.
+class RecordSource
+{
+  public:
+    static constexpr std::size_t defaultBufferSize = 1 << 20;
+
+    explicit RecordSource( std::istream & stream, std::size_t bufferSize = defaultBufferSize );
+    explicit RecordSource( std::string_view text );                           // Text already in memory (Ex: a MappedFile), read in place
+
+    RecordSource            ( RecordSource const & ) = delete;
+    RecordSource & operator=( RecordSource const & ) = delete;
+
+    bool next( ItemView & item );                                             // The next record, or false at the end of the input or at a bad record
+
+    ParseStatus status     () const noexcept;                                 // ok while records remain, then endOfInput, or why the failing record was rejected
+    std::size_t recordCount() const noexcept;                                 // Records read so far
+    std::size_t errorLine  () const noexcept;                                 // 1-based line on which the failing record starts (0 when there was no failure)
+    std::size_t errorOffset() const noexcept;                                 // Byte offset of the failing record's first character
+
+  private:
+    void refill( char const * keepFrom );                                     // Keeps [keepFrom, _end), reading more input after it
+
+    std::istream *    _stream = nullptr;                                      // nullptr when reading text in memory
+    std::vector<char> _buffer;
+    char const *      _begin  = nullptr;                                      // The input in memory:  _buffer's data, or the text
+    char const *      _cursor = nullptr;
+    char const *      _end    = nullptr;
+    bool              _atEnd  = false;                                        // No more input beyond _end
+
+    std::size_t       _discardedBytes = 0;                                    // Input already dropped from before _begin
+    std::size_t       _discardedLines = 0;                                    // Newlines in it
+
+    ParseStatus       _status      = ParseStatus::ok;
+    std::size_t       _recordCount = 0;
+    std::size_t       _errorLine   = 0;
+    std::size_t       _errorOffset = 0;
+
+    std::string       _upcCode, _brandName, _productName;                     // Unescaped fields, reusing their capacity from record to record
+};
@@ -0,0 +1,21 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <functional>                                                         // less
+#include <string>
+
+
+
+
+// Whether text's characters live in a heap block rather than inside the string itself (the small string optimization).  Asks where
+// the characters are, not how large the capacity is, so it holds for any standard library's small-string buffer size.
+inline bool onHeap( std::string const & text ) noexcept
+{
+  auto self = reinterpret_cast<char const *>( &text );
+  return std::less<>{}( text.data(), self ) || !std::less<>{}( text.data(), self + sizeof text );
+}
+
+
+// The size of text's heap block, terminator included:  0 when its characters are held in the string itself
+inline std::size_t heapBytes( std::string const & text ) noexcept
+{ return onHeap( text ) ? text.capacity() + 1 : 0; }
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstddef>                                                    // size_t
+#include <memory>                                                     // make_unique()
+#include <mutex>                                                      // unique_lock
+#include <shared_mutex>                                               // shared_lock
+#include <stdexcept>                                                  // length_error
+#include <string>
+#include <string_view>
+
+#include "StringPool.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors, assignments, and destructor
+*******************************************************************************/
+
+StringPool::StringPool()
+  : _blocks( std::make_unique<std::atomic<std::string *>[]>( maxBlocks ) )
+{}
+
+
+StringPool::~StringPool() noexcept
+{
+  for( std::size_t block = 0; block < maxBlocks; ++block )  delete[] _blocks[block].load( std::memory_order_relaxed );
+}
+
+
+StringPool & StringPool::brandNames()
+{
+  static StringPool pool;
+  return pool;
+}
+
+
+StringPool & StringPool::productNames()
+{
+  static StringPool pool;
+  return pool;
+}
+
+
+
+
+/*******************************************************************************
+**  Accessors and modifiers
+*******************************************************************************/
+
+StringPool::Symbol StringPool::intern( std::string_view text )
+{
+  {
+    std::shared_lock lock( _indexMutex );
+    if( auto entry = _index.find( text );  entry != _index.end() )  return entry->second;
+  }
+
+  std::unique_lock lock( _indexMutex );
+  if( auto entry = _index.find( text );  entry != _index.end() )  return entry->second;   // Another thread may have added it while we waited
+
+  std::size_t symbol = _size.load( std::memory_order_relaxed );
+  if( symbol == maxBlocks * blockSize )  throw std::length_error( "StringPool: too many distinct strings" );
+
+  auto & block = _blocks[symbol >> blockBits];
+  if( block.load( std::memory_order_relaxed ) == nullptr )  block.store( new std::string[blockSize], std::memory_order_release );
+
+  std::string & slot = block.load( std::memory_order_relaxed )[symbol & ( blockSize - 1 )];
+  slot.assign( text );
+  _index.emplace( slot, static_cast<Symbol>( symbol ) );
+  _size.store( symbol + 1, std::memory_order_release );               // Publishes the string to readers that learn of the symbol some other way
+  return static_cast<Symbol>( symbol );
+}
+
+
+std::string const & StringPool::text( Symbol symbol ) const noexcept
+{
+  return _blocks[symbol >> blockBits].load( std::memory_order_acquire )[symbol & ( blockSize - 1 )];
+}
+
+
+std::size_t StringPool::size() const noexcept
+{
+  return _size.load( std::memory_order_acquire );
+}
@@ -0,0 +1,50 @@
+#pragma once                                                                  // include guard
+
+#include <atomic>
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint32_t
+#include <memory>                                                             // unique_ptr
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+
+
+// A symbol table:  every distinct string interned is stored exactly once and identified by a compact Symbol.  Interned strings are
+// never removed, so a Symbol, and the std::string it names, stay valid for the lifetime of the pool.
+//
+// intern() may be called from any number of threads.  text() never locks and may be called concurrently with intern().
+class StringPool
+{
+  public:
+    using Symbol = std::uint32_t;
+
+    StringPool();
+    StringPool & operator=( StringPool const  & rhs   ) = delete;             // Symbols identify entries of one particular pool, so pools are neither copied nor moved
+    StringPool & operator=( StringPool       && rhs   ) = delete;
+    StringPool            ( StringPool const  & other ) = delete;
+    StringPool            ( StringPool       && other ) = delete;
+   ~StringPool            (                           ) noexcept;
+
+    Symbol              intern( std::string_view text );                      // Returns text's symbol, adding text to the pool if it's not already there.  Throws std::length_error when the pool is full
+    std::string const & text  ( Symbol symbol ) const noexcept;               // symbol must have come from this pool's intern()
+    std::size_t         size  (               ) const noexcept;               // Number of distinct strings interned
+
+    static StringPool & brandNames  ();                                       // Process-wide pools shared by all interned grocery items
+    static StringPool & productNames();
+
+  private:
+    // Strings live in fixed-size blocks that are never reallocated, so references returned by text() stay valid while the pool grows,
+    // and the table of block pointers is allocated up front so readers never observe it being resized.
+    static constexpr std::size_t blockBits = 12;
+    static constexpr std::size_t blockSize = std::size_t{ 1 } << blockBits;
+    static constexpr std::size_t maxBlocks = std::size_t{ 1 } << 16;          // Room for 2^28 distinct strings
+
+    std::unique_ptr<std::atomic<std::string *>[]> _blocks;
+    std::atomic<std::size_t>                       _size{ 0 };
+
+    mutable std::shared_mutex                      _indexMutex;               // Guards _index.  Look ups take it shared, insertions exclusive
+    std::unordered_map<std::string_view, Symbol>   _index;                    // Keys view the pooled strings themselves
+};
@@ -0,0 +1,445 @@
+#include <algorithm>                                                  // sort(), unique(), upper_bound(), search()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint8_t, uint32_t
+#include <limits>
+#include <stdexcept>                                                  // length_error, out_of_range
+#include <string_view>
+#include <utility>                                                    // move()
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "TrigramIndex.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t compactionThreshold = 1'024;                  // Dead documents to tolerate before considering a compaction
+
+
+  // ASCII case folding only:  bytes outside 'A' - 'Z', including every byte of a multi-byte UTF-8 character, match only themselves
+  constexpr unsigned char fold( char c ) noexcept
+  {
+    auto byte = static_cast<unsigned char>( c );
+    return byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>( byte + ( 'a' - 'A' ) ) : byte;
+  }
+
+
+  // The case-folded trigram starting at text[i]
+  std::uint32_t trigramAt( std::string_view text, std::size_t i ) noexcept
+  { return std::uint32_t{ fold( text[i] ) } << 16 | std::uint32_t{ fold( text[i + 1] ) } << 8 | fold( text[i + 2] ); }
+
+
+  bool containsIgnoringCase( std::string_view text, std::string_view term ) noexcept
+  {
+    return std::search( text.begin(), text.end(), term.begin(), term.end(),
+                        []( char lhs, char rhs ) { return fold( lhs ) == fold( rhs ); } ) != text.end();
+  }
+
+
+  bool matches( GroceryItem const & groceryItem, std::vector<std::string_view> const & terms ) noexcept
+  {
+    for( auto term : terms )
+    {
+      if( !containsIgnoringCase( groceryItem.productName(), term ) && !containsIgnoringCase( groceryItem.brandName(), term ) )  return false;
+    }
+    return true;
+  }
+
+
+  std::vector<std::string_view> termsOf( std::string_view query )
+  {
+    constexpr std::string_view whitespace = " \t\n\v\f\r";
+
+    std::vector<std::string_view> terms;
+    for( auto begin = query.find_first_not_of( whitespace );  begin != std::string_view::npos;  begin = query.find_first_not_of( whitespace, begin ) )
+    {
+      auto end = std::min( query.find_first_of( whitespace, begin ), query.size() );
+      terms.push_back( query.substr( begin, end - begin ) );
+      begin = end;
+    }
+    return terms;
+  }
+
+
+  void writeVarint( std::vector<std::uint8_t> & bytes, std::uint32_t value )
+  {
+    while( value >= 0x80 )
+    {
+      bytes.push_back( static_cast<std::uint8_t>( value | 0x80 ) );
+      value >>= 7;
+    }
+    bytes.push_back( static_cast<std::uint8_t>( value ) );
+  }
+
+
+  std::uint32_t readVarint( std::uint8_t const * bytes, std::size_t & offset ) noexcept
+  {
+    std::uint32_t value = 0;
+    for( unsigned shift = 0;  ;  shift += 7 )
+    {
+      auto byte = bytes[offset++];
+      value |= std::uint32_t{ byte & 0x7Fu } << shift;
+      if( byte < 0x80 )  return value;
+    }
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Posting lists
+*******************************************************************************/
+
+void TrigramIndex::PostingList::append( DocId doc )
+{
+  if( count % blockSize == 0 )  skips.push_back( { doc, static_cast<std::uint32_t>( bytes.size() ) } );   // A block's first document is in its skip entry
+  else                          writeVarint( bytes, doc - last );
+  last = doc;
+  ++count;
+}
+
+
+
+
+// Walks one posting list in document order, jumping whole blocks by their skip entries when asked for a document far ahead
+class TrigramIndex::Cursor
+{
+  public:
+    explicit Cursor( PostingList const & list ) noexcept
+      : _list( list )
+    {
+      if( list.count == 0 )  _exhausted = true;
+      else                   enterBlock( 0 );
+    }
+
+    DocId doc() const noexcept { return _doc; }
+
+    // Moves to the first document at or after target.  Returns false, and stays there, if the list has none.
+    bool seek( DocId target ) noexcept
+    {
+      if( _exhausted )      return false;
+      if( _doc >= target )  return true;
+
+      // Jump to the last block starting at or before target, if that's a later block
+      auto const & skips = _list.skips;
+      if( _block + 1 < skips.size() && skips[_block + 1].firstDoc <= target )
+      {
+        auto next = std::upper_bound( skips.begin() + static_cast<std::ptrdiff_t>( _block ) + 1, skips.end(), target,
+                                      []( DocId doc, Skip const & skip ) { return doc < skip.firstDoc; } ) - 1;
+        enterBlock( static_cast<std::size_t>( next - skips.begin() ) );
+      }
+
+      // Then decode forward.  Running off the end of this block lands on the next block's first document, which is past target.
+      while( _doc < target )
+      {
+        if( _offset == _blockEnd )
+        {
+          if( _block + 1 == skips.size() )
+          {
+            _exhausted = true;
+            return false;
+          }
+          enterBlock( _block + 1 );
+        }
+        else  _doc += readVarint( _list.bytes.data(), _offset );
+      }
+      return true;
+    }
+
+  private:
+    void enterBlock( std::size_t block ) noexcept
+    {
+      _block    = block;
+      _doc      = _list.skips[block].firstDoc;
+      _offset   = _list.skips[block].offset;
+      _blockEnd = block + 1 < _list.skips.size() ? _list.skips[block + 1].offset : _list.bytes.size();
+    }
+
+    PostingList const & _list;
+    std::size_t         _block     = 0;
+    std::size_t         _offset    = 0;
+    std::size_t         _blockEnd  = 0;
+    DocId               _doc       = 0;
+    bool                _exhausted = false;
+};
+
+
+
+
+/*******************************************************************************
+**  Constructors
+*******************************************************************************/
+
+TrigramIndex::TrigramIndex( std::vector<GroceryItem> items )
+  : _items( std::move( items ) )
+{
+  if( _items.size() >= deadDoc )  throw std::length_error( "TrigramIndex:  too many items" );
+
+  auto count = static_cast<std::uint32_t>( _items.size() );
+  _docOf .reserve( count );
+  _itemOf.reserve( count );
+  for( std::uint32_t i = 0; i < count; ++i )
+  {
+    _docOf .push_back( i );
+    _itemOf.push_back( i );
+    indexDocument( i, _items[i] );
+  }
+  _size = count;
+
+  // The lists grew by doubling; they won't grow again much, so give the slack back
+  for( auto & list : _lists )
+  {
+    list.bytes.shrink_to_fit();
+    list.skips.shrink_to_fit();
+  }
+}
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+
+TrigramIndex::ItemId TrigramIndex::insert( GroceryItem groceryItem )
+{
+  if( _itemOf.size() >= deadDoc && _deadDocs > 0 )  compact();
+  if( _items.size() >= deadDoc || _itemOf.size() >= deadDoc )  throw std::length_error( "TrigramIndex:  too many items" );
+
+  auto id  = static_cast<ItemId>( _items.size() );
+  auto doc = static_cast<DocId >( _itemOf.size() );
+  _items .push_back( std::move( groceryItem ) );
+  _docOf .push_back( doc );
+  _itemOf.push_back( id );
+  ++_size;
+
+  indexDocument( doc, _items.back() );
+  return id;
+}
+
+
+void TrigramIndex::update( ItemId id, GroceryItem groceryItem )
+{
+  if( id >= _docOf.size() || _docOf[id] == deadDoc )  throw std::out_of_range( "TrigramIndex::update:  no such item" );
+
+  // Nothing indexed changes with the UPC or price, so those changes leave the postings alone
+  auto & item = _items[id];
+  if( item.productName() == groceryItem.productName() && item.brandName() == groceryItem.brandName() )
+  {
+    item = std::move( groceryItem );
+    return;
+  }
+
+  if( _itemOf.size() >= deadDoc )  compact();
+  if( _itemOf.size() >= deadDoc )  throw std::length_error( "TrigramIndex:  too many documents" );
+
+  auto doc = static_cast<DocId>( _itemOf.size() );
+  _itemOf.push_back( id );
+  retire( id );
+  _docOf[id] = doc;
+  item       = std::move( groceryItem );
+  indexDocument( doc, item );
+
+  if( _deadDocs > compactionThreshold && _deadDocs > _size )  compact();
+}
+
+
+bool TrigramIndex::erase( ItemId id )
+{
+  if( id >= _docOf.size() || _docOf[id] == deadDoc )  return false;
+
+  retire( id );
+  _docOf[id] = deadDoc;
+  _items[id] = GroceryItem();
+  --_size;
+
+  if( _deadDocs > compactionThreshold && _deadDocs > _size )  compact();
+  return true;
+}
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+
+std::vector<TrigramIndex::ItemId> TrigramIndex::search( std::string_view query, std::size_t limit ) const
+{
+  std::vector<ItemId> results;
+  if( limit == 0 )  return results;
+
+  // Every trigram of every term must be in a matching item.  One that's in no item at all rules everything out.
+  auto                             terms = termsOf( query );
+  std::vector<PostingList const *> lists;
+  for( auto term : terms )
+  {
+    for( std::size_t i = 0; i + 3 <= term.size(); ++i )
+    {
+      auto list = listOf( trigramAt( term, i ) );
+      if( list == noList || _lists[list].count == 0 )  return results;
+      lists.push_back( &_lists[list] );
+    }
+  }
+
+  // Smallest list first:  it proposes the candidates, and the others only confirm them
+  std::sort( lists.begin(), lists.end(), []( PostingList const * lhs, PostingList const * rhs ) { return lhs->count < rhs->count
+                                                                                                      || ( lhs->count == rhs->count && lhs < rhs ); } );
+  lists.erase( std::unique( lists.begin(), lists.end() ), lists.end() );
+
+  auto consider = [&]( DocId doc )
+  {
+    auto id = _itemOf[doc];
+    if( id != deadDoc && matches( _items[id], terms ) )  results.push_back( id );
+    return results.size() < limit;
+  };
+
+  if( lists.empty() )
+  {
+    // No term is long enough to have a trigram:  check every item
+    for( DocId doc = 0; doc < _itemOf.size() && consider( doc ); ++doc )  {}
+  }
+  else
+  {
+    std::vector<Cursor> cursors;
+    cursors.reserve( lists.size() );
+    for( auto list : lists )  cursors.emplace_back( *list );
+
+    // Leapfrog:  whenever a list's next document is past the candidate, it becomes the candidate and the lists are asked again
+    bool exhausted = false;
+    for( DocId candidate = 0;  !exhausted;  )
+    {
+      bool agreed = true;
+      for( auto & cursor : cursors )
+      {
+        if( !cursor.seek( candidate ) )  exhausted = true;
+        else if( cursor.doc() != candidate )
+        {
+          candidate = cursor.doc();
+          agreed    = false;
+        }
+        if( exhausted || !agreed )  break;
+      }
+      if( exhausted || !agreed )  continue;
+
+      // Having every trigram is necessary but not sufficient:  they may be scattered, or split between the product and brand names
+      if( !consider( candidate ) )  break;
+      ++candidate;
+    }
+  }
+
+  std::sort( results.begin(), results.end() );                        // Document order differs from ItemId order once items are updated
+  return results;
+}
+
+
+GroceryItem const * TrigramIndex::find( ItemId id ) const noexcept
+{ return id < _docOf.size() && _docOf[id] != deadDoc ? &_items[id] : nullptr; }
+
+
+std::size_t TrigramIndex::size() const noexcept
+{ return _size; }
+
+
+std::size_t TrigramIndex::postingBytes() const noexcept
+{
+  std::size_t bytes = ( _pageOf.capacity() + _listOf.capacity() ) * sizeof( std::uint32_t ) + _lists.size() * sizeof( PostingList );
+  for( auto const & list : _lists )  bytes += list.bytes.capacity() + list.skips.capacity() * sizeof( Skip );
+  return bytes;
+}
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+
+std::uint32_t TrigramIndex::listOf( std::uint32_t trigram ) const noexcept
+{
+  if( _pageOf.empty() )  return noList;
+  auto page = _pageOf[trigram >> 8];
+  return page == noList ? noList : _listOf[page * pageSize + ( trigram & 0xFF )];
+}
+
+
+std::uint32_t & TrigramIndex::listSlot( std::uint32_t trigram )
+{
+  if( _pageOf.empty() )  _pageOf.assign( std::size_t{ 1 } << 16, noList );
+
+  auto & page = _pageOf[trigram >> 8];
+  if( page == noList )
+  {
+    page = static_cast<std::uint32_t>( _listOf.size() / pageSize );
+    _listOf.resize( _listOf.size() + pageSize, noList );
+  }
+  return _listOf[page * pageSize + ( trigram & 0xFF )];
+}
+
+
+void TrigramIndex::indexDocument( DocId doc, GroceryItem const & groceryItem )
+{
+  for( std::string_view text : { std::string_view( groceryItem.productName() ), std::string_view( groceryItem.brandName() ) } )
+  {
+    for( std::size_t i = 0; i + 3 <= text.size(); ++i )
+    {
+      auto & list = listSlot( trigramAt( text, i ) );
+      if( list == noList )
+      {
+        _lists.emplace_back();
+        list = static_cast<std::uint32_t>( _lists.size() - 1 );
+      }
+
+      auto & postings = _lists[list];
+      if( postings.count == 0 || postings.last != doc )  postings.append( doc );   // Once per document, however often the trigram repeats
+    }
+  }
+}
+
+
+void TrigramIndex::retire( ItemId id )
+{
+  _itemOf[_docOf[id]] = deadDoc;
+  ++_deadDocs;
+}
+
+
+void TrigramIndex::compact()
+{
+  // Live documents keep their relative order, so every rewritten list is still ascending
+  std::vector<DocId>  renumbered( _itemOf.size(), deadDoc );
+  std::vector<ItemId> itemOf;
+  itemOf.reserve( _size );
+  for( DocId doc = 0; doc < _itemOf.size(); ++doc )
+  {
+    if( _itemOf[doc] == deadDoc )  continue;
+    renumbered[doc] = static_cast<DocId>( itemOf.size() );
+    itemOf.push_back( _itemOf[doc] );
+  }
+
+  std::vector<PostingList> lists( _lists.size() );
+  for( std::size_t i = 0; i < _lists.size(); ++i )
+  {
+    Cursor cursor( _lists[i] );
+    for( DocId doc = 0; cursor.seek( doc ); doc = cursor.doc() + 1 )
+    {
+      if( renumbered[cursor.doc()] != deadDoc )  lists[i].append( renumbered[cursor.doc()] );
+    }
+    lists[i].bytes.shrink_to_fit();
+    lists[i].skips.shrink_to_fit();
+  }
+
+  // Everything that can throw is done
+  for( ItemId id = 0; id < _docOf.size(); ++id )
+  {
+    if( _docOf[id] != deadDoc )  _docOf[id] = renumbered[_docOf[id]];
+  }
+  _itemOf   = std::move( itemOf );
+  _lists    = std::move( lists );
+  _deadDocs = 0;
+}
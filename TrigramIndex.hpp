@@ -0,0 +1,99 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint8_t, uint32_t
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// Substring search over product and brand names, answered from an inverted index of trigrams (every run of three characters)
+// instead of a scan of every item.
+//
+// A query is split at whitespace into terms, and an item matches when every term appears in its product name or its brand name,
+// ignoring ASCII case ("peanut BUTTER" matches "Peanut Butter" and "Butterfinger Peanut Bar").  Every trigram of every term must then
+// appear in the item, so the search intersects those trigrams' posting lists and checks only the items in all of them.  Terms
+// shorter than three characters have no trigrams and are only checked; a query with no trigrams at all checks every item.
+//
+// Posting lists hold internal document numbers in ascending order, delta and varint encoded in blocks of 128 with a skip entry
+// (first document, byte offset) per block, so an intersection jumps over the blocks that can't match instead of decoding them.
+// Because a changed item can't be spliced into the middle of a compressed list, update() gives the item a new document at the end of
+// every list it belongs in and leaves its old document dead; erase() leaves it dead too.  Dead documents are skipped, and once they
+// outnumber the live ones every list is rewritten without them.
+//
+// Items are identified by the ItemId insert() returns (or their position, for the items passed to the constructor).  Change an
+// item's product or brand name - through GroceryItem's productName(std::string) and brandName(std::string) modifiers on a copy - and
+// pass the result to update(); changing it behind the index's back isn't possible, since the index keeps its own items.
+class TrigramIndex
+{
+  public:
+    using ItemId = std::uint32_t;
+
+    // Constructors
+    TrigramIndex() = default;
+    explicit TrigramIndex( std::vector<GroceryItem> items );                  // items[i] gets ItemId i
+
+
+    // Modifiers
+    ItemId insert( GroceryItem groceryItem );                                 // Throws std::length_error once ItemIds run out
+    void   update( ItemId id, GroceryItem groceryItem );                      // Throws std::out_of_range if id isn't in the index
+    bool   erase ( ItemId id );                                               // Returns whether an item was removed
+
+
+    // Queries
+    std::vector<ItemId> search      ( std::string_view query,                 // Matching items in ascending ItemId order.  With a limit, only that many
+                                      std::size_t      limit = std::numeric_limits<std::size_t>::max() ) const;   // of the matches, the ones indexed longest ago
+    GroceryItem const * find        ( ItemId id ) const noexcept;             // nullptr if id isn't in the index
+    std::size_t         size        () const noexcept;
+    std::size_t         postingBytes() const noexcept;                        // Memory used by the compressed posting lists
+
+  private:
+    using DocId = std::uint32_t;
+
+    static constexpr DocId         deadDoc   = std::numeric_limits<DocId>::max();
+    static constexpr std::uint32_t noList    = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t   blockSize = 128;                           // Postings per skip entry
+
+    struct Skip
+    {
+      DocId         firstDoc;                                                 // Stored here, not in the block's bytes
+      std::uint32_t offset;                                                   // Where the block's deltas start in bytes
+    };
+
+    struct PostingList
+    {
+      std::vector<std::uint8_t> bytes;                                        // Varint deltas from the previous document in the same block
+      std::vector<Skip>         skips;
+      DocId                     last  = 0;
+      std::uint32_t             count = 0;
+
+      void append( DocId doc );
+    };
+
+    class Cursor;
+
+    void indexDocument( DocId doc, GroceryItem const & groceryItem );
+    void retire       ( ItemId id );                                          // Marks the item's document dead
+    void compact      ();                                                     // Renumbers the live documents densely and rewrites every list without the dead ones
+
+    std::vector<GroceryItem>   _items;                                        // By ItemId; erased items are left empty
+    std::vector<DocId>         _docOf;                                        // ItemId -> its current document, or deadDoc once erased
+    std::vector<ItemId>        _itemOf;                                       // DocId -> the item it indexes, or deadDoc if superseded or erased
+    std::size_t                _size     = 0;
+    std::size_t                _deadDocs = 0;
+    std::uint32_t   listOf  ( std::uint32_t trigram ) const noexcept;         // Its list in _lists, or noList
+    std::uint32_t & listSlot( std::uint32_t trigram );                        // The same, adding the trigram's page if it has none
+
+    // Trigrams (three case-folded bytes) map to lists through a two-level table, addressed directly rather than hashed since indexing
+    // looks up every trigram of every item.  Pages are added only for the two-byte prefixes that occur, so the table costs a fixed
+    // 256 KiB plus 1 KiB per prefix seen - a few MiB for a catalog of English names - rather than 64 MiB for every possible trigram.
+    static constexpr std::size_t pageSize = 256;                              // One entry per third byte
+
+    std::vector<PostingList>   _lists;
+    std::vector<std::uint32_t> _pageOf;                                       // First two bytes -> their page in _listOf, or noList.  Empty until the first item
+    std::vector<std::uint32_t> _listOf;                                       // Pages of pageSize entries:  third byte -> the trigram's list in _lists, or noList
+};
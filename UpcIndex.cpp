@@ -0,0 +1,213 @@
+#include <algorithm>                                                  // max()
+#include <bit>                                                        // bit_ceil()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uint32_t, uint64_t
+#include <cstring>                                                    // memcpy()
+#include <span>
+#include <stdexcept>                                                  // length_error
+#include <string_view>
+#include <utility>                                                    // move(), pair
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "UpcIndex.hpp"
+
+
+
+/*******************************************************************************
+**  Constructors
+*******************************************************************************/
+
+UpcIndex::UpcIndex( std::span<GroceryItem const> items )
+{
+  reserve( items.size() );
+  for( auto const & item : items )  insert( item );
+}
+
+
+
+
+/*******************************************************************************
+**  Modifiers
+*******************************************************************************/
+
+std::pair<GroceryItem const *, bool> UpcIndex::insert( GroceryItem groceryItem )
+{
+  if( ( _items.size() + 1 ) * 2 > _slots.size() )  grow();
+
+  auto   upcHash = hash( groceryItem.upcCode() );
+  auto & slot    = _slots[slotFor( groceryItem.upcCode(), upcHash )];
+  if( slot.item != emptySlot )  return { &_items[slot.item], false };
+
+  if( _items.size() >= emptySlot )  throw std::length_error( "UpcIndex:  too many items" );
+  _items.push_back( std::move( groceryItem ) );
+  slot = { static_cast<std::uint32_t>( upcHash >> 32 ), static_cast<std::uint32_t>( _items.size() - 1 ) };
+  return { &_items.back(), true };
+}
+
+
+std::pair<GroceryItem const *, bool> UpcIndex::insert_or_assign( GroceryItem groceryItem )
+{
+  if( auto existing = find( groceryItem.upcCode() );  existing != nullptr )
+  {
+    auto & item = _items[static_cast<size_type>( existing - _items.data() )];
+    item = std::move( groceryItem );
+    return { &item, false };
+  }
+  return insert( std::move( groceryItem ) );
+}
+
+
+bool UpcIndex::erase( std::string_view upcCode )
+{
+  if( _slots.empty() )  return false;
+
+  auto slot = slotFor( upcCode, hash( upcCode ) );
+  if( _slots[slot].item == emptySlot )  return false;
+
+  // Keep the items dense:  move the last item into the erased item's place, and point the last item's slot at its new position
+  auto erased = _slots[slot].item;
+  vacate( slot );
+
+  auto last = static_cast<std::uint32_t>( _items.size() - 1 );
+  if( erased != last )
+  {
+    auto const & lastUpc = _items[last].upcCode();
+    _slots[slotFor( lastUpc, hash( lastUpc ) )].item = erased;
+    _items[erased] = std::move( _items[last] );
+  }
+  _items.pop_back();
+  return true;
+}
+
+
+void UpcIndex::reserve( size_type count )
+{
+  _items.reserve( count );
+  auto slotCount = std::bit_ceil( std::max<size_type>( 16, count * 2 ) );
+  if( slotCount > _slots.size() )  rehash( slotCount );
+}
+
+
+void UpcIndex::clear() noexcept
+{
+  _items.clear();
+  for( auto & slot : _slots )  slot.item = emptySlot;
+}
+
+
+
+
+/*******************************************************************************
+**  Queries
+*******************************************************************************/
+
+GroceryItem const * UpcIndex::find( std::string_view upcCode ) const noexcept
+{
+  if( _slots.empty() )  return nullptr;
+
+  auto item = _slots[slotFor( upcCode, hash( upcCode ) )].item;
+  return item == emptySlot ? nullptr : &_items[item];
+}
+
+
+bool UpcIndex::contains( std::string_view upcCode ) const noexcept
+{ return find( upcCode ) != nullptr; }
+
+
+UpcIndex::size_type UpcIndex::size() const noexcept
+{ return _items.size(); }
+
+
+bool UpcIndex::empty() const noexcept
+{ return _items.empty(); }
+
+
+std::span<GroceryItem const> UpcIndex::items() const noexcept
+{ return _items; }
+
+
+
+
+/*******************************************************************************
+**  Private helpers
+*******************************************************************************/
+
+std::uint64_t UpcIndex::hash( std::string_view upcCode ) noexcept
+{
+  // Eight bytes at a time, each word run through a 64-bit finalizer (MurmurHash3's fmix64).  UPC codes are mostly 12 to 14 bytes,
+  // which is two overlapping word loads and no byte loop.
+  auto mix = []( std::uint64_t value )
+  {
+    value ^= value >> 33;  value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;  value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+  };
+
+  char const *  data   = upcCode.data();
+  std::size_t   length = upcCode.size();
+  std::uint64_t result = 0x9e3779b97f4a7c15ULL ^ ( length * 0xc2b2ae3d27d4eb4fULL );
+  std::uint64_t word   = 0;
+
+  if( length >= 8 )
+  {
+    for( std::size_t offset = 0; length - offset > 8; offset += 8 )
+    {
+      std::memcpy( &word, data + offset, 8 );
+      result = mix( result ^ word );
+    }
+    std::memcpy( &word, data + length - 8, 8 );                       // The last eight bytes, overlapping the last full word if need be
+  }
+  else if( length != 0 )  std::memcpy( &word, data, length );          // An empty view's data() may be null, which memcpy() mustn't see
+
+  return mix( result ^ word );
+}
+
+
+UpcIndex::size_type UpcIndex::slotFor( std::string_view upcCode, std::uint64_t upcHash ) const noexcept
+{
+  size_type const mask     = _slots.size() - 1;
+  auto const      hashBits = static_cast<std::uint32_t>( upcHash >> 32 );
+
+  for( size_type slot = upcHash & mask;  ; slot = ( slot + 1 ) & mask )
+  {
+    auto const & candidate = _slots[slot];
+    if( candidate.item == emptySlot )  return slot;
+    if( candidate.hashBits == hashBits && _items[candidate.item].upcCode() == upcCode )  return slot;
+  }
+}
+
+
+void UpcIndex::grow()
+{ rehash( std::max<size_type>( 16, _slots.size() * 2 ) ); }
+
+
+void UpcIndex::rehash( size_type slotCount )
+{
+  _slots.assign( slotCount, Slot{ 0, emptySlot } );
+  for( std::uint32_t item = 0; item < _items.size(); ++item )
+  {
+    auto upcHash = hash( _items[item].upcCode() );
+    _slots[slotFor( _items[item].upcCode(), upcHash )] = { static_cast<std::uint32_t>( upcHash >> 32 ), item };
+  }
+}
+
+
+void UpcIndex::vacate( size_type hole ) noexcept
+{
+  // Backward-shift deletion:  walk the rest of the probe run, and move each entry that may legally sit in the hole (its home slot is
+  // not between the hole and where it is now) back into it.  That leaves no gaps in any probe run, so no tombstones are needed.
+  size_type const mask = _slots.size() - 1;
+
+  for( size_type next = ( hole + 1 ) & mask;  _slots[next].item != emptySlot;  next = ( next + 1 ) & mask )
+  {
+    size_type home = hash( _items[_slots[next].item].upcCode() ) & mask;
+    if( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )
+    {
+      _slots[hole] = _slots[next];
+      hole         = next;
+    }
+  }
+  _slots[hole].item = emptySlot;
+}
@@ -0,0 +1,68 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint32_t, uint64_t
+#include <span>
+#include <string_view>
+#include <utility>                                                            // pair
+#include <vector>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// Grocery items keyed by UPC code, for lookups by UPC code alone.  Each UPC code appears at most once.
+//
+// The items are kept side by side in one vector, and a separate open-addressing table with linear probing maps UPC codes to
+// positions in that vector.  A table slot is 8 bytes:  the item's position and 32 bits of its UPC code's hash.  A probe compares
+// those hash bits first and only compares the UPC text on a match, so a lookup is one hash, usually one cache line of slots, and
+// usually one string comparison.  Lookups take a std::string_view and never build a temporary std::string.
+//
+// Inserting and erasing may move items, so pointers returned by insert() and find() are valid only until the next insert, erase, or
+// reserve.  Items are returned as const because changing an item's UPC code in place would corrupt the table; use insert_or_assign()
+// to change an item.
+class UpcIndex
+{
+  public:
+    using size_type = std::size_t;
+
+    // Constructors
+    UpcIndex() = default;
+    explicit UpcIndex( std::span<GroceryItem const> items );                  // Where UPC codes repeat, the first item is kept
+
+
+    // Modifiers
+    std::pair<GroceryItem const *, bool> insert          ( GroceryItem groceryItem );   // Does nothing if the UPC code is already present.  Returns the item with that UPC code and whether it was inserted
+    std::pair<GroceryItem const *, bool> insert_or_assign( GroceryItem groceryItem );   // Replaces the item if the UPC code is already present
+    bool                                 erase           ( std::string_view upcCode );  // Returns whether an item was removed
+    void                                 reserve         ( size_type count );
+    void                                 clear           () noexcept;
+
+
+    // Queries
+    GroceryItem const *          find    ( std::string_view upcCode ) const noexcept;   // nullptr if absent
+    bool                         contains( std::string_view upcCode ) const noexcept;
+    size_type                    size    () const noexcept;
+    bool                         empty   () const noexcept;
+    std::span<GroceryItem const> items   () const noexcept;                  // Every item, in no particular order
+
+  private:
+    struct Slot
+    {
+      std::uint32_t hashBits;                                                 // Upper half of the UPC code's hash
+      std::uint32_t item;                                                     // Position in _items, or emptySlot
+    };
+
+    static constexpr std::uint32_t emptySlot = UINT32_MAX;
+
+    static std::uint64_t hash( std::string_view upcCode ) noexcept;
+
+    size_type slotFor ( std::string_view upcCode, std::uint64_t hash ) const noexcept;   // The slot holding upcCode, or the empty slot where it belongs
+    void      grow    ();
+    void      rehash  ( size_type slotCount );
+    void      vacate  ( size_type slot ) noexcept;                            // Empties slot, shifting later members of its probe run back
+
+    std::vector<GroceryItem> _items;
+    std::vector<Slot>        _slots;                                          // Power of two in size, never more than half full
+};
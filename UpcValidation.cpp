@@ -0,0 +1,312 @@
+#include <algorithm>                                                  // min()
+#include <array>
+#include <atomic>
+#include <bit>                                                        // popcount()
+#include <cstddef>                                                    // size_t
+#include <cstdint>                                                    // uintptr_t
+#include <cstring>                                                    // memcpy()
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  #include <immintrin.h>                                              // AVX2 intrinsics
+  #define UPC_VALIDATION_HAVE_AVX2 1
+#endif
+
+#include "GroceryItem.hpp"
+#include "UpcValidation.hpp"
+
+
+
+/*******************************************************************************
+**  Implementation of non-member private types, objects, and functions
+*******************************************************************************/
+namespace    // unnamed, anonymous namespace
+{
+  constexpr std::size_t upcALength   = 12;
+  constexpr std::size_t gtin14Length = 14;
+
+  bool isUpcLength( std::size_t length ) noexcept
+  { return length == upcALength || length == gtin14Length; }
+
+
+
+
+  /*****************************************************************************
+  **  Scalar kernel
+  *****************************************************************************/
+  UpcStatus validateScalar( std::string_view upcCode ) noexcept
+  {
+    if( !isUpcLength( upcCode.size() ) )  return UpcStatus::badLength;
+
+    // Both lengths are even, so the leftmost digit always carries weight 3
+    unsigned sum = 0;
+    for( std::size_t i = 0; i < upcCode.size(); ++i )
+    {
+      unsigned digit = static_cast<unsigned char>( upcCode[i] ) - unsigned{ '0' };
+      if( digit > 9 )  return UpcStatus::notDigits;
+      sum += i % 2 == 0 ? 3 * digit : digit;
+    }
+    return sum % 10 == 0 ? UpcStatus::valid : UpcStatus::badCheckDigit;
+  }
+
+
+  template< typename CodeAt >
+  std::size_t validateScalar( std::size_t count, CodeAt codeAt, UpcStatus * statuses ) noexcept
+  {
+    std::size_t validCount = 0;
+    for( std::size_t i = 0; i < count; ++i )
+    {
+      statuses[i]  = validateScalar( codeAt( i ) );
+      validCount  += statuses[i] == UpcStatus::valid;
+    }
+    return validCount;
+  }
+
+
+
+
+  /*****************************************************************************
+  **  AVX2 kernel
+  *****************************************************************************/
+  #ifdef UPC_VALIDATION_HAVE_AVX2
+    // Each code is read as one 16-byte vector, so a 12 or 14-digit code brings 4 or 2 bytes past its end along with it.  Those are
+    // given weight 0, but they must be readable:  they are whenever they lie in the same page as the code (4 KiB is the smallest page
+    // x86 has).  A code ending within 16 bytes of a page boundary is copied out first instead.
+    constexpr std::uintptr_t pageSize = 4096;
+
+    // Codes are scattered a record apart through the text (or an item apart through a catalog), too irregularly for the hardware
+    // prefetcher to keep ahead of a kernel this fast, so each code is requested this many codes before it's needed
+    constexpr std::size_t prefetchDistance = 48;
+
+    // The check digit weights, by length:  12, 14, and any other length.  A code of any other length isn't loaded at all, so every one
+    // of its 16 bytes is a non-digit, and its weights of 127 push its sum far beyond anything a 12 or 14-character code can reach.
+    alignas( 16 ) constexpr signed char checkWeights[3][16] = { { 3,   1,   3,   1,   3,   1,   3,   1,   3,   1,   3,   1,   0,   0,   0,   0   },
+                                                                { 3,   1,   3,   1,   3,   1,   3,   1,   3,   1,   3,   1,   3,   1,   0,   0   },
+                                                                { 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127 } };
+
+    // What a code's weighted sum says about it, once each non-digit byte counts as 255 rather than its value:  all digits sum to at
+    // most 9 * ( 7 * 3 + 7 * 1 ), any non-digit in a 12 or 14-character code adds at least 255 but the most it can total is
+    // 255 * ( 7 * 3 + 7 * 1 ), and a code of any other length sums to at least eight saturated 16-bit pairs of 32,767
+    constexpr int mostDigitsSum    = 9   * ( 7 * 3 + 7 * 1 );
+    constexpr int mostNonDigitsSum = 255 * ( 7 * 3 + 7 * 1 );
+    static_assert( mostDigitsSum < 255 && mostNonDigitsSum < 8 * 32'767 );
+
+
+    // The code's bytes in the low lanes, or zeros if it isn't a length worth checking (and so may be empty, or not even 12 bytes long)
+    __attribute__(( target( "avx2" ), no_sanitize_address ))
+    inline __m128i loadCode( std::string_view upcCode ) noexcept
+    {
+      if( !isUpcLength( upcCode.size() ) )  return _mm_setzero_si128();
+      if( ( reinterpret_cast<std::uintptr_t>( upcCode.data() ) & ( pageSize - 1 ) ) <= pageSize - 16 )
+      {
+        return _mm_loadu_si128( reinterpret_cast<__m128i const *>( upcCode.data() ) );
+      }
+
+      alignas( 16 ) char buffer[16] = {};
+      std::memcpy( buffer, upcCode.data(), upcCode.size() );
+      return _mm_load_si128( reinterpret_cast<__m128i const *>( buffer ) );
+    }
+
+
+    __attribute__(( target( "avx2" ) ))
+    inline __m128i weightsFor( std::size_t length ) noexcept
+    {
+      std::size_t lengthClass = ( length == gtin14Length ) + 2 * !isUpcLength( length );
+      return _mm_load_si128( reinterpret_cast<__m128i const *>( checkWeights[lengthClass] ) );
+    }
+
+
+    // Eight codes at a time, two per vector with code k in the low lane and code k + 4 in the high one.  Every byte less '0' that isn't
+    // 9 or below (unsigned) is a non-digit and becomes 255;  a multiply-add by the weights then leaves four partial sums per code, and
+    // three horizontal adds total all eight codes in one vector, in order.  Each code's status follows from its sum alone - its range
+    // (see mostDigitsSum above) and whether it's a multiple of 10 - so it's worked out for all eight at once, with no branches to
+    // mispredict on catalogs that mix valid and invalid codes unpredictably.
+    template< typename CodeAt >
+    __attribute__(( target( "avx2" ) ))
+    std::size_t validateAvx2( std::size_t count, CodeAt codeAt, UpcStatus * statuses ) noexcept
+    {
+      static_assert( static_cast<int>( UpcStatus::valid     ) == 0 && static_cast<int>( UpcStatus::badLength     ) == 1
+                  && static_cast<int>( UpcStatus::notDigits ) == 2 && static_cast<int>( UpcStatus::badCheckDigit ) == 3 );
+
+      __m256i const zeroCharacter = _mm256_set1_epi8 ( '0'   );
+      __m256i const nine          = _mm256_set1_epi8 ( 9     );
+      __m256i const ones          = _mm256_set1_epi16( 1     );
+      __m256i const ten           = _mm256_set1_epi32( 10    );
+      __m256i const tenthScaled   = _mm256_set1_epi32( 52429 );               // ( n * 52429 ) >> 19 is n / 10 for any n below 2^16
+      __m256i const digitsLimit   = _mm256_set1_epi32( mostDigitsSum    );
+      __m256i const lengthLimit   = _mm256_set1_epi32( mostNonDigitsSum );
+      __m256i const firstBytes    = _mm256_setr_epi8 ( 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                       0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 );
+
+      std::size_t validCount = 0;
+      std::size_t i          = 0;
+      for( ; i + 8 <= count; i += 8 )
+      {
+        std::string_view codes[8];
+        for( std::size_t k = 0; k < 8; ++k )  codes[k] = codeAt( i + k );
+        if( i + prefetchDistance + 8 <= count )
+        {
+          for( std::size_t k = 0; k < 8; ++k )  _mm_prefetch( codeAt( i + prefetchDistance + k ).data(), _MM_HINT_T0 );
+        }
+
+        __m256i sums[4];
+        for( std::size_t k = 0; k < 4; ++k )
+        {
+          __m256i digits  = _mm256_sub_epi8( _mm256_set_m128i( loadCode  ( codes[k + 4] ), loadCode  ( codes[k] ) ), zeroCharacter );
+          __m256i weights =                  _mm256_set_m128i( weightsFor( codes[k + 4].size() ), weightsFor( codes[k].size() ) );
+
+          __m256i nonDigits = _mm256_xor_si256( _mm256_cmpeq_epi8( _mm256_max_epu8( digits, nine ), nine ), _mm256_set1_epi8( -1 ) );
+          sums[k] = _mm256_madd_epi16( _mm256_maddubs_epi16( _mm256_or_si256( digits, nonDigits ), weights ), ones );
+        }
+
+        __m256i totals = _mm256_hadd_epi32( _mm256_hadd_epi32( sums[0], sums[1] ), _mm256_hadd_epi32( sums[2], sums[3] ) );   // Code k's in element k
+        __m256i tens   = _mm256_mullo_epi32( _mm256_srli_epi32( _mm256_mullo_epi32( totals, tenthScaled ), 19 ), ten );
+
+        __m256i badCheckDigit = _mm256_andnot_si256( _mm256_cmpeq_epi32( totals, tens ), _mm256_set1_epi32( 3 ) );
+        __m256i notDigits     = _mm256_cmpgt_epi32( totals, digitsLimit );
+        __m256i badLength     = _mm256_cmpgt_epi32( totals, lengthLimit );
+        __m256i status        = _mm256_blendv_epi8( badCheckDigit, _mm256_set1_epi32( 2 ), notDigits );
+        status                = _mm256_blendv_epi8( status,        _mm256_set1_epi32( 1 ), badLength );
+
+        // The low byte of each status, gathered into the first eight bytes
+        __m256i packed = _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( status, firstBytes ), _mm256_setr_epi32( 0, 4, 0, 0, 0, 0, 0, 0 ) );
+        _mm_storel_epi64( reinterpret_cast<__m128i *>( statuses + i ), _mm256_castsi256_si128( packed ) );
+
+        auto validBits = static_cast<unsigned>( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( status, _mm256_setzero_si256() ) ) ) );
+        validCount += static_cast<std::size_t>( std::popcount( validBits ) );
+      }
+
+      if( i < count )  validCount += validateScalar( count - i, [&]( std::size_t j ) { return codeAt( i + j ); }, statuses + i );
+      return validCount;
+    }
+  #endif
+
+
+
+
+  /*****************************************************************************
+  **  Dispatch
+  *****************************************************************************/
+  bool cpuSupports( UpcKernelIsa isa ) noexcept
+  {
+    switch( isa )
+    {
+      case UpcKernelIsa::scalar:  return true;
+      #ifdef UPC_VALIDATION_HAVE_AVX2
+        case UpcKernelIsa::avx2:  return __builtin_cpu_supports( "avx2" );
+      #else
+        case UpcKernelIsa::avx2:  return false;
+      #endif
+    }
+    return false;
+  }
+
+
+  std::atomic<UpcKernelIsa> & activeIsa() noexcept
+  {
+    static std::atomic<UpcKernelIsa> isa{ cpuSupports( UpcKernelIsa::avx2 ) ? UpcKernelIsa::avx2 : UpcKernelIsa::scalar };
+    return isa;
+  }
+
+
+  template< typename CodeAt >
+  std::size_t validateBatch( std::size_t count, CodeAt codeAt, UpcStatus * statuses ) noexcept
+  {
+    #ifdef UPC_VALIDATION_HAVE_AVX2
+      if( activeUpcKernelIsa() == UpcKernelIsa::avx2 )  return validateAvx2( count, codeAt, statuses );
+    #endif
+    return validateScalar( count, codeAt, statuses );
+  }
+}    // unnamed, anonymous namespace
+
+
+
+
+/*******************************************************************************
+**  Kernel selection
+*******************************************************************************/
+
+UpcKernelIsa activeUpcKernelIsa() noexcept
+{ return activeIsa().load( std::memory_order_relaxed ); }
+
+
+bool setUpcKernelIsa( UpcKernelIsa isa ) noexcept
+{
+  if( !cpuSupports( isa ) )  return false;
+  activeIsa().store( isa, std::memory_order_relaxed );
+  return true;
+}
+
+
+
+
+/*******************************************************************************
+**  Validation
+*******************************************************************************/
+
+char const * describe( UpcStatus status ) noexcept
+{
+  switch( status )
+  {
+    case UpcStatus::valid:          return "valid";
+    case UpcStatus::badLength:      return "not 12 or 14 characters long";
+    case UpcStatus::notDigits:      return "contains a character that isn't a digit";
+    case UpcStatus::badCheckDigit:  return "wrong check digit";
+  }
+  return "unknown UPC status";
+}
+
+
+UpcStatus validateUpc( std::string_view upcCode ) noexcept
+{ return validateScalar( upcCode ); }
+
+
+std::size_t validateUpcs( std::span<std::string_view const> upcCodes, std::span<UpcStatus> statuses ) noexcept
+{ return validateBatch( upcCodes.size(), [&]( std::size_t i ) { return upcCodes[i]; }, statuses.data() ); }
+
+
+std::size_t validateUpcs( std::span<GroceryItem const> items, std::span<UpcStatus> statuses ) noexcept
+{ return validateBatch( items.size(), [&]( std::size_t i ) { return std::string_view( items[i].upcCode() ); }, statuses.data() ); }
+
+
+
+
+/*******************************************************************************
+**  Normalization
+*******************************************************************************/
+
+std::optional<std::string> toGtin14( std::string_view upcCode )
+{
+  if( validateUpc( upcCode ) != UpcStatus::valid )  return std::nullopt;
+  if( upcCode.size() == upcALength )                return "00" + std::string( upcCode );
+  return std::string( upcCode );
+}
+
+
+std::size_t normalizeUpcs( std::span<GroceryItem> items, std::size_t * invalidCount )
+{
+  // Validated a chunk at a time, so the statuses stay in L1 and the codes are still in cache when they're rewritten
+  constexpr std::size_t chunkSize = 256;
+
+  std::array<UpcStatus, chunkSize> statuses;
+  std::size_t                      rewritten = 0,  invalid = 0;
+  for( std::size_t first = 0; first < items.size(); first += chunkSize )
+  {
+    auto chunk = items.subspan( first, std::min( chunkSize, items.size() - first ) );
+    invalid += chunk.size() - validateUpcs( chunk, statuses );
+
+    for( std::size_t i = 0; i < chunk.size(); ++i )
+    {
+      if( statuses[i] == UpcStatus::valid && chunk[i].upcCode().size() == upcALength )
+      {
+        chunk[i].upcCode( "00" + chunk[i].upcCode() );
+        ++rewritten;
+      }
+    }
+  }
+  if( invalidCount != nullptr )  *invalidCount += invalid;
+  return rewritten;
+}
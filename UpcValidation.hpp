@@ -0,0 +1,68 @@
+#pragma once                                                                  // include guard
+
+#include <cstddef>                                                            // size_t
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// GS1 validation of the 12-digit (UPC-A, a.k.a. GTIN-12) and 14-digit (GTIN-14) codes GroceryItem carries, one at a time or in
+// batches fast enough to run over every record a load produces.
+//
+// A code is valid when it is exactly 12 or 14 decimal digits and its last digit is its GS1 check digit:  weighting the digits 3, 1,
+// 3, 1, ... from the left (for an even length, the same as 1, 3, 1, 3, ... from the check digit leftward), the weighted sum of all
+// of them, check digit included, is a multiple of 10.  Ex: 036000291452 is valid, 036000291453 is not.
+//
+// Because the weights run from the right, prefixing zeros never changes a code's check digit, and a UPC-A code and the GTIN-14 that
+// is its zero-padded form ("00" + code) name the same product.  GroceryItem's operator<=> compares codes as plain strings, so the
+// two spellings sort apart and compare unequal until they're normalized:  normalizeUpcs() rewrites the 12-digit spelling into the
+// 14-digit one, after which equivalent codes compare equal everywhere operator<=> (and CatalogSort, PackedUpc, UpcIndex, ...) is
+// used.  The bulk loaders do the same when asked to (UpcHandling::normalize, in CatalogLoader.hpp);  otherwise codes are kept, and
+// compared, exactly as read.
+//
+// The batch kernel is picked at run time:  AVX2 when the CPU has it, two codes per instruction, otherwise a scalar loop.
+
+enum class UpcStatus : unsigned char
+{
+  valid,
+  badLength,                                                                  // Not 12 or 14 characters
+  notDigits,                                                                  // The right length, but something other than '0' - '9' in it
+  badCheckDigit                                                               // 12 or 14 digits, but the last isn't the check digit of the others
+};
+
+char const * describe( UpcStatus status ) noexcept;                            // A short, human readable explanation (Ex: "wrong check digit")
+
+
+enum class UpcKernelIsa { scalar, avx2 };
+
+UpcKernelIsa activeUpcKernelIsa() noexcept;
+bool         setUpcKernelIsa   ( UpcKernelIsa isa ) noexcept;                  // Returns false, changing nothing, if this CPU can't run isa
+
+
+
+
+// One code
+UpcStatus validateUpc( std::string_view upcCode ) noexcept;
+
+// Batches:  statuses[i] is set to the status of upcCodes[i] (or of items[i].upcCode()), and the number of valid codes is returned.
+// statuses must hold at least as many entries as there are codes.  The views may point straight into a parsed buffer (Ex:
+// RecordView::upcCode.text) - up to 16 bytes from the start of each 12 or 14-digit code are read, but never past the end of the
+// page the code ends in.
+std::size_t validateUpcs( std::span<std::string_view const> upcCodes, std::span<UpcStatus> statuses ) noexcept;
+std::size_t validateUpcs( std::span<GroceryItem      const> items,    std::span<UpcStatus> statuses ) noexcept;
+
+
+
+
+// The GTIN-14 form of a valid code:  a 12-digit code with "00" prefixed, a 14-digit code as is.  Empty if upcCode isn't valid.
+std::optional<std::string> toGtin14( std::string_view upcCode );
+
+// Rewrites every item whose code is a valid UPC-A code into its GTIN-14 form, returning how many were rewritten.  Codes that aren't
+// valid are left exactly as they are - a malformed 12-character code isn't known to be a UPC-A code at all - and, if invalidCount
+// isn't null, counted into it.
+std::size_t normalizeUpcs( std::span<GroceryItem> items, std::size_t * invalidCount = nullptr );
@@ -0,0 +1,60 @@
+// Compares the memory-mapped bulk loader against a loop over operator>>, after first checking that both produce identical items.
+//
+// Usage:  CatalogLoaderBenchmark [recordCount = 1000000] [catalogFile]
+//         Without catalogFile a synthetic catalog is generated and written to a temporary file.
+
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t           count = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 1'000'000;
+  std::filesystem::path path  = argc > 2 ? std::filesystem::path( argv[2] )
+                                         : std::filesystem::temp_directory_path() / "CatalogLoaderBenchmark.txt";
+  if( argc <= 2 )  std::ofstream( path, std::ios::binary ) << toCatalogText( makeSyntheticCatalog( count ) );
+
+  std::vector<GroceryItem> expected;
+  double streamSeconds = secondsToRun( [&]
+  {
+    std::ifstream file( path, std::ios::binary );
+    GroceryItem   item;
+    while( file >> item )  expected.push_back( std::move( item ) );
+  } );
+
+  CatalogLoadResult loaded;
+  double bulkSeconds = secondsToRun( [&] { loaded = loadCatalogFile( path ); } );
+
+  if( loaded.items.size() != expected.size() )
+  {
+    std::cerr << "Mismatch:  operator>> read " << expected.size() << " records, loadCatalogFile() read " << loaded.items.size() << '\n';
+    return EXIT_FAILURE;
+  }
+  for( std::size_t i = 0; i < expected.size(); ++i )
+  {
+    if( !identical( expected[i], loaded.items[i] ) )
+    {
+      std::cerr << "Mismatch at record " << i << ":\n  " << expected[i] << "\n  " << loaded.items[i] << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  if( !loaded )  std::cout << "Both readers stopped at line " << loaded.errorLine << ": " << describe( loaded.status ) << '\n';
+
+  auto records = static_cast<double>( expected.size() );
+  std::cout << "records:                 " << expected.size()                 << '\n'
+            << "operator>>  records/sec: " << records / streamSeconds         << '\n'
+            << "bulk loader records/sec: " << records / bulkSeconds           << '\n'
+            << "speedup:                 " << streamSeconds / bulkSeconds     << "x\n";
+
+  if( argc <= 2 )  std::filesystem::remove( path );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+// Writes a set of supplier catalogs that overlap the way real ones do - some items listed by two suppliers, identically, at a price
+// within epsilon, or at a different price - and merges them with mergeCatalogs() under a capped memory budget.
+//
+// First, on a small set, checks every duplicate policy against sorting everything in memory and collapsing duplicates by hand, with
+// a budget so small the runs need two merge passes and with one large enough to need no runs at all, and that neither a malformed
+// record nor a failed write touches an existing output.  Then merges the full set with each policy, reporting throughput and the peak
+// resident set, also as what the merge added to what was resident before it started.
+//
+// Usage:  CatalogMergeBenchmark [recordCount = 4000000] [suppliers = 24] [memoryBudgetMiB = 64]
+
+#include <algorithm>                                                  // stable_sort(), min()
+#include <compare>                                                    // strong_order()
+#include <csignal>                                                    // signal(), SIGXFSZ
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>                                                   // make_move_iterator(), istreambuf_iterator
+#include <numeric>                                                    // iota()
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <malloc.h>                                                   // malloc_trim()
+#include <sys/resource.h>                                             // setrlimit(), RLIMIT_FSIZE
+
+#include "CatalogLoader.hpp"
+#include "CatalogMerge.hpp"
+#include "CatalogWriter.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  constexpr std::size_t chunkSize = 50'000;
+
+  char const * name( DuplicatePolicy policy )
+  {
+    switch( policy )
+    {
+      case DuplicatePolicy::keepAll:          return "keep all         ";
+      case DuplicatePolicy::keepFirst:        return "keep first       ";
+      case DuplicatePolicy::keepLowestPrice:  return "keep lowest price";
+    }
+    return "?";
+  }
+
+
+  // Supplier s lists chunks of chunkSize distinct items.  Its even chunks are its own; each odd chunk repeats the chunk before it
+  // from the next supplier over, a quarter of those items at a price within epsilon, a quarter a cent dearer, the rest identical.
+  std::vector<std::filesystem::path> writeSupplierCatalogs( std::filesystem::path const & directory, std::size_t recordCount, std::size_t suppliers )
+  {
+    std::size_t chunksPerSupplier = std::max<std::size_t>( recordCount / suppliers / chunkSize, 2 );
+    auto        ownChunk          = [&]( std::size_t supplier, std::size_t chunk ) { return makeSyntheticCatalog( chunkSize, 1'000 + supplier * chunksPerSupplier + chunk ); };
+
+    std::vector<std::filesystem::path> paths;
+    for( std::size_t supplier = 0; supplier < suppliers; ++supplier )
+    {
+      paths.push_back( directory / ( "supplier-" + std::to_string( supplier ) + ".txt" ) );
+      CatalogWriter writer( paths.back() );
+      for( std::size_t chunk = 0; chunk < chunksPerSupplier; ++chunk )
+      {
+        if( chunk % 2 == 0 )
+        {
+          writer.write( ownChunk( supplier, chunk ) );
+          continue;
+        }
+
+        auto items = ownChunk( ( supplier + 1 ) % suppliers, chunk - 1 );
+        for( std::size_t i = 0; i < items.size(); ++i )
+        {
+          if( i % 4 == 0 )  items[i].price( items[i].price() + 0.00004 );
+          if( i % 4 == 1 )  items[i].price( items[i].price() + 0.01    );
+        }
+        writer.write( items );
+      }
+      writer.flush();
+    }
+    return paths;
+  }
+
+
+  // The definition, in memory:  the concatenated inputs stably sorted by name, then exact price, and each group of duplicates -
+  // the first item in that order and every following item equal to it - reduced to one
+  std::vector<GroceryItem> mergeInMemory( std::vector<std::filesystem::path> const & inputs, DuplicatePolicy policy )
+  {
+    std::vector<GroceryItem> all;
+    for( auto const & path : inputs )
+    {
+      auto loaded = loadCatalogFile( path );
+      all.insert( all.end(), std::make_move_iterator( loaded.items.begin() ), std::make_move_iterator( loaded.items.end() ) );
+    }
+
+    std::vector<std::size_t> order( all.size() );
+    std::iota( order.begin(), order.end(), std::size_t{ 0 } );
+    std::stable_sort( order.begin(), order.end(), [&]( std::size_t lhs, std::size_t rhs )
+    {
+      auto const & left = all[lhs];  auto const & right = all[rhs];
+      if( left.upcCode()     != right.upcCode()     )  return left.upcCode()     < right.upcCode();
+      if( left.productName() != right.productName() )  return left.productName() < right.productName();
+      if( left.brandName()   != right.brandName()   )  return left.brandName()   < right.brandName();
+      return std::strong_order( left.price(), right.price() ) < 0;
+    } );
+
+    std::vector<GroceryItem> merged;
+    GroceryItem              groupStart;
+    std::size_t              kept = 0;
+    for( std::size_t position = 0; position < order.size(); ++position )
+    {
+      std::size_t i = order[position];
+      if( position > 0 && policy != DuplicatePolicy::keepAll && all[i] == groupStart )
+      {
+        if( policy == DuplicatePolicy::keepFirst && i < kept )  kept = i;
+        continue;
+      }
+      if( position > 0 )  merged.push_back( all[kept] );
+      groupStart = all[i];
+      kept       = i;
+    }
+    if( !order.empty() )  merged.push_back( all[kept] );
+    return merged;
+  }
+
+
+  bool verify( std::filesystem::path const & directory )
+  {
+    auto inputs = writeSupplierCatalogs( directory, 600'000, 6 );
+    auto output = directory / "merged.txt";
+
+    for( auto policy : { DuplicatePolicy::keepAll, DuplicatePolicy::keepFirst, DuplicatePolicy::keepLowestPrice } )
+    {
+      auto expected = mergeInMemory( inputs, policy );
+      for( std::size_t budgetMiB : { 4, 1'024 } )
+      {
+        CatalogMergeOptions options;
+        options.memoryBudget = budgetMiB << 20;
+        options.duplicates   = policy;
+
+        auto result = mergeCatalogs( inputs, output, options );
+        auto merged = loadCatalogFile( output ).items;
+        bool same   = merged.size() == expected.size() && std::equal( merged.begin(), merged.end(), expected.begin(), identical );
+        if( !same || result.recordsWritten != expected.size() || result.recordsRead != result.recordsWritten + result.duplicatesDropped
+                  || ( budgetMiB == 4 ? result.mergePasses < 2 : result.runCount != 0 ) )
+        {
+          std::cerr << "Merge mismatch:  " << name( policy ) << " with a " << budgetMiB << " MiB budget wrote " << merged.size()
+                    << " items in " << result.runCount << " runs and " << result.mergePasses << " passes, " << expected.size() << " expected\n";
+          return false;
+        }
+      }
+      std::cout << "verified " << name( policy ) << ":  " << expected.size() << " of 600000 items kept, the same with 4 MiB and 1 GiB budgets\n";
+    }
+
+    // A malformed record stops the merge before the output is touched
+    std::filesystem::remove( output );
+    std::ofstream( inputs.back(), std::ios::app ) << "\"123\", \"Acme\", \"Bread\", abc\n";
+    auto result = mergeCatalogs( inputs, output );
+    if( result.status != ParseStatus::badPrice || result.errorInput != inputs.size() - 1 || std::filesystem::exists( output ) )
+    {
+      std::cerr << "A malformed input wasn't reported\n";
+      return false;
+    }
+
+    // A write that fails part way through the output - here at a file size limit the runs stay under but the output doesn't - leaves
+    // the previous output as it was, in memory and from runs, with no partial file beside it
+    auto   clean   = std::span( inputs ).first( inputs.size() - 1 );
+    auto   handler = std::signal( SIGXFSZ, SIG_IGN );                   // So writes past the limit fail with EFBIG, not end the process
+    rlimit unlimited;
+    ::getrlimit( RLIMIT_FSIZE, &unlimited );
+    for( std::size_t budgetMiB : { 16, 1'024 } )
+    {
+      std::ofstream( output ) << "previous output\n";
+      CatalogMergeOptions options;
+      options.memoryBudget = budgetMiB << 20;
+
+      rlimit limited = unlimited;
+      limited.rlim_cur = 8 << 20;
+      ::setrlimit( RLIMIT_FSIZE, &limited );
+      bool threw = false;
+      try
+      {
+        mergeCatalogs( clean, output, options );
+      }
+      catch( std::system_error const & )
+      {
+        threw = true;
+      }
+      ::setrlimit( RLIMIT_FSIZE, &unlimited );
+
+      std::ifstream previous( output );
+      std::string   text( std::istreambuf_iterator<char>( previous ), {} );
+      bool          partial = false;
+      for( auto const & entry : std::filesystem::directory_iterator( directory ) )  partial = partial || entry.path().filename().string().contains( ".partial" );
+      if( !threw || text != "previous output\n" || partial )
+      {
+        std::signal( SIGXFSZ, handler );
+        std::cerr << "A failed write with a " << budgetMiB << " MiB budget " << ( threw ? "changed the output or left a partial file\n" : "wasn't reported\n" );
+        return false;
+      }
+    }
+    std::signal( SIGXFSZ, handler );
+    std::filesystem::remove( output );
+    std::cout << "verified a failed write leaves the output untouched\n";
+
+    for( auto const & path : inputs )  std::filesystem::remove( path );
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t recordCount = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 4'000'000;
+  std::size_t suppliers   = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 24;
+  std::size_t budgetMiB   = argc > 3 ? std::strtoull( argv[3], nullptr, 10 ) : 64;
+
+  auto directory = std::filesystem::temp_directory_path() / "CatalogMergeBenchmark";
+  std::filesystem::create_directories( directory );
+
+  if( !verify( directory ) )  return EXIT_FAILURE;
+
+  auto        inputs     = writeSupplierCatalogs( directory, recordCount, suppliers );
+  auto        output     = directory / "merged.txt";
+  std::size_t inputBytes = 0;
+  for( auto const & path : inputs )  inputBytes += std::filesystem::file_size( path );
+  std::cout << "\n" << inputs.size() << " supplier catalogs, " << inputBytes / ( 1 << 20 ) << " MiB of text, merged with a " << budgetMiB << " MiB budget\n";
+
+  for( auto policy : { DuplicatePolicy::keepFirst, DuplicatePolicy::keepLowestPrice } )
+  {
+    CatalogMergeOptions options;
+    options.memoryBudget = budgetMiB << 20;
+    options.duplicates   = policy;
+
+    malloc_trim( 0 );                                                 // So memory freed since isn't counted as the merge's
+    std::size_t        baseline = residentSetBytes();
+    bool               peakKnown = resetPeakResidentSet();
+    CatalogMergeResult result;
+    double             seconds  = secondsToRun( [&] { result = mergeCatalogs( inputs, output, options ); } );
+    std::size_t        peak     = peakResidentSetBytes();
+
+    std::cout << name( policy ) << "   records: " << result.recordsRead << " in, " << result.recordsWritten << " out"
+              << "   runs: " << result.runCount << "   passes: " << result.mergePasses
+              << "   records/sec: " << static_cast<double>( result.recordsRead ) / seconds
+              << "   MB/s: " << static_cast<double>( inputBytes ) / seconds / 1e6;
+    if( peakKnown )  std::cout << "   peak RSS MiB: " << static_cast<double>( peak ) / ( 1 << 20 )
+                               << " (" << static_cast<double>( peak - std::min( peak, baseline ) ) / ( 1 << 20 ) << " over baseline)";
+    std::cout << '\n';
+  }
+
+  std::filesystem::remove_all( directory );
+  return EXIT_SUCCESS;
+}
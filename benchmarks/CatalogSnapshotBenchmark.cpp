@@ -0,0 +1,194 @@
+// Compares restarting from a binary snapshot against re-reading the text catalog, after checking that a snapshot reads back as
+// exactly the items written (long UPC codes and an empty catalog included), that verify() accepts it, that damage is caught, and that
+// a failed rewrite leaves the previous snapshot intact.
+//
+// Usage:  CatalogSnapshotBenchmark [itemCount = 2000000]
+//         CatalogSnapshotBenchmark --verify [itemCount = 100000]            The checks alone, for ctest
+
+#include <algorithm>                                                  // sort(), equal()
+#include <csignal>                                                    // signal(), SIGXFSZ
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>                                                  // runtime_error
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/resource.h>                                             // setrlimit(), RLIMIT_FSIZE
+
+#include "CatalogLoader.hpp"
+#include "CatalogSnapshot.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  bool sameItems( std::vector<GroceryItem> const & lhs, std::vector<GroceryItem> const & rhs )
+  {
+    return lhs.size() == rhs.size()
+        && std::equal( lhs.begin(), lhs.end(), rhs.begin(), []( auto const & a, auto const & b ) { return identical( a, b ); } );
+  }
+
+
+  bool verifyFormat( std::filesystem::path const & path )
+  {
+    // UPC codes on both sides of the 15 character inline limit, empty fields, and text needing no escaping in binary form
+    std::vector<GroceryItem> items{ { "Milk",                     "Acme",          "012345678905",          3.49 },
+                                    { "",                         "",              "",                      0.0  },
+                                    { "Eggs",                     "Farm \"Fresh\"", "123456789012345",       2.99 },
+                                    { "Bread",                    "Bakery\nCo",    "1234567890123456",      4.25 },
+                                    { std::string( 10'000, 'x' ), "Big",           std::string( 300, '7' ), -1.5 } };
+    for( auto const & catalog : { items, std::vector<GroceryItem>{} } )
+    {
+      CatalogSnapshot::write( path, catalog );
+      CatalogSnapshot snapshot( path );
+      if( !snapshot.verify() || !sameItems( snapshot.toItems(), catalog ) )  return false;
+    }
+
+    // A write that fails part way - here at a file size limit the new snapshot passes but the old one doesn't - throws and leaves the
+    // old snapshot whole, both at path and as mapped by a reader that had it open, with no partial file beside it
+    CatalogSnapshot::write( path, items );
+    {
+      CatalogSnapshot reader( path );
+      auto            larger = items;
+      larger.insert( larger.end(), items.begin(), items.end() );
+
+      auto   handler = std::signal( SIGXFSZ, SIG_IGN );                 // So writes past the limit fail with EFBIG, not end the process
+      rlimit unlimited;
+      ::getrlimit( RLIMIT_FSIZE, &unlimited );
+      rlimit limited = unlimited;
+      limited.rlim_cur = std::filesystem::file_size( path ) + 1'000;
+      ::setrlimit( RLIMIT_FSIZE, &limited );
+      bool threw = false;
+      try
+      {
+        CatalogSnapshot::write( path, larger );
+      }
+      catch( std::system_error const & )
+      {
+        threw = true;
+      }
+      ::setrlimit( RLIMIT_FSIZE, &unlimited );
+      std::signal( SIGXFSZ, handler );
+
+      bool partial = false;
+      for( auto const & entry : std::filesystem::directory_iterator( path.parent_path() ) )
+      {
+        partial = partial || entry.path().filename().string().starts_with( '.' + path.filename().string() + ".partial" );
+      }
+      if( !threw || partial || !reader.verify() || !sameItems( reader.toItems(), items ) || !sameItems( CatalogSnapshot( path ).toItems(), items ) )  return false;
+    }
+
+    // A flipped byte fails verification, and a truncated file fails to open
+    CatalogSnapshot::write( path, items );
+    auto size = std::filesystem::file_size( path );
+    {
+      std::fstream file( path, std::ios::in | std::ios::out | std::ios::binary );
+      file.seekp( static_cast<std::streamoff>( size - 20 ) );
+      file.put( '#' );
+    }
+    if( CatalogSnapshot( path ).verify() )  return false;
+
+    std::filesystem::resize_file( path, size / 2 );
+    try
+    {
+      CatalogSnapshot truncated( path );
+      return false;
+    }
+    catch( std::runtime_error const & )
+    {}
+
+    std::filesystem::remove( path );
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly = verifyOnly( argc, argv );
+  std::size_t count      = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 100'000 : 2'000'000;
+
+  auto textPath     = std::filesystem::temp_directory_path() / "CatalogSnapshotBenchmark.txt";
+  auto snapshotPath = std::filesystem::temp_directory_path() / "CatalogSnapshotBenchmark.snapshot";
+
+  if( !verifyFormat( snapshotPath ) )
+  {
+    std::cerr << "CatalogSnapshot failed its format checks\n";
+    return EXIT_FAILURE;
+  }
+
+  if( checksOnly )
+  {
+    auto items = makeSyntheticCatalog( count );
+    std::ofstream( textPath, std::ios::binary ) << toCatalogText( items );
+    CatalogSnapshot::write( snapshotPath, items );
+
+    bool same;
+    {
+      CatalogSnapshot snapshot( snapshotPath );
+      same = snapshot.verify() && sameItems( snapshot.toItems(), loadCatalogFile( textPath ).items );
+    }
+    std::filesystem::remove( textPath );
+    std::filesystem::remove( snapshotPath );
+    if( !same )
+    {
+      std::cerr << "The snapshot does not hold the same items as the text catalog\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << "verified the snapshot format and a " << count << " item snapshot against the text catalog\n";
+    return EXIT_SUCCESS;
+  }
+
+  {
+    auto items = makeSyntheticCatalog( count );
+    std::ofstream( textPath, std::ios::binary ) << toCatalogText( items );
+    double writeSeconds = secondsToRun( [&] { CatalogSnapshot::write( snapshotPath, items ); } );
+    std::cout << "items:                                " << count << '\n'
+              << "snapshot write                  ms:   " << writeSeconds * 1e3 << "   ("
+              << std::filesystem::file_size( snapshotPath ) / 1e6 << " MB vs " << std::filesystem::file_size( textPath ) / 1e6 << " MB text)\n";
+  }
+
+  // Both files are in the page cache by now, so these are warm restarts - the case where the text loader is at its best
+  CatalogLoadResult text;
+  double textSeconds     = secondsToRun( [&] { text = loadCatalogFile        ( textPath ); } );
+  double parallelSeconds = secondsToRun( [&] { text = loadCatalogFileParallel( textPath ); } );
+
+  std::vector<double> openSeconds;
+  double              checksum = 0.0;
+  for( int i = 0; i < 21; ++i )
+  {
+    openSeconds.push_back( secondsToRun( [&]
+    {
+      CatalogSnapshot snapshot( snapshotPath );
+      if( !snapshot.empty() )  checksum += snapshot.price( snapshot.size() / 2 ) + static_cast<double>( snapshot.upcCode( 0 ).size() );
+    } ) );
+  }
+  std::sort( openSeconds.begin(), openSeconds.end() );
+
+  CatalogSnapshot          snapshot( snapshotPath );
+  bool                     verified;
+  std::vector<GroceryItem> restored;
+  double verifySeconds  = secondsToRun( [&] { verified = snapshot.verify();  } );
+  double toItemsSeconds = secondsToRun( [&] { restored = snapshot.toItems(); } );
+
+  std::filesystem::remove( textPath );
+  std::filesystem::remove( snapshotPath );
+  if( !verified || !sameItems( restored, text.items ) )
+  {
+    std::cerr << "The snapshot does not hold the same items as the text catalog\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "text loader (loadCatalogFile)   ms:   " << textSeconds     * 1e3 << '\n'
+            << "text loader (parallel)          ms:   " << parallelSeconds * 1e3 << '\n'
+            << "snapshot open, median           ms:   " << openSeconds[openSeconds.size() / 2] * 1e3 << '\n'
+            << "snapshot verify()               ms:   " << verifySeconds   * 1e3 << '\n'
+            << "snapshot toItems()              ms:   " << toItemsSeconds  * 1e3 << '\n'
+            << "(checksum " << checksum << ")\n";
+  return EXIT_SUCCESS;
+}
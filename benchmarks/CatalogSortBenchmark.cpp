@@ -0,0 +1,156 @@
+// Times sortCatalog() against std::sort and std::sort( std::execution::par ) on the same shuffled catalog, after checking on several
+// catalogs - one whose UPC codes all pack, one with codes that don't, and, large and small, ones with codes that don't because they
+// hold bytes of 0x80 and up - that sortCatalog() and sortedOrder() give exactly what std::stable_sort gives for "operator<=> on the
+// names, then exact price", and that the result is sorted by operator<.
+//
+// Both check catalogs have items added that tie with others on their UPC code and product name prefix, and items that differ from
+// others only in price, by less than epsilon (including -0.0 and +0.0), so the tie order is exercised.
+//
+// Usage:  CatalogSortBenchmark [itemCount = 2000000]
+//         CatalogSortBenchmark --verify                                     The checks alone, for ctest
+
+#include <algorithm>                                                  // sort(), stable_sort(), is_sorted(), shuffle()
+#include <cmath>                                                      // nextafter()
+#include <compare>                                                    // strong_order()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <execution>                                                  // par
+#include <iostream>
+#include <numeric>                                                    // iota()
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatalogSort.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  bool namesThenExactPrice( GroceryItem const & lhs, GroceryItem const & rhs )
+  {
+    if( auto cmp = lhs.upcCode()     <=> rhs.upcCode();      cmp != 0 )  return cmp < 0;
+    if( auto cmp = lhs.productName() <=> rhs.productName();  cmp != 0 )  return cmp < 0;
+    if( auto cmp = lhs.brandName()   <=> rhs.brandName();    cmp != 0 )  return cmp < 0;
+    return std::strong_order( lhs.price(), rhs.price() ) < 0;
+  }
+
+
+  enum class UpcCodes { packable, unpackable, nonAscii };
+
+
+  // A synthetic catalog plus near-duplicates, shuffled.  With unpackable codes, every 50th UPC code is one PackedUpc can't pack; with
+  // non-ASCII codes, every third starts with a UTF-8 "é", so the keys' high halves span the top bit.
+  std::vector<GroceryItem> makeCheckCatalog( std::size_t count, UpcCodes upcCodes )
+  {
+    std::vector<GroceryItem> items = makeSyntheticCatalog( count, 7 );
+    std::mt19937_64          random( 11 );
+
+    if( upcCodes == UpcCodes::nonAscii )
+    {
+      for( std::size_t i = 0; i < items.size(); i += 3 )  items[i].upcCode( "\xC3\xA9" + items[i].upcCode() );
+    }
+    if( upcCodes == UpcCodes::unpackable )
+    {
+      for( std::size_t i = 0; i < items.size(); i += 50 )
+      {
+        switch( i / 50 % 4 )
+        {
+          case 0:  items[i].upcCode( items[i].upcCode() + "X"                  );  break;
+          case 1:  items[i].upcCode( "0000000000000000000" + items[i].upcCode() );  break;   // Longer than 18 digits
+          case 2:  items[i].upcCode( items[i].upcCode().substr( 0, 16 ) + '\0' );  break;
+          case 3:  items[i].upcCode( ""                                         );  break;
+        }
+      }
+    }
+
+    std::size_t const originals = items.size();
+    for( std::size_t i = 0; i < originals; i += 20 )
+    {
+      GroceryItem const & item = items[i];
+      switch( i / 20 % 5 )
+      {
+        case 0:  items.emplace_back( item.productName(), item.brandName(), item.upcCode(), std::nextafter( item.price(), 1e9 ) );       break;
+        case 1:  items.emplace_back( item.productName(), item.brandName(), item.upcCode(), item.price() );                             break;
+        case 2:  items.emplace_back( item.productName() + " Family Size", item.brandName(), item.upcCode(), item.price() );            break;
+        case 3:  items.emplace_back( item.productName(), item.brandName() + "!", item.upcCode(), item.price() - 1e-12 );              break;
+        case 4:  items.emplace_back( item.productName(), item.brandName(), item.upcCode(), 0.0 );
+                 items.emplace_back( item.productName(), item.brandName(), item.upcCode(), -0.0 );                                     break;
+      }
+    }
+
+    std::shuffle( items.begin(), items.end(), random );
+    return items;
+  }
+
+
+  bool verify( std::vector<GroceryItem> const & items, char const * name )
+  {
+    std::vector<GroceryItem> expected = items;
+    std::stable_sort( expected.begin(), expected.end(), namesThenExactPrice );
+
+    std::vector<std::size_t> expectedOrder( items.size() );
+    std::iota( expectedOrder.begin(), expectedOrder.end(), std::size_t{ 0 } );
+    std::stable_sort( expectedOrder.begin(), expectedOrder.end(),
+                      [&]( std::size_t lhs, std::size_t rhs ) { return namesThenExactPrice( items[lhs], items[rhs] ); } );
+
+    for( unsigned threads : { 1u, 4u } )
+    {
+      std::vector<GroceryItem> sorted = items;
+      sortCatalog( sorted, threads );
+
+      bool same = sorted.size() == expected.size() && std::is_sorted( sorted.begin(), sorted.end() );
+      for( std::size_t i = 0; same && i < sorted.size(); ++i )  same = identical( sorted[i], expected[i] );
+
+      if( !same || sortedOrder( items, threads ) != expectedOrder )
+      {
+        std::cerr << "sortCatalog() differs from std::stable_sort on the " << name << " catalog with " << threads << " thread(s)\n";
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly = verifyOnly( argc, argv );
+  std::size_t count      = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 2'000'000;
+
+  std::vector<GroceryItem> empty;
+  sortCatalog( empty );
+  if( !verify( makeCheckCatalog( 200'000, UpcCodes::packable   ), "packable"          )
+   || !verify( makeCheckCatalog( 200'000, UpcCodes::unpackable ), "unpackable"        )
+   || !verify( makeCheckCatalog( 200'000, UpcCodes::nonAscii   ), "non-ASCII"         )
+   || !verify( makeCheckCatalog( 100,     UpcCodes::nonAscii   ), "small non-ASCII"   )
+   || !verify( makeCheckCatalog( 50,      UpcCodes::packable   ), "small"             ) )  return EXIT_FAILURE;
+  if( checksOnly )
+  {
+    std::cout << "verified sortCatalog() and sortedOrder() against std::stable_sort\n";
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<GroceryItem> items = makeSyntheticCatalog( count );
+  std::shuffle( items.begin(), items.end(), std::mt19937_64( 3 ) );
+
+  // Each sort gets a fresh copy, whose strings, like a freshly loaded catalog's, lie in memory in the order of the items
+  auto timeSort = [&]( auto && sort )
+  {
+    std::vector<GroceryItem> copy = items;
+    return secondsToRun( [&] { sort( copy ); } );
+  };
+
+  double stdSort      = timeSort( []( std::vector<GroceryItem> & v ) { std::sort( v.begin(), v.end() ); } );
+  double parallelSort = timeSort( []( std::vector<GroceryItem> & v ) { std::sort( std::execution::par, v.begin(), v.end() ); } );
+  double radixSort    = timeSort( []( std::vector<GroceryItem> & v ) { sortCatalog( v ); } );
+  double orderOnly    = timeSort( []( std::vector<GroceryItem> & v ) { auto order = sortedOrder( v ); } );
+
+  std::cout << "items: " << count << '\n'
+            << "std::sort                  ms: " << stdSort      * 1e3 << '\n'
+            << "std::sort( par )           ms: " << parallelSort * 1e3 << '\n'
+            << "sortCatalog()              ms: " << radixSort    * 1e3 << "   (" << stdSort / radixSort << "x std::sort)\n"
+            << "sortedOrder()              ms: " << orderOnly    * 1e3 << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+// Fuzzes CatalogWriter and appendRecord() against the stream operators, then compares export throughput of an operator<< loop
+// through std::ofstream with CatalogWriter.
+//
+// The fuzz uses random field text (every byte value, with quotes, backslashes, whitespace and separators made common, and some
+// fields far larger than the writer's buffer) and random prices, and checks that
+//   o)  appendRecord() with PriceFormat::stream is byte for byte what operator<< writes
+//   o)  appendRecord() with PriceFormat::shortest reads back through operator>> as an identical item, price bits included
+//   o)  a file written by CatalogWriter reads back through operator>> as exactly the items written
+// and that a failed write leaves nothing buffered to be sent again.
+//
+// Usage:  CatalogWriterBenchmark [itemCount = 2000000] [fuzzRecords = 200000]
+//         CatalogWriterBenchmark --verify [itemCount = 20000] [fuzzRecords = 200000]      The checks alone, for ctest
+
+#include <algorithm>                                                  // equal()
+#include <cfloat>                                                     // DBL_MIN
+#include <cmath>                                                      // isfinite(), abs()
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <cstring>                                                    // memcpy()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>                                                   // istreambuf_iterator
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "CatalogWriter.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  std::string randomField( std::mt19937_64 & random )
+  {
+    static constexpr char common[] = "\"\\ ,\t\n";
+
+    std::size_t length = random() % 100 == 0 ? 5'000 + random() % 20'000 : random() % 24;
+    std::string field( length, '\0' );
+    for( auto & c : field )
+    {
+      auto pick = random() % 8;
+      c = pick == 0 ? common[random() % ( sizeof common - 1 )]
+        : pick == 1 ? static_cast<char>( random() % 256 )
+        :             static_cast<char>( 'a' + random() % 26 );
+    }
+    return field;
+  }
+
+
+  // Prices operator>> can read back:  finite and not subnormal.  Mostly whole cents, some arbitrary bit patterns.
+  double randomPrice( std::mt19937_64 & random )
+  {
+    if( random() % 4 != 0 )  return static_cast<double>( static_cast<std::int64_t>( random() % 20'000'000 ) - 1'000'000 ) / 100.0;
+    while( true )
+    {
+      double        price;
+      std::uint64_t bits = random();
+      std::memcpy( &price, &bits, sizeof price );
+      if( std::isfinite( price ) && ( price == 0.0 || std::abs( price ) >= DBL_MIN ) )  return price;
+    }
+  }
+
+
+  std::vector<GroceryItem> readBack( std::filesystem::path const & path )
+  {
+    std::ifstream            file( path );
+    std::vector<GroceryItem> items;
+    for( GroceryItem item;  file >> item; )  items.push_back( item );
+    return items;
+  }
+
+
+  bool fuzz( std::size_t recordCount )
+  {
+    std::mt19937_64          random( 2024 );
+    std::vector<GroceryItem> items;
+    for( std::size_t i = 0; i < recordCount; ++i )  items.emplace_back( randomField( random ), randomField( random ), randomField( random ), randomPrice( random ) );
+
+    for( auto const & item : items )
+    {
+      std::ostringstream streamed;
+      streamed << item;
+
+      std::string record;
+      appendRecord( record, item, PriceFormat::stream );
+      if( record != streamed.str() )
+      {
+        std::cerr << "appendRecord() differs from operator<<:\n  " << record << "\n  " << streamed.str() << '\n';
+        return false;
+      }
+
+      record.clear();
+      appendRecord( record, item );
+      std::istringstream reread( record );
+      GroceryItem        copy;
+      if( !( reread >> copy ) || !identical( copy, item ) )
+      {
+        std::cerr << "appendRecord() text does not read back as the same item:  " << record << '\n';
+        return false;
+      }
+    }
+
+    // A small buffer, so the oversized fields go through the in-place writev path and the rest through frequent flushes
+    auto path = std::filesystem::temp_directory_path() / "CatalogWriterBenchmark-fuzz.txt";
+    {
+      CatalogWriter writer( path, 4 * 1024 );
+      writer.write( items );
+      writer.flush();
+      if( writer.bytesWritten() != std::filesystem::file_size( path ) )
+      {
+        std::cerr << "CatalogWriter::bytesWritten() disagrees with the file size\n";
+        return false;
+      }
+    }
+    auto reread = readBack( path );
+    std::filesystem::remove( path );
+
+    if( reread.size() != items.size() )
+    {
+      std::cerr << "CatalogWriter output read back " << reread.size() << " of " << items.size() << " items\n";
+      return false;
+    }
+    for( std::size_t i = 0; i < items.size(); ++i )
+    {
+      if( !identical( reread[i], items[i] ) )
+      {
+        std::cerr << "CatalogWriter output differs at record " << i << '\n';
+        return false;
+      }
+    }
+
+    std::cout << "fuzzed " << recordCount << " records against operator<< and operator>>\n";
+    return true;
+  }
+
+
+  // A write that fails drops what was buffered, so a later flush() (or the destructor's) doesn't send it again.  /dev/full fails
+  // every write with ENOSPC.
+  bool failedWritesDiscard()
+  {
+    if( !std::filesystem::exists( "/dev/full" ) )  return true;
+
+    GroceryItem buffered( "Ketchup", "Heinz", "036000291452", 2.29 ),  inPlace( std::string( 10'000, 'x' ), "Heinz", "036000291452", 2.29 );
+    for( auto const * item : { &buffered, &inPlace } )
+    {
+      CatalogWriter writer( "/dev/full", 4 * 1024 );
+      bool          failed = false;
+      try
+      {
+        writer.write( *item );                                        // The oversized field goes out in place, and fails, right here
+        writer.flush();
+      }
+      catch( std::system_error const & )
+      {
+        failed = true;
+      }
+
+      try
+      {
+        writer.flush();
+      }
+      catch( std::system_error const & )
+      {
+        failed = false;
+      }
+      if( !failed )
+      {
+        std::cerr << "CatalogWriter kept the text of a failed write, or didn't report the failure\n";
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly  = verifyOnly( argc, argv );
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 20'000 : 2'000'000;
+  std::size_t fuzzRecords = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) :   200'000;
+
+  if( !fuzz( fuzzRecords ) || !failedWritesDiscard() )  return EXIT_FAILURE;
+
+  std::vector<GroceryItem> items      = makeSyntheticCatalog( count );
+  auto                     streamPath = std::filesystem::temp_directory_path() / "CatalogWriterBenchmark-stream.txt";
+  auto                     writerPath = std::filesystem::temp_directory_path() / "CatalogWriterBenchmark-writer.txt";
+
+  double streamSeconds = secondsToRun( [&]
+  {
+    std::ofstream file( streamPath );
+    for( auto const & item : items )  file << item << '\n';
+  } );
+
+  double writerSeconds = secondsToRun( [&]
+  {
+    CatalogWriter writer( writerPath, CatalogWriter::defaultBufferSize, PriceFormat::stream );
+    writer.write( items );
+    writer.flush();
+  } );
+
+  // With the stream price format the two files must match exactly
+  std::ifstream streamFile( streamPath ),  writerFile( writerPath );
+  bool same = std::string( std::istreambuf_iterator<char>( streamFile ), {} ) == std::string( std::istreambuf_iterator<char>( writerFile ), {} );
+  auto bytes = static_cast<double>( std::filesystem::file_size( writerPath ) );
+
+  double shortestSeconds = secondsToRun( [&]
+  {
+    CatalogWriter writer( writerPath );
+    writer.write( items );
+    writer.flush();
+  } );
+  auto reread     = readBack( writerPath );
+  bool roundTrips = reread.size() == items.size() && std::equal( reread.begin(), reread.end(), items.begin(), []( auto const & lhs, auto const & rhs ) { return identical( lhs, rhs ); } );
+
+  std::filesystem::remove( streamPath );
+  std::filesystem::remove( writerPath );
+  if( !same || !roundTrips )
+  {
+    std::cerr << ( same ? "exact-price export did not read back as the same items\n" : "CatalogWriter output differs from operator<< output\n" );
+    return EXIT_FAILURE;
+  }
+  if( checksOnly )
+  {
+    std::cout << "verified export of " << count << " items both ways\n";
+    return EXIT_SUCCESS;
+  }
+
+  auto records = static_cast<double>( count );
+  std::cout << "items:                                     " << count << '\n'
+            << "operator<< via std::ofstream   items/sec:  " << records / streamSeconds   << "   MB/sec: " << bytes / streamSeconds / 1e6 << '\n'
+            << "CatalogWriter (stream prices)  items/sec:  " << records / writerSeconds   << "   MB/sec: " << bytes / writerSeconds / 1e6 << "  (" << streamSeconds / writerSeconds << "x)\n"
+            << "CatalogWriter (exact prices)   items/sec:  " << records / shortestSeconds << '\n';
+  return EXIT_SUCCESS;
+}
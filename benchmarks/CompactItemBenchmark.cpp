@@ -0,0 +1,123 @@
+// Compares sorting and UPC lookup on std::vector<GroceryItem> against std::vector<CompactGroceryItem>, after checking that both
+// sort into the same order, that every item converts back losslessly, and that prices from $1,000,000 up, where GroceryItem's
+// epsilon reaches a cent, have no compact form.
+//
+// Usage:  CompactItemBenchmark [itemCount = 2000000] [lookupCount = 1000000]
+
+#include <algorithm>                                                  // sort(), lower_bound(), shuffle()
+#include <cmath>                                                      // abs()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CompactGroceryItem.hpp"
+#include "GroceryItem.hpp"
+#include "PackedUpc.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  // Prices either side of $1,000,000, where GroceryItem's relative epsilon reaches a cent:  below it every cent amount has a compact
+  // form and compact items order as GroceryItems do, from it up none has
+  bool priceLimitHolds()
+  {
+    std::vector<double> prices{ 999'999.97, 999'999.98, 999'999.99, 1'000'000.00, 1'000'000.01, 2.5e6, 1e15 };
+    for( double price : std::vector<double>( prices ) )  prices.push_back( -price );
+
+    for( double lhs : prices )
+    {
+      GroceryItem lhsItem( "Caviar", "Acme", "012345678905", lhs );
+      if( CompactGroceryItem::representable( lhsItem ) != ( std::abs( lhs ) < 1'000'000.0 ) )  return false;
+      for( double rhs : prices )
+      {
+        GroceryItem rhsItem( "Caviar", "Acme", "012345678905", rhs );
+        if( !CompactGroceryItem::representable( lhsItem ) || !CompactGroceryItem::representable( rhsItem ) )  continue;
+
+        CompactGroceryItem lhsCompact( lhsItem ),  rhsCompact( rhsItem );
+        if( ( lhsCompact <=> rhsCompact ) != ( lhsItem <=> rhsItem ) || ( lhsCompact == rhsCompact ) != ( lhsItem == rhsItem ) )  return false;
+      }
+    }
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 2'000'000;
+  std::size_t lookupCount = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 1'000'000;
+
+  if( !priceLimitHolds() )
+  {
+    std::cerr << "CompactGroceryItem's price range or ordering disagrees with GroceryItem's around $1,000,000\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<GroceryItem>        items = makeSyntheticCatalog( count );
+  std::vector<CompactGroceryItem> compact( items.begin(), items.end() );
+
+  for( std::size_t i = 0; i < count; ++i )
+  {
+    if( !identical( static_cast<GroceryItem>( compact[i] ), items[i] ) )
+    {
+      std::cerr << "Lossy conversion of item " << i << ": " << items[i] << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Sort
+  double itemSortSeconds    = secondsToRun( [&] { std::sort( items.begin(),   items.end()   ); } );
+  double compactSortSeconds = secondsToRun( [&] { std::sort( compact.begin(), compact.end() ); } );
+
+  for( std::size_t i = 0; i < count; ++i )
+  {
+    if( !identical( static_cast<GroceryItem>( compact[i] ), items[i] ) )
+    {
+      std::cerr << "Sort orders differ at position " << i << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Lookup by UPC code (binary search of the sorted vectors)
+  std::vector<std::string> keys;
+  std::mt19937_64          random( 7 );
+  for( std::size_t i = 0; i < lookupCount; ++i )  keys.push_back( items[random() % count].upcCode() );
+
+  std::vector<PackedUpc> packedKeys;
+  for( auto const & key : keys )  packedKeys.push_back( *PackedUpc::pack( key ) );
+
+  std::size_t found = 0;
+  double itemLookupSeconds = secondsToRun( [&]
+  {
+    for( auto const & key : keys )
+    {
+      auto item = std::lower_bound( items.begin(), items.end(), key, []( GroceryItem const & lhs, std::string const & rhs ) { return lhs.upcCode() < rhs; } );
+      found += item != items.end() && item->upcCode() == key;
+    }
+  } );
+  double compactLookupSeconds = secondsToRun( [&]
+  {
+    for( auto key : packedKeys )
+    {
+      auto item = std::lower_bound( compact.begin(), compact.end(), key, []( CompactGroceryItem const & lhs, PackedUpc rhs ) { return lhs.upcCode() < rhs; } );
+      found += item != compact.end() && item->upcCode() == key;
+    }
+  } );
+  if( found != 2 * lookupCount )
+  {
+    std::cerr << "Lookups failed to find some keys\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "items:                          " << count                                        << '\n'
+            << "sizeof GroceryItem / Compact:   " << sizeof( GroceryItem ) << " / " << sizeof( CompactGroceryItem ) << '\n'
+            << "sort seconds   GroceryItem:     " << itemSortSeconds                              << '\n'
+            << "sort seconds   Compact:         " << compactSortSeconds                           << "  (" << itemSortSeconds / compactSortSeconds << "x)\n"
+            << "lookups/sec    GroceryItem:     " << static_cast<double>( lookupCount ) / itemLookupSeconds    << '\n'
+            << "lookups/sec    Compact:         " << static_cast<double>( lookupCount ) / compactLookupSeconds << "  (" << itemLookupSeconds / compactLookupSeconds << "x)\n";
+  return EXIT_SUCCESS;
+}
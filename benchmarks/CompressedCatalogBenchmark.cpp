@@ -0,0 +1,186 @@
+// Compares CompressedCatalog with the same catalog held uncompressed, sorted the same way, as GroceryCatalog's columns.
+//
+// First checks that everything reads back exactly (every row, in order and at random, and UPC code look ups) and that the packed
+// filters select exactly the rows the uncompressed ones do (price bands against the PriceKernels.hpp kernels, brands against string
+// comparisons), on edge cases and on a synthetic catalog with a few prices that aren't whole cents.  Then reports each column's size
+// both ways, the time each filter takes to scan the whole catalog both ways, and the cost of random row access.
+//
+// Usage:  CompressedCatalogBenchmark [itemCount = 5000000] [repetitions = 20]
+
+#include <algorithm>                                                  // equal(), lower_bound(), min(), max()
+#include <bit>                                                        // popcount()
+#include <cmath>                                                      // nan()
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CatalogSort.hpp"
+#include "CompressedCatalog.hpp"
+#include "GroceryCatalog.hpp"
+#include "GroceryItem.hpp"
+#include "PriceKernels.hpp"
+#include "StringMemory.hpp"                                           // heapBytes()
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  struct Band { double low, high; };
+
+  constexpr Band bands[] = { { 0.0, 1'000.0 }, { 5.0, 9.99 }, { 12.3401, 12.3499 }, { 49.99, 49.99 }, { 20.0, 10.0 }, { -1.0, 0.19 } };
+
+
+  // Heap bytes held by a column of strings, as GroceryCatalog holds them
+  std::size_t columnBytes( std::span<std::string const> column )
+  {
+    std::size_t bytes = column.size() * sizeof( std::string );
+    for( auto const & text : column )  bytes += heapBytes( text );
+    return bytes;
+  }
+
+
+  std::vector<std::uint64_t> brandMask( std::span<std::string const> brandNames, std::string_view brand )
+  {
+    std::vector<std::uint64_t> mask( ( brandNames.size() + 63 ) / 64 );
+    for( std::size_t i = 0; i < brandNames.size(); ++i )  if( brandNames[i] == brand )  mask[i / 64] |= std::uint64_t{ 1 } << i % 64;
+    return mask;
+  }
+
+
+  // Everything the compressed catalog says about items, against the items sorted and held uncompressed
+  bool sameAsUncompressed( std::vector<GroceryItem> items, char const * what )
+  {
+    CompressedCatalog compressed( items );
+    sortCatalog( items );
+    GroceryCatalog    columns( items );
+
+    auto fail = [&]( char const * check ) { std::cerr << what << ":  " << check << " mismatch\n";  return false; };
+
+    auto decoded = compressed.toItems();
+    if( compressed.size() != items.size() || !std::equal( decoded.begin(), decoded.end(), items.begin(), items.end(), identical ) )  return fail( "toItems()" );
+
+    std::mt19937_64 random( 7 );
+    for( std::size_t i = 0; i < std::min<std::size_t>( items.size(), 100'000 ); ++i )
+    {
+      std::size_t row = items.size() <= 100'000 ? i : random() % items.size();
+      if( !identical( compressed.item( row ), items[row] ) )  return fail( "item()" );
+
+      auto const & code  = items[row].upcCode();
+      auto         first = std::lower_bound( items.begin(), items.end(), code, []( GroceryItem const & item, std::string const & code ) { return item.upcCode() < code; } );
+      if( compressed.findUpc( code ) != static_cast<std::size_t>( first - items.begin() ) )  return fail( "findUpc()" );
+      if( compressed.findUpc( code + "x" ) )  return fail( "findUpc() of a missing code" );   // Codes are all digits
+    }
+
+    std::vector<std::uint64_t> expected( ( items.size() + 63 ) / 64 ),  actual( expected.size() + 1, ~std::uint64_t{ 0 } );
+    for( auto [low, high] : bands )
+    {
+      matchPriceBand( columns.prices(), low, high, expected );
+      std::size_t count = compressed.matchPriceBand( low, high, actual );
+      std::size_t expectedCount = 0;
+      for( auto word : expected )  expectedCount += static_cast<std::size_t>( std::popcount( word ) );
+      if( !std::equal( expected.begin(), expected.end(), actual.begin() ) || count != expectedCount )  return fail( "matchPriceBand()" );
+    }
+
+    std::vector<std::string> brands( compressed.brands().begin(), compressed.brands().end() );
+    brands.push_back( "No Such Brand" );
+    for( std::size_t i = 0; i < brands.size(); i += std::max<std::size_t>( brands.size() / 20, 1 ) )
+    {
+      expected = brandMask( columns.brandNames(), brands[i] );
+      compressed.matchBrand( brands[i], actual );
+      if( !std::equal( expected.begin(), expected.end(), actual.begin() ) )  return fail( "matchBrand()" );
+    }
+    if( actual.back() != ~std::uint64_t{ 0 } )  return fail( "mask bounds" );
+    return true;
+  }
+
+
+  std::vector<GroceryItem> edgeCases()
+  {
+    std::vector<GroceryItem> items{ { "Ketchup", "Heinz", "", 0.0 },          { "Ketchup", "Heinz", "036000291452", -0.0 },
+                                    { "Ketchup", "Heinz", "036000291452", 2.29 }, { "Ketchup", "Heinz", "036000291452", 2.295 },
+                                    { "Mustard", "",      "0360002914",   -5.25 }, { "",        "Heinz", std::string( 300, '7' ), 1e20 },
+                                    { "Relish",  "Heinz", std::string( 299, '7' ), std::nan( "" ) }, { "Relish", "Vlasic", "1", 49.99 } };
+    return items;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 5'000'000;
+  std::size_t repetitions = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 20;
+
+  // Correctness:  edge cases, small catalogs around word and block boundaries, a single brand, and the full catalog
+  auto items = makeSyntheticCatalog( count );
+  for( std::size_t i = 0; i < items.size(); i += 997 )  items[i].price( items[i].price() + 0.005 );   // Not whole cents
+  if( !sameAsUncompressed( edgeCases(), "edge cases" ) )  return EXIT_FAILURE;
+  for( std::size_t size : { 0, 1, 15, 16, 17, 63, 64, 65, 1'000 } )
+  {
+    if( !sameAsUncompressed( std::vector<GroceryItem>( items.begin(), items.begin() + static_cast<std::ptrdiff_t>( std::min( size, items.size() ) ) ), "small catalog" ) )  return EXIT_FAILURE;
+  }
+  if( !sameAsUncompressed( makeSyntheticCatalog( 10'000, 3, 1 ), "one brand" ) || !sameAsUncompressed( items, "catalog" ) )  return EXIT_FAILURE;
+  std::cout << "verified round trips, look ups, and filters on edge cases and " << count << " items\n";
+
+  // Size
+  CompressedCatalog compressed( items );
+  sortCatalog( items );
+  GroceryCatalog    columns( items );
+
+  auto        packed         = compressed.bytes();
+  std::size_t upcBytes       = columnBytes( columns.upcCodes() ),  brandBytes = columnBytes( columns.brandNames() );
+  std::size_t productBytes   = columnBytes( columns.productNames() ),  priceBytes = columns.prices().size() * sizeof( double );
+  std::size_t unpackedTotal  = upcBytes + brandBytes + productBytes + priceBytes;
+  auto        report         = [&]( char const * column, std::size_t unpacked, std::size_t packed )
+  {
+    std::cout << column << "   uncompressed MiB: " << static_cast<double>( unpacked ) / ( 1 << 20 ) << "   compressed MiB: " << static_cast<double>( packed ) / ( 1 << 20 )
+              << "   ratio: " << static_cast<double>( unpacked ) / static_cast<double>( packed ) << '\n';
+  };
+  std::cout << '\n' << compressed.brands().size() << " brands\n";
+  report( "UPC codes    ", upcBytes,      packed.upcCodes     );
+  report( "brand names  ", brandBytes,    packed.brandNames   );
+  report( "product names", productBytes,  packed.productNames );
+  report( "prices       ", priceBytes,    packed.prices       );
+  report( "all columns  ", unpackedTotal, packed.total()      );
+
+  // Filter scans
+  std::vector<std::uint64_t> mask( ( count + 63 ) / 64 );
+  std::size_t                matches = 0;
+  auto                       scanned = static_cast<double>( count * repetitions );
+  std::cout << '\n';
+  for( auto [low, high] : { Band{ 5.0, 9.99 }, Band{ 0.0, 1'000.0 } } )
+  {
+    double unpackedSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  matchPriceBand( columns.prices(), low, high, mask ); } );
+    double packedSeconds   = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  matches = compressed.matchPriceBand( low, high, mask ); } );
+    std::cout << "price band [" << low << ", " << high << "]  (" << matches << " rows)   uncompressed rows/sec: " << scanned / unpackedSeconds
+              << "   compressed rows/sec: " << scanned / packedSeconds << '\n';
+  }
+  std::string brand( compressed.brands()[compressed.brands().size() / 2] );
+  double unpackedSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  mask = brandMask( columns.brandNames(), brand ); } );
+  double packedSeconds   = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  matches = compressed.matchBrand( brand, mask ); } );
+  std::cout << "brand \"" << brand << "\"  (" << matches << " rows)   uncompressed rows/sec: " << scanned / unpackedSeconds
+            << "   compressed rows/sec: " << scanned / packedSeconds << '\n';
+
+  // Random access
+  std::vector<std::size_t> rows( 1'000'000 );
+  std::mt19937_64          random( 11 );
+  for( auto & row : rows )  row = random() % count;
+
+  double      sum = 0.0;
+  std::size_t length = 0;
+  auto        accessed = static_cast<double>( rows.size() );
+  double      unpackedPrice = secondsToRun( [&] { for( auto row : rows )  sum += columns.prices()[row]; } );
+  double      packedPrice   = secondsToRun( [&] { for( auto row : rows )  sum += compressed.price( row ); } );
+  double      unpackedRow   = secondsToRun( [&] { for( auto row : rows )  length += columns[row].brandName().size() + columns[row].productName().size() + columns[row].upcCode().size(); } );
+  double      packedRow     = secondsToRun( [&] { for( auto row : rows )  length += compressed.brandName( row ).size() + compressed.productName( row ).size() + compressed.upcCode( row ).size(); } );
+  std::cout << "\nrandom price     uncompressed ns: " << unpackedPrice / accessed * 1e9 << "   compressed ns: " << packedPrice / accessed * 1e9
+            << "\nrandom names     uncompressed ns: " << unpackedRow   / accessed * 1e9 << "   compressed ns: " << packedRow   / accessed * 1e9
+            << "   (" << sum + static_cast<double>( length ) << ")\n";
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,340 @@
+// Measures the latency of single price lookups by reader threads while a writer thread publishes batches of price updates as fast as
+// it can, for ConcurrentCatalog and for the alternative it replaces:  one mutex around the whole catalog.  Reports the median, 99th,
+// and 99.9th percentile and the worst lookup, plus read and update throughput.
+//
+// Before timing it checks that
+//   o)  every snapshot is consistent:  a set of probe items spread over many chunks gets the same new price in every batch, and no
+//       reader ever sees probes with different prices, or a version older than one it saw before
+//   o)  the final prices are exactly what applying the batches in order to a std::unordered_map gives
+//   o)  retired versions are all freed once no reader holds a snapshot, and reader slots run out and come back as documented
+//
+// On a machine with fewer cores than threads the percentiles mostly measure the scheduler; with a core per thread they measure the
+// catalogs.
+//
+// Usage:  ConcurrentCatalogBenchmark [itemCount = 1000000] [readerThreads = 4] [seconds = 2] [batchSize = 1000]
+
+#include <algorithm>                                                  // sort(), min()
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>                                                    // uint64_t
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>                                                  // length_error
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ConcurrentCatalog.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+#include "UpcIndex.hpp"
+
+
+namespace
+{
+  using Clock       = std::chrono::steady_clock;
+  using PriceUpdate = ConcurrentCatalog::PriceUpdate;
+
+
+  // The alternative:  a mutex held for every lookup and for the whole of every batch
+  class LockedCatalog
+  {
+    public:
+      explicit LockedCatalog( std::span<GroceryItem const> items )
+        : _index( items )
+      {
+        for( auto const & item : _index.items() )  _prices.push_back( item.price() );
+      }
+
+      std::optional<double> price( std::string_view upcCode ) const
+      {
+        std::lock_guard lock( _mutex );
+        GroceryItem const * found = _index.find( upcCode );
+        if( found == nullptr )  return std::nullopt;
+        return _prices[static_cast<std::size_t>( found - _index.items().data() )];
+      }
+
+      void update( std::span<PriceUpdate const> updates )
+      {
+        std::lock_guard lock( _mutex );
+        for( auto const & [upcCode, price] : updates )
+        {
+          if( GroceryItem const * found = _index.find( upcCode ) )  _prices[static_cast<std::size_t>( found - _index.items().data() )] = price;
+        }
+      }
+
+    private:
+      UpcIndex            _index;
+      std::vector<double> _prices;
+      mutable std::mutex  _mutex;
+  };
+
+
+  std::vector<std::string> uniqueUpcs( std::vector<GroceryItem> const & items )
+  {
+    UpcIndex                 index( items );
+    std::vector<std::string> upcs;
+    for( auto const & item : index.items() )  upcs.push_back( item.upcCode() );
+    return upcs;
+  }
+
+
+  std::vector<PriceUpdate> randomBatch( std::vector<std::string> const & upcs, std::size_t size, std::mt19937_64 & random )
+  {
+    std::vector<PriceUpdate> batch;
+    batch.reserve( size );
+    for( std::size_t i = 0; i < size; ++i )
+    {
+      batch.push_back( { upcs[random() % upcs.size()], static_cast<double>( random() % 100'000 ) / 100.0 } );
+    }
+    return batch;
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Verification
+  *****************************************************************************/
+
+  bool verifySnapshots()
+  {
+    std::vector<GroceryItem> items = makeSyntheticCatalog( 50'000, 5 );
+    std::vector<std::string> upcs  = uniqueUpcs( items );
+    ConcurrentCatalog        catalog( items );
+
+    // Probes are far enough apart to land in different chunks
+    std::vector<std::string> probes;
+    for( std::size_t i = 0; i < upcs.size(); i += upcs.size() / 40 )  probes.push_back( upcs[i] );
+
+    constexpr std::uint64_t batches = 2'000;
+    std::atomic<bool>       done{ false },  consistent{ true };
+
+    std::vector<std::jthread> readers;
+    for( int r = 0; r < 3; ++r )
+    {
+      readers.emplace_back( [&, reader = catalog.reader()]
+      {
+        std::uint64_t lastVersion = 0;
+        while( !done.load() )
+        {
+          auto snapshot = reader.snapshot();
+          auto version  = snapshot.version();
+          for( auto const & probe : probes )
+          {
+            // Batch g prices every probe at g, so a consistent snapshot of version g > 0 shows g everywhere
+            if( version > 0 && snapshot.price( probe ) != static_cast<double>( version ) )  consistent = false;
+          }
+          if( version < lastVersion )  consistent = false;
+          lastVersion = version;
+        }
+      } );
+    }
+
+    auto                                    reader = catalog.reader();
+    std::unordered_map<std::string, double> expected;
+    {
+      auto snapshot = reader.snapshot();
+      for( auto const & upc : upcs )  expected[upc] = *snapshot.price( upc );
+    }
+
+    std::mt19937_64 random( 17 );
+    for( std::uint64_t g = 1; g <= batches; ++g )
+    {
+      auto batch = randomBatch( upcs, 200, random );
+      for( auto const & probe : probes )  batch.push_back( { probe, static_cast<double>( g ) } );
+      for( auto const & [upc, price] : batch )  expected[upc] = price;
+      batch.push_back( { "not a UPC code", 1.0 } );
+
+      if( catalog.update( batch ) != batch.size() - 1 )  return false;
+    }
+    done = true;
+    readers.clear();
+
+    auto snapshot = reader.snapshot();
+    if( !consistent || snapshot.version() != batches || catalog.version() != batches )  return false;
+    for( auto const & [upc, price] : expected )  if( snapshot.price( upc ) != price )  return false;
+    for( std::size_t i = 0; i < snapshot.size(); ++i )
+    {
+      auto item = snapshot.item( i );
+      if( snapshot.find( item.upcCode() )->price() != expected[item.upcCode()] )  return false;
+    }
+    return !snapshot.find( "not a UPC code" ) && !snapshot.price( "not a UPC code" );
+  }
+
+
+  bool verifyReclamation()
+  {
+    std::vector<GroceryItem> items = makeSyntheticCatalog( 10'000, 6 );
+    std::vector<std::string> upcs  = uniqueUpcs( items );
+    ConcurrentCatalog        catalog( items, 2 );
+    std::vector<PriceUpdate> batch = { { upcs[0], -1.0 } };             // Synthetic prices are never negative
+
+    auto first  = catalog.reader();
+    auto second = catalog.reader();
+    try
+    {
+      auto third = catalog.reader();
+      return false;
+    }
+    catch( std::length_error const & ) {}
+
+    {
+      auto held = first.snapshot();                                     // Holds version 0 and everything after it
+      for( int i = 0; i < 10; ++i )  catalog.update( batch );
+      auto nested = first.snapshot();
+      if( catalog.retiredPending() != 10 || held.version() != 0 || nested.version() != 10 )  return false;
+      if( held.price( upcs[0] ) == -1.0 || nested.price( upcs[0] ) != -1.0 )  return false;
+    }
+    catalog.update( batch );                                            // No snapshots:  everything retired goes
+    if( catalog.retiredPending() != 0 )  return false;
+
+    { auto released = std::move( second ); }
+    auto again = catalog.reader();                                      // The released slot is available again
+    return true;
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Latency under update load
+  *****************************************************************************/
+
+  struct Result
+  {
+    std::vector<double> nanoseconds;                                    // Every lookup's latency, sorted
+    std::size_t         reads   = 0;
+    std::size_t         batches = 0;
+    double              seconds = 0.0;
+  };
+
+
+  // lookup( threadIndex ) returns a function that looks up one UPC code; update( batch ) applies one batch
+  template< typename MakeLookup, typename Update >
+  Result measure( MakeLookup && makeLookup, Update && update, std::vector<std::string> const & upcs,
+                  unsigned readerThreads, double seconds, std::size_t batchSize )
+  {
+    constexpr std::size_t maxSamplesPerThread = 4'000'000;
+
+    std::atomic<bool>                  stop{ false };
+    std::vector<std::vector<double>>   samples( readerThreads );
+    std::vector<std::size_t>           reads  ( readerThreads );
+    std::size_t                        batches = 0;
+    double                             checksum = 0.0;
+    std::mutex                         checksumMutex;
+
+    auto start = Clock::now();
+    {
+      std::vector<std::jthread> threads;
+      for( unsigned t = 0; t < readerThreads; ++t )
+      {
+        threads.emplace_back( [&, t, lookup = makeLookup()]() mutable
+        {
+          std::mt19937_64 random( t + 1 );
+          double          sum = 0.0;
+          samples[t].reserve( maxSamplesPerThread );
+          while( !stop.load( std::memory_order_relaxed ) )
+          {
+            auto const & upc   = upcs[random() % upcs.size()];
+            auto         begin = Clock::now();
+            sum += lookup( upc );
+            auto         end   = Clock::now();
+            if( samples[t].size() < maxSamplesPerThread )  samples[t].push_back( std::chrono::duration<double, std::nano>( end - begin ).count() );
+            ++reads[t];
+          }
+          std::lock_guard lock( checksumMutex );
+          checksum += sum;
+        } );
+      }
+
+      threads.emplace_back( [&]
+      {
+        std::mt19937_64 random( 1234 );
+        while( !stop.load( std::memory_order_relaxed ) )
+        {
+          update( randomBatch( upcs, batchSize, random ) );
+          ++batches;
+        }
+      } );
+
+      std::this_thread::sleep_for( std::chrono::duration<double>( seconds ) );
+      stop = true;
+    }
+
+    Result result;
+    result.seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    result.batches = batches;
+    for( unsigned t = 0; t < readerThreads; ++t )
+    {
+      result.reads += reads[t];
+      result.nanoseconds.insert( result.nanoseconds.end(), samples[t].begin(), samples[t].end() );
+    }
+    std::sort( result.nanoseconds.begin(), result.nanoseconds.end() );
+    if( checksum < 0 )  std::cout << "(checksum " << checksum << ")\n";
+    return result;
+  }
+
+
+  void report( char const * name, Result const & result, std::size_t batchSize )
+  {
+    auto const & ns = result.nanoseconds;
+    auto percentile = [&]( double p ) { return ns.empty() ? 0.0 : ns[std::min( ns.size() - 1, static_cast<std::size_t>( p * static_cast<double>( ns.size() ) ) )]; };
+
+    std::cout << name << "   p50 "   << percentile( 0.5   ) << " ns   p99 " << percentile( 0.99 ) << " ns   p99.9 " << percentile( 0.999 )
+              << " ns   max "       << ( ns.empty() ? 0.0 : ns.back() ) << " ns\n"
+              << "                                reads/s " << static_cast<double>( result.reads ) / result.seconds
+              << "   updates/s "    << static_cast<double>( result.batches * batchSize ) / result.seconds << '\n';
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count         = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 1'000'000;
+  unsigned    readerThreads = argc > 2 ? static_cast<unsigned>( std::strtoul( argv[2], nullptr, 10 ) ) : 4;
+  double      seconds       = argc > 3 ? std::strtod( argv[3], nullptr ) : 2.0;
+  std::size_t batchSize     = argc > 4 ? std::strtoull( argv[4], nullptr, 10 ) : 1'000;
+  if( count == 0 || readerThreads == 0 || batchSize == 0 )  return EXIT_FAILURE;
+
+  if( !verifySnapshots() )
+  {
+    std::cerr << "ConcurrentCatalog snapshots were inconsistent or the final prices are wrong\n";
+    return EXIT_FAILURE;
+  }
+  if( !verifyReclamation() )
+  {
+    std::cerr << "ConcurrentCatalog reclamation or reader slots misbehaved\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<GroceryItem> items = makeSyntheticCatalog( count );
+  std::vector<std::string> upcs  = uniqueUpcs( items );
+
+  std::cout << "items: " << upcs.size() << "   reader threads: " << readerThreads << "   batch size: " << batchSize
+            << "   hardware threads: " << std::thread::hardware_concurrency() << '\n';
+  {
+    ConcurrentCatalog catalog( items, readerThreads );
+    auto result = measure( [&]
+                           {
+                             return [reader = catalog.reader()]( std::string_view upc ) { return *reader.snapshot().price( upc ); };
+                           },
+                           [&]( std::vector<PriceUpdate> const & batch ) { catalog.update( batch ); },
+                           upcs, readerThreads, seconds, batchSize );
+    report( "ConcurrentCatalog          ", result, batchSize );
+  }
+  {
+    LockedCatalog catalog( items );
+    auto result = measure( [&] { return [&]( std::string_view upc ) { return *catalog.price( upc ); }; },
+                           [&]( std::vector<PriceUpdate> const & batch ) { catalog.update( batch ); },
+                           upcs, readerThreads, seconds, batchSize );
+    report( "one mutex around a catalog ", result, batchSize );
+  }
+  return EXIT_SUCCESS;
+}
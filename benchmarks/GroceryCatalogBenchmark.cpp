@@ -0,0 +1,97 @@
+// Compares whole-catalog price scans (sum, min/max, price-band histogram) over std::vector<GroceryItem> against GroceryCatalog's
+// price column, after checking that both give the same answers and that assigning one row to another copies it.
+//
+// Usage:  GroceryCatalogBenchmark [itemCount = 5000000] [repetitions = 20]
+
+#include <algorithm>                                                  // min(), max(), upper_bound()
+#include <cmath>                                                      // abs()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <iostream>
+#include <utility>                                                    // as_const()
+#include <vector>
+
+#include "GroceryCatalog.hpp"
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 5'000'000;
+  std::size_t repetitions = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 20;
+
+  std::vector<GroceryItem> items = makeSyntheticCatalog( count );
+  GroceryCatalog           catalog( items );
+  std::vector<double>      bandEdges{ 0.0, 1.0, 2.5, 5.0, 10.0, 25.0, 50.0, 100.0 };
+
+  // Assigning one row to another copies its fields, and leaves the rows the same as the items they now hold
+  if( count >= 2 )
+  {
+    catalog[0] = catalog[1];
+    catalog[1] = catalog[1];
+    bool copied = identical( catalog[0], items[1] ) && identical( catalog[1], items[1] );
+    catalog[0] = std::as_const( catalog )[0];
+    catalog[0] = items[0];
+    if( !copied || !identical( catalog[0], items[0] ) )
+    {
+      std::cerr << "GroceryCatalog row assignment didn't copy the row\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  double                   itemSum = 0.0,  catalogSum = 0.0;
+  double                   itemMin = 0.0,  itemMax    = 0.0;
+  GroceryCatalog::PriceRange catalogRange;
+  std::vector<std::size_t> itemHistogram,  catalogHistogram;
+
+  double itemSeconds = secondsToRun( [&]
+  {
+    for( std::size_t r = 0; r < repetitions; ++r )
+    {
+      itemSum = 0.0;
+      itemMin = itemMax = items.front().price();
+      itemHistogram.assign( bandEdges.size() - 1, 0 );
+      for( auto const & item : items )
+      {
+        double price = item.price();
+        itemSum += price;
+        itemMin  = std::min( itemMin, price );
+        itemMax  = std::max( itemMax, price );
+        auto edge = std::upper_bound( bandEdges.begin(), bandEdges.end(), price );
+        if( edge != bandEdges.begin() && edge != bandEdges.end() )  ++itemHistogram[static_cast<std::size_t>( edge - bandEdges.begin() ) - 1];
+      }
+    }
+  } );
+
+  double catalogSeconds = secondsToRun( [&]
+  {
+    for( std::size_t r = 0; r < repetitions; ++r )
+    {
+      catalogSum       = catalog.priceSum();
+      catalogRange     = *catalog.priceRange();
+      catalogHistogram = catalog.priceHistogram( bandEdges );
+    }
+  } );
+
+  if(    std::abs( itemSum - catalogSum ) > 1e-9 * std::abs( itemSum )
+      || itemMin != catalogRange.min || itemMax != catalogRange.max
+      || itemHistogram != catalogHistogram )
+  {
+    std::cerr << "GroceryCatalog aggregates differ from the std::vector<GroceryItem> scan\n";
+    return EXIT_FAILURE;
+  }
+
+  // The sum alone, where the difference in memory traffic is starkest
+  double itemSumSeconds    = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r ) { itemSum = 0.0;  for( auto const & item : items ) itemSum += item.price(); } } );
+  double catalogSumSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )   catalogSum = catalog.priceSum(); } );
+
+  auto scanned = static_cast<double>( count * repetitions );
+  std::cout << "items:                                                " << count                                << '\n'
+            << "sum+range+histogram  prices/sec  vector<GroceryItem>: " << scanned / itemSeconds                  << '\n'
+            << "sum+range+histogram  prices/sec  GroceryCatalog:      " << scanned / catalogSeconds               << "  (" << itemSeconds / catalogSeconds << "x)\n"
+            << "sum only             prices/sec  vector<GroceryItem>: " << scanned / itemSumSeconds               << '\n'
+            << "sum only             prices/sec  GroceryCatalog:      " << scanned / catalogSumSeconds            << "  (" << itemSumSeconds / catalogSumSeconds << "x)\n"
+            << "(checksum " << itemSum + catalogSum << ")\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+// Google Benchmark suite for GroceryItem's own operations:  construction from by-value strings, copy vs move construction and
+// assignment, the & and && accessor overloads, operator<=> and operator== on realistic catalog data, and the stream operators.
+//
+// Every benchmark reports allocations per operation ("allocs/op") beside its time, counted by replacing the global operator new.
+// Short strings fit in the small string buffer and long ones don't, so the benchmarks that copy strings run with both (the Arg is
+// the length of each string).
+//
+// Usage:  GroceryItemMicrobenchmarks [Google Benchmark flags]
+//         (Ex: --benchmark_filter=Move --benchmark_out=results.json --benchmark_out_format=json, or build the benchmark-json target)
+
+#include <algorithm>                                                  // sort()
+#include <cstddef>
+#include <cstdint>                                                    // int64_t
+#include <cstdlib>                                                    // malloc(), free(), aligned_alloc()
+#include <memory>                                                     // construct_at(), destroy_at()
+#include <new>                                                        // bad_alloc, align_val_t
+#include <sstream>
+#include <string>
+#include <utility>                                                    // move()
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  std::size_t allocationCount = 0;
+}
+
+
+void * operator new( std::size_t size )
+{
+  ++allocationCount;
+  if( void * memory = std::malloc( size == 0 ? 1 : size ) )  return memory;
+  throw std::bad_alloc();
+}
+
+
+void * operator new( std::size_t size, std::align_val_t alignment )
+{
+  ++allocationCount;
+  if( void * memory = std::aligned_alloc( static_cast<std::size_t>( alignment ), ( size + static_cast<std::size_t>( alignment ) - 1 ) & ~( static_cast<std::size_t>( alignment ) - 1 ) ) )  return memory;
+  throw std::bad_alloc();
+}
+
+
+void operator delete( void * memory                                       ) noexcept { std::free( memory ); }
+void operator delete( void * memory, std::size_t                          ) noexcept { std::free( memory ); }
+void operator delete( void * memory,              std::align_val_t        ) noexcept { std::free( memory ); }
+void operator delete( void * memory, std::size_t, std::align_val_t        ) noexcept { std::free( memory ); }
+
+
+namespace
+{
+  constexpr std::size_t catalogSize = 100'000;
+
+
+  // Counts the allocations made while timing and reports them per operation when it goes out of scope
+  class AllocationCounter
+  {
+    public:
+      AllocationCounter( benchmark::State & state, std::size_t operationsPerIteration = 1 )
+        : _state( state ), _operationsPerIteration( operationsPerIteration ), _start( allocationCount )
+      {}
+
+     ~AllocationCounter()
+      {
+        auto operations = static_cast<double>( _state.iterations() ) * static_cast<double>( _operationsPerIteration );
+        _state.counters["allocs/op"] = static_cast<double>( allocationCount - _start ) / ( operations > 0 ? operations : 1 );
+      }
+
+    private:
+      benchmark::State & _state;
+      std::size_t        _operationsPerIteration;
+      std::size_t        _start;
+  };
+
+
+  std::vector<GroceryItem> const & catalog()
+  {
+    static std::vector<GroceryItem> const items = makeSyntheticCatalog( catalogSize );
+    return items;
+  }
+
+
+  // The catalog sorted, so neighbours share UPC prefixes and the comparisons have to look past the first few characters
+  std::vector<GroceryItem> const & sortedCatalog()
+  {
+    static std::vector<GroceryItem> const items = []
+    {
+      auto sorted = catalog();
+      std::sort( sorted.begin(), sorted.end() );
+      return sorted;
+    }();
+    return items;
+  }
+
+
+  GroceryItem makeItem( std::size_t length )
+  {
+    return GroceryItem( std::string( length, 'p' ), std::string( length, 'b' ), std::string( length, '0' ), 2.49 );
+  }
+
+
+
+
+  /*****************************************************************************
+  **  Construction
+  *****************************************************************************/
+
+  // Strings passed as l-values are copied into the by-value parameters, then moved into the members
+  void ConstructFromLvalueStrings( benchmark::State & state )
+  {
+    std::string const product( static_cast<std::size_t>( state.range( 0 ) ), 'p' ), brand( product.size(), 'b' ), upc( product.size(), '0' );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      GroceryItem item( product, brand, upc, 2.49 );
+      benchmark::DoNotOptimize( item );
+    }
+  }
+  BENCHMARK( ConstructFromLvalueStrings )->Arg( 8 )->Arg( 64 );
+
+
+  // Strings passed as r-values are moved twice and never copied.  Making the strings to move is part of the loop, so compare with
+  // MakeStrings
+  void ConstructFromRvalueStrings( benchmark::State & state )
+  {
+    auto length = static_cast<std::size_t>( state.range( 0 ) );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      std::string product( length, 'p' ), brand( length, 'b' ), upc( length, '0' );
+      GroceryItem item( std::move( product ), std::move( brand ), std::move( upc ), 2.49 );
+      benchmark::DoNotOptimize( item );
+    }
+  }
+  BENCHMARK( ConstructFromRvalueStrings )->Arg( 8 )->Arg( 64 );
+
+
+  void MakeStrings( benchmark::State & state )
+  {
+    auto length = static_cast<std::size_t>( state.range( 0 ) );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      std::string product( length, 'p' ), brand( length, 'b' ), upc( length, '0' );
+      benchmark::DoNotOptimize( product );
+      benchmark::DoNotOptimize( brand );
+      benchmark::DoNotOptimize( upc );
+    }
+  }
+  BENCHMARK( MakeStrings )->Arg( 8 )->Arg( 64 );
+
+
+  void ConstructFromStringLiterals( benchmark::State & state )
+  {
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      GroceryItem item( "Heinz Tomato Ketchup - 2 Ct", "Heinz", "051600080015", 2.29 );
+      benchmark::DoNotOptimize( item );
+    }
+  }
+  BENCHMARK( ConstructFromStringLiterals );
+
+
+
+
+  /*****************************************************************************
+  **  Copy vs move
+  *****************************************************************************/
+
+  void CopyConstruct( benchmark::State & state )
+  {
+    GroceryItem const original = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      GroceryItem copy( original );
+      benchmark::DoNotOptimize( copy );
+    }
+  }
+  BENCHMARK( CopyConstruct )->Arg( 8 )->Arg( 64 );
+
+
+  // Moves an item out and back again, so only the two moves (and destroying the moved-from items) are timed
+  void MoveConstruct( benchmark::State & state )
+  {
+    GroceryItem item = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    AllocationCounter counter( state, 2 );
+    for( auto _ : state )
+    {
+      GroceryItem moved( std::move( item ) );
+      benchmark::DoNotOptimize( moved );
+      std::destroy_at( &item );
+      std::construct_at( &item, std::move( moved ) );
+      benchmark::DoNotOptimize( item );
+    }
+  }
+  BENCHMARK( MoveConstruct )->Arg( 8 )->Arg( 64 );
+
+
+  // Assigning over an item whose strings already have the capacity reuses their buffers
+  void CopyAssign( benchmark::State & state )
+  {
+    GroceryItem const original = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    GroceryItem       target   = original;
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      target = original;
+      benchmark::DoNotOptimize( target );
+    }
+  }
+  BENCHMARK( CopyAssign )->Arg( 8 )->Arg( 64 );
+
+
+  void MoveAssign( benchmark::State & state )
+  {
+    GroceryItem first  = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    GroceryItem second = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    AllocationCounter counter( state, 2 );
+    for( auto _ : state )
+    {
+      second = std::move( first );
+      first  = std::move( second );
+      benchmark::DoNotOptimize( first );
+    }
+  }
+  BENCHMARK( MoveAssign )->Arg( 8 )->Arg( 64 );
+
+
+  // Copying a string out of an l-value through the const & accessor, vs moving it out of an r-value through the && accessor.  Both
+  // include copying the item the string comes from.
+  void CopyOutOfLvalue( benchmark::State & state )
+  {
+    GroceryItem const original = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      GroceryItem item( original );
+      std::string name = item.productName();
+      benchmark::DoNotOptimize( name );
+    }
+  }
+  BENCHMARK( CopyOutOfLvalue )->Arg( 8 )->Arg( 64 );
+
+
+  void MoveOutOfRvalue( benchmark::State & state )
+  {
+    GroceryItem const original = makeItem( static_cast<std::size_t>( state.range( 0 ) ) );
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      GroceryItem item( original );
+      std::string name = std::move( item ).productName();
+      benchmark::DoNotOptimize( name );
+    }
+  }
+  BENCHMARK( MoveOutOfRvalue )->Arg( 8 )->Arg( 64 );
+
+
+
+
+  /*****************************************************************************
+  **  Comparison
+  *****************************************************************************/
+
+  // Neighbours in sorted order:  the hardest realistic case, since they agree on as much of the UPC code as any two items do
+  void ThreeWayCompareNeighbours( benchmark::State & state )
+  {
+    auto const & items = sortedCatalog();
+    AllocationCounter counter( state, items.size() - 1 );
+    for( auto _ : state )
+    {
+      for( std::size_t i = 1; i < items.size(); ++i )  benchmark::DoNotOptimize( items[i - 1] <=> items[i] );
+    }
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() - 1 ) );
+  }
+  BENCHMARK( ThreeWayCompareNeighbours );
+
+
+  // Random pairs, which usually differ within the first few characters of the UPC code
+  void ThreeWayCompareRandom( benchmark::State & state )
+  {
+    auto const & items = catalog();
+    AllocationCounter counter( state, items.size() - 1 );
+    for( auto _ : state )
+    {
+      for( std::size_t i = 1; i < items.size(); ++i )  benchmark::DoNotOptimize( items[i - 1] <=> items[i] );
+    }
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() - 1 ) );
+  }
+  BENCHMARK( ThreeWayCompareRandom );
+
+
+  // Equal items, so operator== has to compare every field
+  void EqualityOfCopies( benchmark::State & state )
+  {
+    auto const &             items  = catalog();
+    std::vector<GroceryItem> copies = items;
+    AllocationCounter counter( state, items.size() );
+    for( auto _ : state )
+    {
+      for( std::size_t i = 0; i < items.size(); ++i )  benchmark::DoNotOptimize( items[i] == copies[i] );
+    }
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() ) );
+  }
+  BENCHMARK( EqualityOfCopies );
+
+
+  // Only the sort is timed and only its allocations counted, not making and freeing the copy it sorts
+  void SortCatalog( benchmark::State & state )
+  {
+    auto const & items       = catalog();
+    std::size_t  allocations = 0;
+    for( auto _ : state )
+    {
+      state.PauseTiming();
+      std::vector<GroceryItem> copy = items;
+      auto before = allocationCount;
+      state.ResumeTiming();
+
+      std::sort( copy.begin(), copy.end() );
+      benchmark::DoNotOptimize( copy.data() );
+
+      state.PauseTiming();
+      allocations += allocationCount - before;
+      copy = {};
+      state.ResumeTiming();
+    }
+    state.counters["allocs/op"] = static_cast<double>( allocations ) / static_cast<double>( state.iterations() );
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() ) );
+  }
+  BENCHMARK( SortCatalog )->Unit( benchmark::kMillisecond );
+
+
+
+
+  /*****************************************************************************
+  **  Stream round trips
+  *****************************************************************************/
+
+  void StreamInsert( benchmark::State & state )
+  {
+    auto const &       items = catalog();
+    std::ostringstream stream;
+    AllocationCounter counter( state, items.size() );
+    for( auto _ : state )
+    {
+      stream.str( {} );
+      for( auto const & item : items )  stream << item << '\n';
+      benchmark::DoNotOptimize( stream );
+    }
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() ) );
+  }
+  BENCHMARK( StreamInsert )->Unit( benchmark::kMillisecond );
+
+
+  void StreamExtract( benchmark::State & state )
+  {
+    auto const &      items = catalog();
+    std::string const text  = toCatalogText( items );
+    AllocationCounter counter( state, items.size() );
+    for( auto _ : state )
+    {
+      std::istringstream stream( text );
+      GroceryItem        item;
+      std::size_t        count = 0;
+      while( stream >> item )  ++count;
+      if( count != items.size() )  state.SkipWithError( "extraction stopped early" );
+    }
+    state.SetItemsProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( items.size() ) );
+    state.SetBytesProcessed( static_cast<std::int64_t>( state.iterations() ) * static_cast<std::int64_t>( text.size() ) );
+  }
+  BENCHMARK( StreamExtract )->Unit( benchmark::kMillisecond );
+
+
+  // One item out and back in, checking it survives the trip
+  void StreamRoundTrip( benchmark::State & state )
+  {
+    auto const & items = catalog();
+    std::size_t  i     = 0;
+    AllocationCounter counter( state );
+    for( auto _ : state )
+    {
+      std::stringstream stream;
+      GroceryItem       item;
+      stream << items[i];
+      stream >> item;
+      if( item != items[i] )  state.SkipWithError( "item changed in the round trip" );
+      i = ( i + 1 ) % items.size();
+    }
+  }
+  BENCHMARK( StreamRoundTrip );
+}
+
+
+BENCHMARK_MAIN();
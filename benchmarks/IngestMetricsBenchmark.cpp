@@ -0,0 +1,152 @@
+// Exports a catalog with CatalogWriter, reads it back with loadCatalogFile(), loadCatalogFileParallel(), and RecordSource, and loads
+// malformed text with every kind of parse error, reporting each phase's throughput and the ingest metrics it produced.  The load's
+// metrics are then dumped as JSON and in Prometheus text format.
+//
+// Built with GROCERY_INGEST_METRICS on, it checks every counter is exact:  records and bytes against the file, heap strings against
+// the loaded strings, parse errors by kind.  Built with it off, the same phases run uninstrumented, for the cost comparison, and every
+// counter stays 0.
+//
+// Usage:  IngestMetricsBenchmark [itemCount = 2000000] [threads = 4]
+
+#include <algorithm>                                                  // min()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoul(), strtoull()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "CatalogWriter.hpp"
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "IngestMetrics.hpp"
+#include "RecordSource.hpp"
+#include "StringMemory.hpp"                                           // onHeap()
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  std::size_t heapStrings( std::vector<GroceryItem> const & items )
+  {
+    std::size_t count = 0;
+    for( auto const & item : items )  count += onHeap( item.upcCode() ) + onHeap( item.brandName() ) + onHeap( item.productName() );
+    return count;
+  }
+
+
+  void report( char const * phase, double seconds, double bytes, IngestMetrics::Snapshot const & metrics, IngestStage stage )
+  {
+    std::cout << phase << "   ms: " << seconds * 1e3 << "   MB/s: " << bytes / seconds / 1e6;
+    if constexpr( IngestMetrics::enabled )
+    {
+      auto const & latency = metrics.stages[static_cast<std::size_t>( stage )];
+      std::cout << "   records/s: " << metrics.perSecond( IngestCounter::recordsRead ) + metrics.perSecond( IngestCounter::recordsWritten )
+                << "   " << name( stage ) << " p50/p99 ns: " << latency.percentile( 0.5 ) << '/' << latency.percentile( 0.99 );
+    }
+    std::cout << '\n';
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count   = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 2'000'000;
+  unsigned    threads = argc > 2 ? static_cast<unsigned>( std::strtoul( argv[2], nullptr, 10 ) ) : 4;
+
+  bool exact = true;
+  auto check = [&]( bool ok, char const * what )
+  {
+    if( IngestMetrics::enabled && !ok )
+    {
+      std::cerr << "Wrong ingest metrics:  " << what << '\n';
+      exact = false;
+    }
+  };
+
+  std::cout << "instrumentation: " << ( IngestMetrics::enabled ? "on" : "off" ) << "   items: " << count << '\n';
+
+  auto items = makeSyntheticCatalog( count );
+  auto path  = std::filesystem::temp_directory_path() / "IngestMetricsBenchmark.txt";
+
+  // Export
+  IngestMetrics::reset();
+  double writeSeconds = secondsToRun( [&]
+  {
+    CatalogWriter writer( path );
+    writer.write( items );
+    writer.flush();
+  } );
+  auto written   = IngestMetrics::snapshot();
+  auto fileBytes = std::filesystem::file_size( path );
+  report( "write          ", writeSeconds, static_cast<double>( fileBytes ), written, IngestStage::format );
+  check( written[IngestCounter::recordsWritten] == count && written[IngestCounter::bytesWritten] == fileBytes, "records or bytes written" );
+  check( written.stages[static_cast<std::size_t>( IngestStage::write  )].count() > 0
+      && written.stages[static_cast<std::size_t>( IngestStage::format )].count() == count / IngestMetrics::sampleInterval, "write and format samples" );
+
+  // Each thread samples its own calls, so a load split over threads may take a few samples fewer
+  auto checkLoad = [&]( IngestMetrics::Snapshot const & metrics, CatalogLoadResult const & result, char const * loader )
+  {
+    auto samples = count / IngestMetrics::sampleInterval - std::min<std::size_t>( count / IngestMetrics::sampleInterval, 4 * threads );
+    check( result.status == ParseStatus::endOfInput && result.items.size() == count, loader );
+    check( metrics[IngestCounter::recordsRead] == count && metrics[IngestCounter::bytesRead] == fileBytes, "records or bytes read" );
+    check( metrics[IngestCounter::heapStrings] == heapStrings( result.items ), "heap strings" );
+    check( metrics.stages[static_cast<std::size_t>( IngestStage::fields    )].count() >= samples
+        && metrics.stages[static_cast<std::size_t>( IngestStage::price     )].count() >= samples
+        && metrics.stages[static_cast<std::size_t>( IngestStage::construct )].count() >= samples, "parse samples" );
+  };
+
+  // Load, three ways
+  CatalogLoadResult loaded;
+  IngestMetrics::reset();
+  double loadSeconds = secondsToRun( [&] { loaded = loadCatalogFile( path ); } );
+  auto   load        = IngestMetrics::snapshot();
+  report( "load           ", loadSeconds, static_cast<double>( fileBytes ), load, IngestStage::fields );
+  checkLoad( load, loaded, "loadCatalogFile()" );
+
+  IngestMetrics::reset();
+  double parallelSeconds = secondsToRun( [&] { loaded = loadCatalogFileParallel( path, threads ); } );
+  auto   parallel        = IngestMetrics::snapshot();
+  report( "parallel load  ", parallelSeconds, static_cast<double>( fileBytes ), parallel, IngestStage::fields );
+  checkLoad( parallel, loaded, "loadCatalogFileParallel()" );
+  loaded = {};
+
+  IngestMetrics::reset();
+  std::size_t streamedCount = 0;
+  double      streamSeconds = secondsToRun( [&]
+  {
+    std::ifstream file( path, std::ios::binary );
+    RecordSource  source( file );
+    for( ItemView item; source.next( item ); )  ++streamedCount;
+  } );
+  auto streamed = IngestMetrics::snapshot();
+  report( "RecordSource   ", streamSeconds, static_cast<double>( fileBytes ), streamed, IngestStage::read );
+  check( streamedCount == count && streamed[IngestCounter::recordsRead] == count && streamed[IngestCounter::bytesRead] == fileBytes, "streamed records or bytes" );
+  check( streamed.stages[static_cast<std::size_t>( IngestStage::read )].count() > 0, "read samples" );
+  std::filesystem::remove( path );
+
+  // Malformed input:  each loader stops once per text, and says why
+  IngestMetrics::reset();
+  std::string good = toCatalogText( makeSyntheticCatalog( 10, 5 ) );
+  for( std::string bad : { "\"123\", \"Acme\"", "\"123\", \"Acme\", \"Half", "\"123\", \"Acme\", \"Bread\", abc\n" } )
+  {
+    std::string text = good + bad;
+    loadCatalog( text );
+    RecordSource source( text );
+    for( ItemView item; source.next( item ); ) {}
+  }
+  auto errors = IngestMetrics::snapshot();
+  check( errors[ParseStatus::truncatedRecord] == 2 && errors[ParseStatus::unterminatedQuote] == 2 && errors[ParseStatus::badPrice] == 2, "parse errors" );
+  check( errors[IngestCounter::recordsRead] == 2 * 3 * 10 && errors[IngestCounter::bytesRead] == 2 * 3 * good.size(), "records or bytes before the errors" );
+
+  std::cout << "\nload metrics, JSON:\n"       << load.toJson()
+            << "\nload metrics, Prometheus:\n" << load.toPrometheus()
+            << "\nmalformed input, Prometheus (parse errors only):\n";
+  std::istringstream exposition( errors.toPrometheus() );
+  for( std::string line; std::getline( exposition, line ); )  if( line.contains( "parse_errors" ) )  std::cout << line << '\n';
+
+  return exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,96 @@
+// Measures load time and resident memory of a catalog held as GroceryItem, InternedGroceryItem, or FullyInternedGroceryItem.
+// Run each representation in its own process so they don't share heap pages:
+//
+// Usage:  InternedCatalogBenchmark plain|interned|fullyInterned [recordCount = 10000000]
+
+#include <algorithm>                                                  // count()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItemParser.hpp"
+#include "InternedGroceryItem.hpp"
+#include "MappedFile.hpp"
+#include "StringPool.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  // Parses the catalog straight into Item, without building GroceryItems along the way
+  template< typename Item >
+  std::vector<Item> loadAs( std::filesystem::path const & path )
+  {
+    MappedFile       file( path );
+    std::string_view text   = file.view();
+    char const *     cursor = text.data();
+    char const *     end    = cursor + text.size();
+
+    std::vector<Item> items;
+    items.reserve( static_cast<std::size_t>( std::count( cursor, end, '\n' ) ) + 1 );   // Same capacity loadCatalogFile() reserves
+
+    RecordView        record;
+    std::string       brandName;
+    while( parseRecord( cursor, end, record ) == ParseStatus::ok )
+    {
+      unescape( record.brandName, brandName );
+      items.emplace_back( unescape( record.productName ), brandName, unescape( record.upcCode ), record.price );
+    }
+    return items;
+  }
+
+
+  template< typename Items >
+  void report( std::string_view mode, Items const & items, double seconds, std::size_t rssBefore )
+  {
+    auto rssAfter = residentSetBytes();
+    std::cout << "mode:              " << mode                                                       << '\n'
+              << "records:           " << items.size()                                               << '\n'
+              << "item size (bytes): " << sizeof( typename Items::value_type )                       << '\n'
+              << "distinct brands:   " << StringPool::brandNames().size()                            << '\n'
+              << "load seconds:      " << seconds                                                    << '\n'
+              << "records/sec:       " << static_cast<double>( items.size() ) / seconds              << '\n'
+              << "RSS growth (MiB):  " << static_cast<double>( rssAfter - rssBefore ) / ( 1 << 20 )  << '\n';
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::string_view mode  = argc > 1 ? argv[1] : "plain";
+  std::size_t      count = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 10'000'000;
+
+  auto path = std::filesystem::temp_directory_path() / ( "InternedCatalogBenchmark-" + std::to_string( count ) + ".txt" );
+  if( !std::filesystem::exists( path ) )  writeSyntheticCatalog( path, count );
+
+  auto rssBefore = residentSetBytes();
+  if( mode == "plain" )
+  {
+    std::vector<GroceryItem> items;
+    double seconds = secondsToRun( [&] { items = loadCatalogFile( path ).items; } );
+    report( mode, items, seconds, rssBefore );
+  }
+  else if( mode == "interned" )
+  {
+    std::vector<InternedGroceryItem> items;
+    double seconds = secondsToRun( [&] { items = loadAs<InternedGroceryItem>( path ); } );
+    report( mode, items, seconds, rssBefore );
+  }
+  else if( mode == "fullyInterned" )
+  {
+    std::vector<FullyInternedGroceryItem> items;
+    double seconds = secondsToRun( [&] { items = loadAs<FullyInternedGroceryItem>( path ); } );
+    report( mode, items, seconds, rssBefore );
+  }
+  else
+  {
+    std::cerr << "usage: " << argv[0] << " plain|interned|fullyInterned [recordCount]\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+// Measures how the parallel catalog loader scales with thread count, checking each run against the single-threaded loader.
+//
+// First checks the parallel loader on text where chunks are cut inside records:  product names with newlines in them, so that chunk
+// boundaries land inside quoted fields and the loader must re-parse chunks whose speculative start was wrong, with and without a
+// malformed record well past the first chunk.
+//
+// Usage:  ParallelLoaderBenchmark [recordCount = 2000000] [maxThreads = hardware threads]
+//         ParallelLoaderBenchmark --verify [recordCount = 200000]             The checks alone, for ctest
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>                                                      // SIZE_MAX
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoul(), strtoull()
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItemParser.hpp"                                        // ParseStatus
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  bool sameAsSerial( CatalogLoadResult const & loaded, CatalogLoadResult const & expected )
+  {
+    bool same = loaded.status      == expected.status      && loaded.errorLine    == expected.errorLine
+             && loaded.errorOffset == expected.errorOffset && loaded.items.size() == expected.items.size();
+    for( std::size_t i = 0; same && i < loaded.items.size(); ++i )  same = identical( loaded.items[i], expected.items[i] );
+    return same;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly = verifyOnly( argc, argv );
+  std::size_t count      = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 200'000 : 2'000'000;
+  unsigned    maxThreads = argc > 2 ? static_cast<unsigned>( std::strtoul( argv[2], nullptr, 10 ) )
+                                    : std::max( 1U, std::thread::hardware_concurrency() );
+
+  // Enough records for several 1 MiB chunks, whatever count is
+  constexpr std::size_t checkCount = 200'000;
+  for( std::size_t malformedAt : { SIZE_MAX, checkCount * 3 / 4 } )
+  {
+    std::string       text     = makeMultilineCatalogText( checkCount, 7, malformedAt );
+    CatalogLoadResult expected = loadCatalog( text );
+    if( ( malformedAt == SIZE_MAX ) != ( expected.status == ParseStatus::endOfInput ) )
+    {
+      std::cerr << "The serial loader misread the multi-line check text\n";
+      return EXIT_FAILURE;
+    }
+    for( unsigned threads : { 2U, 3U, 8U } )
+    {
+      if( !sameAsSerial( loadCatalogParallel( text, threads ), expected ) )
+      {
+        std::cerr << "Parallel load with " << threads << " threads differs from the serial load of multi-line records"
+                  << ( malformedAt == SIZE_MAX ? "\n" : " with a malformed one\n" );
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::string text = toCatalogText( makeSyntheticCatalog( count ) );
+
+  if( checksOnly )
+  {
+    CatalogLoadResult expected = loadCatalog( text );
+    for( unsigned threads : { 1U, 2U, 3U, 8U } )
+    {
+      if( !sameAsSerial( loadCatalogParallel( text, threads ), expected ) )
+      {
+        std::cerr << "Parallel load with " << threads << " threads differs from the serial load\n";
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << "verified parallel loads of multi-line records, with and without a malformed one, and of " << count << " records\n";
+    return EXIT_SUCCESS;
+  }
+
+  CatalogLoadResult expected;
+  double baseline = secondsToRun( [&] { expected = loadCatalog( text ); } );
+  std::cout << "records: " << expected.items.size() << "\n\n"
+            << "threads   records/sec   speedup\n"
+            << "serial    " << static_cast<double>( count ) / baseline << '\n';
+
+  for( unsigned threads = 1; ; threads = std::min( threads * 2, maxThreads ) )
+  {
+    CatalogLoadResult loaded;
+    double seconds = secondsToRun( [&] { loaded = loadCatalogParallel( text, threads ); } );
+
+    if( !sameAsSerial( loaded, expected ) )
+    {
+      std::cerr << "Parallel load with " << threads << " threads differs from the serial load\n";
+      return EXIT_FAILURE;
+    }
+
+    std::cout << threads << "         " << static_cast<double>( count ) / seconds << "     " << baseline / seconds << "x\n";
+    if( threads >= maxThreads )  break;
+  }
+  return EXIT_SUCCESS;
+}
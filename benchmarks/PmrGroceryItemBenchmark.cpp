@@ -0,0 +1,203 @@
+// Counts heap allocations and times a bulk load and teardown of the same catalog text three ways:
+//   o)  loadCatalog() into std::vector<GroceryItem>
+//   o)  appendCatalogText() into std::pmr::vector<PmrGroceryItem> on the default (new/delete) resource
+//   o)  appendCatalogText() into std::pmr::vector<PmrGroceryItem> on a std::pmr::monotonic_buffer_resource, both freshly allocated
+//       and over a buffer reused from load to load
+// after checking that all three load the same items and that PmrGroceryItem follows the allocator propagation rules it documents.
+//
+// Allocations are counted by replacing the global operator new, so they include every allocation the standard library makes.
+//
+// Usage:  PmrGroceryItemBenchmark [itemCount = 2000000]
+
+#include <algorithm>                                                  // min()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull(), malloc(), free()
+#include <iostream>
+#include <memory_resource>
+#include <new>                                                        // bad_alloc, align_val_t
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItem.hpp"
+#include "PmrGroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  std::size_t allocationCount = 0;
+}
+
+
+void * operator new( std::size_t size )
+{
+  ++allocationCount;
+  if( void * memory = std::malloc( size == 0 ? 1 : size ) )  return memory;
+  throw std::bad_alloc();
+}
+
+
+void * operator new( std::size_t size, std::align_val_t alignment )
+{
+  ++allocationCount;
+  if( void * memory = std::aligned_alloc( static_cast<std::size_t>( alignment ), ( size + static_cast<std::size_t>( alignment ) - 1 ) & ~( static_cast<std::size_t>( alignment ) - 1 ) ) )  return memory;
+  throw std::bad_alloc();
+}
+
+
+void operator delete( void * memory                                       ) noexcept { std::free( memory ); }
+void operator delete( void * memory, std::size_t                          ) noexcept { std::free( memory ); }
+void operator delete( void * memory,              std::align_val_t        ) noexcept { std::free( memory ); }
+void operator delete( void * memory, std::size_t, std::align_val_t        ) noexcept { std::free( memory ); }
+
+
+namespace
+{
+  bool sameItems( std::vector<GroceryItem> const & expected, std::pmr::vector<PmrGroceryItem> const & items )
+  {
+    if( expected.size() != items.size() )  return false;
+    for( std::size_t i = 0; i < items.size(); ++i )  if( !identical( expected[i], GroceryItem( items[i] ) ) )  return false;
+    return true;
+  }
+
+
+  bool verifyPropagation()
+  {
+    std::pmr::monotonic_buffer_resource arena,  otherArena;
+    auto resourceOf = []( PmrGroceryItem const & item ) { return item.get_allocator().resource(); };
+
+    PmrGroceryItem original( "Bread with a name too long for SSO", "Acme Bakery Company", "012345678905", 2.49, &arena );
+    PmrGroceryItem copied  ( original );
+    PmrGroceryItem copiedTo( original, &otherArena );
+    PmrGroceryItem moved   ( PmrGroceryItem( original, &arena ) );
+    PmrGroceryItem movedTo ( PmrGroceryItem( original, &arena ), &otherArena );
+
+    PmrGroceryItem assigned( &otherArena );
+    assigned = original;
+    PmrGroceryItem moveAssigned( &otherArena );
+    moveAssigned = PmrGroceryItem( original, &arena );
+
+    std::pmr::vector<PmrGroceryItem> items( &arena );
+    items.push_back( copiedTo );
+    items.emplace_back( "Milk", "Acme", "012345678906", 3.49 );
+    items.resize( 40 );                                                 // Reallocation moves the items, still within the arena
+
+    bool resourcesRight =    resourceOf( original     ) == &arena
+                          && resourceOf( copied       ) == std::pmr::get_default_resource()
+                          && resourceOf( copiedTo     ) == &otherArena
+                          && resourceOf( moved        ) == &arena
+                          && resourceOf( movedTo      ) == &otherArena
+                          && resourceOf( assigned     ) == &otherArena
+                          && resourceOf( moveAssigned ) == &otherArena;
+    for( auto const & item : items )  resourcesRight = resourcesRight && resourceOf( item ) == &arena;
+
+    return resourcesRight
+        && copied == original && copiedTo == original && moved == original && movedTo == original && assigned == original && moveAssigned == original
+        && items[0] == original && GroceryItem( items[1] ) == GroceryItem( "Milk", "Acme", "012345678906", 3.49 );
+  }
+
+
+  struct Measurement
+  {
+    std::size_t loadAllocations = 0;
+    double      loadSeconds     = 0.0;
+    double      freeSeconds     = 0.0;
+  };
+
+
+  void report( char const * name, Measurement const & measurement, std::size_t count )
+  {
+    std::cout << name << "   allocations: " << measurement.loadAllocations
+              << " (" << static_cast<double>( measurement.loadAllocations ) / static_cast<double>( count ) << " per item)"
+              << "   load ms: " << measurement.loadSeconds * 1e3 << "   free ms: " << measurement.freeSeconds * 1e3 << '\n';
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 2'000'000;
+  std::string text  = toCatalogText( makeSyntheticCatalog( count ) );
+
+  if( !verifyPropagation() )
+  {
+    std::cerr << "PmrGroceryItem did not follow its allocator propagation rules\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<GroceryItem> expected = loadCatalog( text ).items;
+
+  // Each way is measured a few times, interleaved, keeping the fastest - otherwise whichever runs first also pays for faulting in
+  // fresh pages that the later ones get back from the allocator already mapped
+  auto measurePlain = [&]
+  {
+    Measurement                      measurement;
+    std::optional<CatalogLoadResult> loaded;
+    auto before = allocationCount;
+    measurement.loadSeconds     = secondsToRun( [&] { loaded = loadCatalog( text ); } );
+    measurement.loadAllocations = allocationCount - before;
+    measurement.freeSeconds     = secondsToRun( [&] { loaded.reset(); } );
+    return measurement;
+  };
+
+  // A buffer big enough for the whole load, touched once up front, stands in for a service that reloads into the same memory
+  std::vector<std::byte> reusedBuffer( text.size() + ( count + 1 ) * sizeof( PmrGroceryItem ) + ( 1 << 20 ) );
+
+  enum class Resource { newDelete, arena, reusedArena };
+  auto measurePmr = [&]( Resource resource )
+  {
+    // A fresh arena's first block is about the size of the text, so a load takes only a handful of upstream allocations
+    Measurement                                        measurement;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+    std::optional<std::pmr::vector<PmrGroceryItem>>    items;
+    auto before = allocationCount;
+    measurement.loadSeconds = secondsToRun( [&]
+    {
+      switch( resource )
+      {
+        case Resource::newDelete:    items.emplace();                                                                  break;
+        case Resource::arena:        items.emplace( &arena.emplace( text.size() ) );                                   break;
+        case Resource::reusedArena:  items.emplace( &arena.emplace( reusedBuffer.data(), reusedBuffer.size() ) );      break;
+      }
+      appendCatalogText( *items, text );
+    } );
+    measurement.loadAllocations = allocationCount - before;
+    if( !sameItems( expected, *items ) )  return std::optional<Measurement>();
+    measurement.freeSeconds = secondsToRun( [&] { items.reset();  arena.reset(); } );
+    return std::optional<Measurement>( measurement );
+  };
+
+  auto keepBest = []( std::optional<Measurement> & best, Measurement const & measurement )
+  {
+    if( !best )  best = measurement;
+    best->loadSeconds = std::min( best->loadSeconds, measurement.loadSeconds );
+    best->freeSeconds = std::min( best->freeSeconds, measurement.freeSeconds );
+  };
+
+  std::optional<Measurement> plain, pmrDefault, pmrArena, pmrReused;
+  for( int trial = 0; trial < 3; ++trial )
+  {
+    keepBest( plain, measurePlain() );
+
+    auto onDefault = measurePmr( Resource::newDelete   );
+    auto onArena   = measurePmr( Resource::arena       );
+    auto onReused  = measurePmr( Resource::reusedArena );
+    if( !onDefault || !onArena || !onReused )
+    {
+      std::cerr << "PmrGroceryItem load differs from loadCatalog()\n";
+      return EXIT_FAILURE;
+    }
+    keepBest( pmrDefault, *onDefault );
+    keepBest( pmrArena,   *onArena   );
+    keepBest( pmrReused,  *onReused  );
+  }
+
+  std::cout << "items: " << count << '\n';
+  report( "std::vector<GroceryItem>                 ", *plain,      count );
+  report( "pmr::vector<PmrGroceryItem>, new/delete  ", *pmrDefault, count );
+  report( "pmr::vector<PmrGroceryItem>, arena       ", *pmrArena,   count );
+  report( "pmr::vector<PmrGroceryItem>, reused arena", *pmrReused,  count );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+// Checks the batch price kernels against floating_point_is_equal() one price at a time, over every price within a few ulps of each
+// tolerance boundary for a spread of targets (plus zeros, subnormals, infinities and NaN), then times the scalar and AVX2 kernels.
+//
+// Usage:  PriceKernelBenchmark [priceCount = 10000000] [repetitions = 10]
+//         PriceKernelBenchmark --verify                                     The checks alone, for ctest
+
+#include <cmath>                                                      // nextafter()
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "FloatingPoint.hpp"
+#include "PriceKernels.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  using Limits = std::numeric_limits<double>;
+
+  // value and its neighbours up to `steps` ulps away on either side
+  void addNeighbourhood( std::vector<double> & values, double value, int steps = 40 )
+  {
+    double below = value,  above = value;
+    values.push_back( value );
+    for( int step = 0; step < steps; ++step )
+    {
+      below = std::nextafter( below, -Limits::infinity() );
+      above = std::nextafter( above,  Limits::infinity() );
+      values.push_back( below );
+      values.push_back( above );
+    }
+  }
+
+
+  // Every price near a place where floating_point_is_equal( price, target ) can change its answer
+  std::vector<double> boundaryPrices( double target )
+  {
+    std::vector<double> prices;
+    for( double offset : { 0.0, 1e-4, -1e-4 } )  addNeighbourhood( prices, target + offset );
+    for( double scale  : { 1 + 1e-8, 1 - 1e-8, 1 / ( 1 + 1e-8 ), 1 / ( 1 - 1e-8 ) } )  addNeighbourhood( prices, target * scale );
+    for( double special : { 0.0, -0.0, Limits::denorm_min(), Limits::min(), Limits::max(), Limits::infinity(), -Limits::infinity(), Limits::quiet_NaN() } )  prices.push_back( special );
+    return prices;
+  }
+
+
+  bool verify()
+  {
+    std::vector<double> targets{ 0.0, -0.0, 1e-5, 1e-4, 0.01, 1.99, 2.49, -3.5, 100.0, 9'999.99, 10'000.0, 12'345.67, 1e6, 1e9, 3.7e15,
+                                 Limits::denorm_min(), Limits::max(), Limits::infinity(), -Limits::infinity(), Limits::quiet_NaN() };
+
+    std::vector<double> allPrices;
+    for( double target : targets )
+    {
+      auto prices = boundaryPrices( target );
+      allPrices.insert( allPrices.end(), prices.begin(), prices.end() );
+    }
+
+    std::size_t checked = 0;
+    for( PriceKernelIsa isa : { PriceKernelIsa::scalar, PriceKernelIsa::avx2 } )
+    {
+      if( !setPriceKernelIsa( isa ) )  continue;
+
+      std::vector<std::uint64_t> mask( ( allPrices.size() + 63 ) / 64 );
+      for( double target : targets )
+      {
+        matchPriceEqual( allPrices, target, mask );
+        for( std::size_t i = 0; i < allPrices.size(); ++i, ++checked )
+        {
+          bool expected = floating_point_is_equal( allPrices[i], target );
+          if( ( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) != expected )
+          {
+            std::cerr << "Equal kernel mismatch:  price " << allPrices[i] << " target " << target << '\n';
+            return false;
+          }
+        }
+      }
+
+      for( double low : targets )
+      {
+        for( double high : targets )
+        {
+          matchPriceBand( allPrices, low, high, mask );
+          for( std::size_t i = 0; i < allPrices.size(); ++i, ++checked )
+          {
+            double price    = allPrices[i];
+            bool   expected = ( price > low  || floating_point_is_equal( price, low  ) )
+                           && ( price < high || floating_point_is_equal( price, high ) );
+            if( ( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) != expected )
+            {
+              std::cerr << "Band kernel mismatch:  price " << price << " band [" << low << ", " << high << "]\n";
+              return false;
+            }
+          }
+        }
+      }
+    }
+    std::cout << "verified " << checked << " price comparisons against floating_point_is_equal()\n";
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly  = verifyOnly( argc, argv );
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 10'000'000;
+  std::size_t repetitions = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 10;
+
+  if( !verify() )  return EXIT_FAILURE;
+  if( checksOnly )  return EXIT_SUCCESS;
+
+  std::mt19937_64     random( 11 );
+  std::vector<double> prices( count );
+  for( auto & price : prices )  price = static_cast<double>( random() % 5'000 + 19 ) / 100.0;
+
+  std::vector<std::uint64_t> mask( ( count + 63 ) / 64 );
+  for( PriceKernelIsa isa : { PriceKernelIsa::scalar, PriceKernelIsa::avx2 } )
+  {
+    if( !setPriceKernelIsa( isa ) )
+    {
+      std::cout << "(AVX2 not available on this CPU)\n";
+      continue;
+    }
+    double equalSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  matchPriceEqual( prices, 19.99, mask ); } );
+    double bandSeconds  = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  matchPriceBand ( prices, 5.0, 10.0, mask ); } );
+
+    auto scanned = static_cast<double>( count * repetitions );
+    std::cout << ( isa == PriceKernelIsa::scalar ? "scalar" : "avx2  " )
+              << "   equal prices/sec: " << scanned / equalSeconds
+              << "   band prices/sec: "  << scanned / bandSeconds << '\n';
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+// Runs per-brand aggregates and a top-k over a catalog file as a stream (RecordSource and the RecordPipeline operators), and again
+// over the fully materialized std::vector<GroceryItem>, checking the results are identical and reporting time and resident memory
+// for both.
+//
+// Before that it checks that RecordSource reads exactly what loadCatalog() reads - the same items, status, error line, and error
+// offset - on clean and malformed text, through buffers from 1 byte up, so records are cut at every possible place.
+//
+// Usage:  RecordPipelineBenchmark [itemCount = 2000000] [k = 100]
+//         RecordPipelineBenchmark --verify [itemCount = 20000] [k = 100]      The checks alone, for ctest
+
+#include <algorithm>                                                  // stable_sort(), min(), max()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <cstring>                                                    // memcmp()
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>                                                    // pair
+#include <vector>
+
+#include "CatalogLoader.hpp"
+#include "GroceryItem.hpp"
+#include "RecordPipeline.hpp"
+#include "RecordSource.hpp"
+#include "SyntheticCatalog.hpp"
+
+
+namespace
+{
+  GroceryItem toGroceryItem( ItemView const & item )
+  {
+    return GroceryItem( std::string( item.productName ), std::string( item.brandName ), std::string( item.upcCode ), item.price );
+  }
+
+
+  bool sameAsLoader( RecordSource & source, CatalogLoadResult const & expected )
+  {
+    ItemView    item;
+    std::size_t count = 0;
+    while( source.next( item ) )
+    {
+      if( count >= expected.items.size() || !identical( toGroceryItem( item ), expected.items[count] ) )  return false;
+      ++count;
+    }
+    return count == expected.items.size() && source.recordCount() == count && source.status() == expected.status
+        && source.errorLine() == expected.errorLine && source.errorOffset() == expected.errorOffset;
+  }
+
+
+  bool verifySource()
+  {
+    std::string base = toCatalogText( makeSyntheticCatalog( 300, 9 ) )
+                     + "\"0123\", \"Quote \\\" and \\\\ backslash\", \"Tab\tinside\", 1.5e1\n"
+                     + "  \"0124\",\"" + std::string( 20'000, 'x' ) + "\",unquoted,  -0.25 \n";
+
+    std::vector<std::string> tails = { "",
+                                       "\n\n   \t",
+                                       "\"1\", \"a\", \"b\", 1.5",                              // No newline:  the price runs to the end
+                                       "\"1\", \"a\", \"b\", 1e",                               // A price that can't be finished
+                                       "\"123\", \"Acme\", \"Half",                             // Unterminated quote
+                                       "\"123\", \"Acme\"",                                     // Truncated
+                                       "\"123\", \"Acme\", \"Bread\", abc\n\"1\", \"a\", \"b\", 1.5\n" };   // Bad price, then more
+
+    for( auto const & tail : tails )
+    {
+      std::string text     = base + tail;
+      auto        expected = loadCatalog( text );
+
+      RecordSource inMemory( text );
+      if( !sameAsLoader( inMemory, expected ) )  return false;
+
+      for( std::size_t bufferSize : { 1, 2, 3, 7, 64, 4096, 1 << 20 } )
+      {
+        std::istringstream stream( text );
+        RecordSource       source( stream, bufferSize );
+        if( !sameAsLoader( source, expected ) )
+        {
+          std::cerr << "buffer size " << bufferSize << ", tail \"" << tail << "\":  ";
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+
+
+
+  // The same queries, computed the obvious way from materialized items
+  struct Answers
+  {
+    std::vector<std::pair<std::string, BrandAggregate::Statistics>> byBrand;
+    std::vector<std::pair<std::string, BrandAggregate::Statistics>> cheapGtinByBrand;
+    std::vector<GroceryItem>                                        priciest;
+    std::vector<GroceryItem>                                        priciestCheapGtin;
+  };
+
+  bool cheapGtin( std::string_view upcCode, double price )   { return upcCode.size() == 14 && price < 5.0; }
+
+
+  Answers materializedAnswers( std::vector<GroceryItem> const & items, std::size_t k )
+  {
+    auto aggregate = [&]( auto && keep )
+    {
+      std::map<std::string, BrandAggregate::Statistics> brands;
+      for( auto const & item : items )
+      {
+        if( !keep( item ) )  continue;
+        auto [brand, inserted] = brands.try_emplace( item.brandName(), BrandAggregate::Statistics{ 0, 0.0, item.price(), item.price() } );
+        auto & statistics      = brand->second;
+        ++statistics.count;
+        statistics.sum += item.price();
+        statistics.min  = std::min( statistics.min, item.price() );
+        statistics.max  = std::max( statistics.max, item.price() );
+      }
+      return std::vector<std::pair<std::string, BrandAggregate::Statistics>>( brands.begin(), brands.end() );
+    };
+
+    auto topK = [&]( auto && keep )
+    {
+      std::vector<GroceryItem> kept;
+      for( auto const & item : items )  if( keep( item ) )  kept.push_back( item );
+      std::stable_sort( kept.begin(), kept.end(), []( GroceryItem const & lhs, GroceryItem const & rhs ) { return lhs.price() > rhs.price(); } );
+      kept.resize( std::min( k, kept.size() ) );
+      return kept;
+    };
+
+    auto all       = []( GroceryItem const & )      { return true; };
+    auto cheapOnly = []( GroceryItem const & item ) { return cheapGtin( item.upcCode(), item.price() ); };
+    return { aggregate( all ), aggregate( cheapOnly ), topK( all ), topK( cheapOnly ) };
+  }
+
+
+  Answers streamedAnswers( RecordSource & source, std::size_t k, ParseStatus & status )
+  {
+    BrandAggregate byBrand,         cheapGtinByBrand;
+    TopK           priciest( k ),   priciestCheapGtin( k );
+
+    auto cheapGtinQueries = fanOut( cheapGtinByBrand, priciestCheapGtin );
+    auto cheapGtinOnly    = filter( []( ItemView const & item ) { return cheapGtin( item.upcCode, item.price ); }, cheapGtinQueries );
+    status = run( source, fanOut( byBrand, priciest, cheapGtinOnly ) );
+
+    return { byBrand.results(), cheapGtinByBrand.results(), priciest.results(), priciestCheapGtin.results() };
+  }
+
+
+  bool sameStatistics( std::vector<std::pair<std::string, BrandAggregate::Statistics>> const & lhs,
+                       std::vector<std::pair<std::string, BrandAggregate::Statistics>> const & rhs )
+  {
+    if( lhs.size() != rhs.size() )  return false;
+    for( std::size_t i = 0; i < lhs.size(); ++i )
+    {
+      auto const & [a, x] = lhs[i];
+      auto const & [b, y] = rhs[i];
+      if( a != b || x.count != y.count || std::memcmp( &x.sum, &y.sum, sizeof x.sum ) != 0 || x.min != y.min || x.max != y.max )  return false;
+    }
+    return true;
+  }
+
+
+  bool sameItems( std::vector<GroceryItem> const & lhs, std::vector<GroceryItem> const & rhs )
+  {
+    if( lhs.size() != rhs.size() )  return false;
+    for( std::size_t i = 0; i < lhs.size(); ++i )  if( !identical( lhs[i], rhs[i] ) )  return false;
+    return true;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly = verifyOnly( argc, argv );
+  std::size_t count      = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 20'000 : 2'000'000;
+  std::size_t k          = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 100;
+
+  if( !verifySource() )
+  {
+    std::cerr << "RecordSource read differently from loadCatalog()\n";
+    return EXIT_FAILURE;
+  }
+
+  auto path = std::filesystem::temp_directory_path() / "RecordPipelineBenchmark.txt";
+  writeSyntheticCatalog( path, count );
+  auto fileBytes = static_cast<double>( std::filesystem::file_size( path ) );
+
+  // Streamed first:  a process's resident set hardly shrinks after freeing, so the materialized run would hide the streamed one's
+  Answers     streamed;
+  ParseStatus status       = ParseStatus::ok;
+  std::size_t residentBase = residentSetBytes(),  streamedResident = 0;
+  double      streamedSeconds = secondsToRun( [&]
+  {
+    std::ifstream file( path, std::ios::binary );
+    RecordSource  source( file );
+    streamed         = streamedAnswers( source, k, status );
+    streamedResident = residentSetBytes();
+  } );
+
+  Answers     materialized;
+  std::size_t materializedResident = 0;
+  double      materializedSeconds  = secondsToRun( [&]
+  {
+    auto loaded = loadCatalogFile( path );
+    materializedResident = residentSetBytes();
+    materialized         = materializedAnswers( loaded.items, k );
+  } );
+  std::filesystem::remove( path );
+
+  if( status != ParseStatus::endOfInput
+   || !sameStatistics( streamed.byBrand,          materialized.byBrand          )
+   || !sameStatistics( streamed.cheapGtinByBrand, materialized.cheapGtinByBrand )
+   || !sameItems     ( streamed.priciest,          materialized.priciest          )
+   || !sameItems     ( streamed.priciestCheapGtin, materialized.priciestCheapGtin ) )
+  {
+    std::cerr << "Streamed results differ from the materialized results\n";
+    return EXIT_FAILURE;
+  }
+  if( checksOnly )
+  {
+    std::cout << "verified RecordSource and the streamed results on " << count << " items\n";
+    return EXIT_SUCCESS;
+  }
+
+  std::cout << "items: " << count << "   brands: " << streamed.byBrand.size() << "   k: " << k << "   file MB: " << fileBytes / 1e6 << '\n'
+            << "streamed       ms: " << streamedSeconds     * 1e3 << "   MB/s: " << fileBytes / streamedSeconds     / 1e6
+            << "   resident MB above start: " << static_cast<double>( streamedResident     - std::min( streamedResident,     residentBase ) ) / 1e6 << '\n'
+            << "materialized   ms: " << materializedSeconds * 1e3 << "   MB/s: " << fileBytes / materializedSeconds / 1e6
+            << "   resident MB above start: " << static_cast<double>( materializedResident - std::min( materializedResident, residentBase ) ) / 1e6 << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+#pragma once                                                                  // include guard
+
+#include <algorithm>                                                          // min(), copy(), replace()
+#include <chrono>
+#include <cstddef>                                                            // size_t
+#include <cstdint>                                                            // uint64_t, SIZE_MAX
+#include <cstdio>                                                             // snprintf()
+#include <cstring>                                                            // memcmp()
+#include <filesystem>                                                         // path
+#include <fstream>                                                            // ifstream, ofstream
+#include <random>                                                             // mt19937_64, distributions
+#include <sstream>                                                            // ostringstream
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GroceryItem.hpp"
+
+
+
+
+// Deterministic, realistic-looking catalog data shared by the benchmark drivers.  Brands repeat across many items (a few thousand
+// brands over the whole catalog), UPCs are a mix of 12-digit UPC-A and 14-digit GTIN codes, prices are whole cents, and a small
+// fraction of product names contain quotes and backslashes so the escaping paths get exercised too.
+inline std::vector<GroceryItem> makeSyntheticCatalog( std::size_t count, std::uint64_t seed = 42, std::size_t brandCount = 3'000 )
+{
+  static constexpr char const * adjectives[] = { "Organic", "Classic", "Reduced Fat", "Family Size", "Spicy", "Original", "Honey Roasted", "Sugar Free" };
+  static constexpr char const * nouns[]      = { "Peanut Butter", "Tomato Ketchup", "Spaghetti With Meatballs", "Corn Flakes", "Green Tea", "Potato Chips", "Cheddar Cheese", "Ice Cream" };
+  static constexpr char const * sizes[]      = { "12 oz", "2 Ct", "1 lb", "16.9 fl oz", "6 Pack", "32 oz" };
+  static constexpr char const * companies[]  = { "", " Foods", " Farms & Co.", " International Brands" };
+
+  std::mt19937_64                            random( seed );
+  std::uniform_int_distribution<std::size_t> pickBrand( 0, brandCount - 1 );
+  std::uniform_int_distribution<int>         pick( 0, 1'000'000 );
+  std::uniform_int_distribution<std::uint64_t> pickUpc( 0, 99'999'999'999'999ULL );
+
+  std::vector<std::string> brands;
+  brands.reserve( brandCount );
+  for( std::size_t i = 0; i < brandCount; ++i )  brands.push_back( "Brand " + std::to_string( i * 7'919 % 100'003 ) + companies[i % std::size( companies )] );
+
+  std::vector<GroceryItem> items;
+  items.reserve( count );
+  char upc[16];
+  for( std::size_t i = 0; i < count; ++i )
+  {
+    auto code = pickUpc( random );
+    if( pick( random ) % 3 == 0 )  std::snprintf( upc, sizeof upc, "%012llu", static_cast<unsigned long long>( code % 1'000'000'000'000ULL ) );
+    else                           std::snprintf( upc, sizeof upc, "%014llu", static_cast<unsigned long long>( code ) );
+
+    auto const & brand   = brands[ pickBrand( random ) ];
+    std::string  product = brand + ' ' + adjectives[ pick( random ) % std::size( adjectives ) ]
+                                 + ' ' + nouns     [ pick( random ) % std::size( nouns      ) ]
+                                 + " - " + sizes   [ pick( random ) % std::size( sizes      ) ];
+    if( pick( random ) % 200 == 0 )  product += " \"Club\" \\ Pack";
+
+    double price = ( pick( random ) % 5'000 + 19 ) / 100.0;
+    items.emplace_back( std::move( product ), brand, upc, price );
+  }
+  return items;
+}
+
+
+// The catalog's text form, one record per line, exactly as operator<< writes it
+inline std::string toCatalogText( std::vector<GroceryItem> const & items )
+{
+  std::ostringstream stream;
+  for( auto const & item : items )  stream << item << '\n';
+  return std::move( stream ).str();
+}
+
+
+// Catalog text for checking loaders that cut their input into pieces:  the synthetic catalog with every third product name spread
+// over several lines (a newline for every space), so that many lines begin inside a quoted field, and, when malformedAt < count, a
+// record whose price isn't a number in place of item malformedAt
+inline std::string makeMultilineCatalogText( std::size_t count, std::uint64_t seed = 42, std::size_t malformedAt = SIZE_MAX )
+{
+  auto items = makeSyntheticCatalog( count, seed );
+  for( std::size_t i = 0; i < items.size(); i += 3 )
+  {
+    std::string product = items[i].productName();
+    std::replace( product.begin(), product.end(), ' ', '\n' );
+    items[i].productName( std::move( product ) );
+  }
+
+  std::ostringstream stream;
+  for( std::size_t i = 0; i < items.size(); ++i )
+  {
+    if( i == malformedAt )  stream << "\"123\", \"Acme\", \"Bread\nRye\", abc\n";
+    else                    stream << items[i] << '\n';
+  }
+  return std::move( stream ).str();
+}
+
+
+// Writes a synthetic catalog of count records to path without ever holding more than one batch of items in memory, so the
+// process's resident set stays small for whatever is measured next
+inline void writeSyntheticCatalog( std::filesystem::path const & path, std::size_t count, std::uint64_t seed = 42 )
+{
+  constexpr std::size_t batchSize = 100'000;
+
+  std::ofstream file( path, std::ios::binary );
+  for( std::size_t written = 0; written < count; written += batchSize )
+  {
+    file << toCatalogText( makeSyntheticCatalog( std::min( batchSize, count - written ), seed + written ) );
+  }
+}
+
+
+// The process's current resident set size in bytes (Linux), or 0 if it can't be determined
+inline std::size_t residentSetBytes()
+{
+  std::ifstream status( "/proc/self/status" );
+  for( std::string line; std::getline( status, line ); )
+  {
+    if( line.rfind( "VmRSS:", 0 ) == 0 )  return std::stoull( line.substr( 6 ) ) * 1024;   // Reported in kB
+  }
+  return 0;
+}
+
+
+// The process's peak resident set size in bytes since it started, or since the last resetPeakResidentSet() (Linux), or 0 if it can't
+// be determined
+inline std::size_t peakResidentSetBytes()
+{
+  std::ifstream status( "/proc/self/status" );
+  for( std::string line; std::getline( status, line ); )
+  {
+    if( line.rfind( "VmHWM:", 0 ) == 0 )  return std::stoull( line.substr( 6 ) ) * 1024;   // Reported in kB
+  }
+  return 0;
+}
+
+
+// Restarts peakResidentSetBytes() from the current resident set, so a peak can be measured for one phase of a benchmark.  Returns
+// false if the kernel doesn't allow it.
+inline bool resetPeakResidentSet()
+{
+  std::ofstream clearRefs( "/proc/self/clear_refs" );
+  return static_cast<bool>( clearRefs << "5" << std::flush );
+}
+
+
+// Byte-for-byte equality, including the price's bit pattern (operator== would accept prices within epsilon)
+inline bool identical( GroceryItem const & lhs, GroceryItem const & rhs )
+{
+  double lhsPrice = lhs.price(),  rhsPrice = rhs.price();
+  return lhs.upcCode()     == rhs.upcCode()
+      && lhs.brandName()   == rhs.brandName()
+      && lhs.productName() == rhs.productName()
+      && std::memcmp( &lhsPrice, &rhsPrice, sizeof lhsPrice ) == 0;
+}
+
+
+// Whether a driver was run as "<driver> --verify ...":  its correctness checks alone, at sizes small enough for ctest, without the
+// timings.  The flag is removed from argv, so any sizes after it are read as usual.
+inline bool verifyOnly( int & argc, char * argv[] )
+{
+  if( argc < 2 || std::string_view( argv[1] ) != "--verify" )  return false;
+  std::copy( argv + 2, argv + argc + 1, argv + 1 );                           // argv[argc] is the null pointer, moved down with the rest
+  --argc;
+  return true;
+}
+
+
+// Wall-clock seconds taken by work()
+template< typename Work >
+double secondsToRun( Work && work )
+{
+  auto start = std::chrono::steady_clock::now();
+  work();
+  return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
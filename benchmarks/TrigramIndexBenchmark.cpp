@@ -0,0 +1,278 @@
+// Times product and brand name searches answered by a TrigramIndex against the same searches answered by scanning every item, and
+// checks they find the same items.
+//
+// Before that it checks the index against a scan on a small catalog through a long run of inserts, name changes, price changes, and
+// erases (enough to make it compact), with queries of every shape:  multi-term, mixed case, terms too short to have trigrams,
+// trigrams no item has, and limits.
+//
+// Usage:  TrigramIndexBenchmark [itemCount = 10000000] [queries = 60]
+
+#include <algorithm>                                                  // sort(), min(), includes()
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <functional>                                                 // boyer_moore_horspool_searcher
+#include <iostream>
+#include <random>
+#include <stdexcept>                                                  // out_of_range
+#include <string>
+#include <string_view>
+#include <utility>                                                    // move()
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+#include "TrigramIndex.hpp"
+
+
+namespace
+{
+  // The obvious search:  every item, every term, each term searched for with a case-insensitive Boyer-Moore-Horspool
+  constexpr char lower( char c ) noexcept
+  { return c >= 'A' && c <= 'Z' ? static_cast<char>( c - 'A' + 'a' ) : c; }
+
+  struct LowerHash  { std::size_t operator()( char c ) const noexcept         { return static_cast<unsigned char>( lower( c ) ); } };
+  struct LowerEqual { bool        operator()( char lhs, char rhs ) const noexcept { return lower( lhs ) == lower( rhs ); } };
+
+  using Searcher = std::boyer_moore_horspool_searcher<std::string::const_iterator, LowerHash, LowerEqual>;
+
+
+  std::vector<TrigramIndex::ItemId> scan( TrigramIndex const & index, std::size_t idCount, std::string const & query )
+  {
+    std::vector<std::string> terms;
+    std::string              term;
+    for( char c : query + ' ' )
+    {
+      if( c != ' ' )            term += c;
+      else if( !term.empty() )  terms.push_back( std::exchange( term, {} ) );
+    }
+
+    std::vector<Searcher> searchers;
+    for( auto const & each : terms )  searchers.emplace_back( each.begin(), each.end() );
+
+    auto contains = [&]( std::string const & text, Searcher const & searcher ) { return searcher( text.begin(), text.end() ).first != text.end(); };
+
+    std::vector<TrigramIndex::ItemId> found;
+    for( TrigramIndex::ItemId id = 0; id < idCount; ++id )
+    {
+      auto item = index.find( id );
+      if( item == nullptr )  continue;
+
+      bool all = true;
+      for( auto const & searcher : searchers )
+      {
+        if( !contains( item->productName(), searcher ) && !contains( item->brandName(), searcher ) )  { all = false;  break; }
+      }
+      if( all )  found.push_back( id );
+    }
+    return found;
+  }
+
+
+
+
+  // A limited search promises only that many of the matches, not which ones
+  bool isPage( std::vector<TrigramIndex::ItemId> const & page, std::vector<TrigramIndex::ItemId> const & all, std::size_t limit )
+  { return page.size() == std::min( limit, all.size() ) && std::includes( all.begin(), all.end(), page.begin(), page.end() ); }
+
+
+
+
+  // Queries shaped like what a shopper types, built from the catalog's own words
+  struct Query
+  {
+    std::string text;
+    int         kind;
+  };
+
+  constexpr char const * kindNames[] = { "brand + word", "two words", "rare phrase", "common phrase" };
+
+
+  std::vector<Query> makeQueries( TrigramIndex const & index, std::size_t idCount, std::size_t count, std::uint64_t seed )
+  {
+    static constexpr char const * words[]   = { "peanut", "ketchup", "meatballs", "flakes", "tea", "chips", "cheddar", "cream",
+                                                "organic", "classic", "reduced", "family", "spicy", "original", "honey", "sugar" };
+    static constexpr char const * rare[]    = { "\"Club\"", "club\" \\ pack", "\\ PACK", "ketchup \"club\"" };   // 1 item in 200 or fewer
+    static constexpr char const * common[]  = { "Peanut Butter", "green tea", "POTATO", "farms & co", "international 12 oz" };
+
+    std::mt19937_64                            random( seed );
+    std::uniform_int_distribution<std::size_t> pickId( 0, idCount - 1 ), pickWord( 0, std::size( words ) - 1 );
+
+    std::vector<Query> queries;
+    for( std::size_t i = 0; i < count; ++i )
+    {
+      int kind = static_cast<int>( i % std::size( kindNames ) );
+      std::string text;
+      switch( kind )
+      {
+        case 0:
+        {
+          GroceryItem const * item = nullptr;
+          while( item == nullptr )  item = index.find( static_cast<TrigramIndex::ItemId>( pickId( random ) ) );
+          auto brand  = std::string_view( item->brandName() ).substr( 6 );   // "Brand 12345 Foods" -> "12345 Foods"
+          text = std::string( brand.substr( 0, brand.find( ' ' ) ) ) + ' ' + words[pickWord( random )];
+          break;
+        }
+        case 1:  text = std::string( words[pickWord( random ) % 8 + 8] ) + ' ' + words[pickWord( random ) % 8];    break;
+        case 2:  text = rare  [i / std::size( kindNames ) % std::size( rare   )];                                 break;
+        default: text = common[i / std::size( kindNames ) % std::size( common )];                                 break;
+      }
+      queries.push_back( { std::move( text ), kind } );
+    }
+    return queries;
+  }
+
+
+
+
+  bool verifyIndex()
+  {
+    constexpr std::size_t initial = 20'000;
+
+    auto         catalog = makeSyntheticCatalog( initial + 10'000, 3, 400 );
+    TrigramIndex index( std::vector<GroceryItem>( catalog.begin(), catalog.begin() + initial ) );
+    std::size_t  idCount = initial, next = initial;
+
+    std::vector<std::string> fixed = { "", "   ", "a", "OZ", "12 oz", "peanut butter", "PEANUT   butter", "butter peanut", "Brand 1",
+                                       "\"club\"", "\\", "& co.", "zzz", "xyzzy peanut", "peanut xyzzy", "brand foods", "ea", "Ea ut",
+                                       "ketchup 2 ct", "Éclair" };
+
+    auto check = [&]( std::string const & query )
+    {
+      auto expected = scan( index, idCount, query );
+      if( index.search( query ) != expected )
+      {
+        std::cerr << "query \"" << query << "\":  ";
+        return false;
+      }
+      for( std::size_t limit : { 0, 1, 7 } )
+      {
+        if( !isPage( index.search( query, limit ), expected, limit ) )
+        {
+          std::cerr << "query \"" << query << "\" limit " << limit << ":  ";
+          return false;
+        }
+      }
+      return true;
+    };
+
+    std::mt19937_64                    random( 11 );
+    std::uniform_int_distribution<int> pick( 0, 99 );
+    for( int round = 0; round < 8; ++round )
+    {
+      for( auto const & query : fixed )  if( !check( query ) )  return false;
+      for( auto const & query : makeQueries( index, idCount, 40, static_cast<std::uint64_t>( round ) ) )  if( !check( query.text ) )  return false;
+
+      // Churn:  erase most of what's there (compacting along the way), rename, reprice, and insert
+      for( int change = 0; change < 6'000; ++change )
+      {
+        auto id   = static_cast<TrigramIndex::ItemId>( random() % idCount );
+        auto what = pick( random );
+        if( what < 55 )  index.erase( id );
+        else if( what < 80 && index.find( id ) != nullptr )
+        {
+          auto renamed = *index.find( id );
+          renamed.productName( "Renamed " + std::to_string( change ) + ' ' + catalog[random() % catalog.size()].productName() );
+          if( what < 70 )  renamed.brandName( catalog[random() % catalog.size()].brandName() );
+          index.update( id, std::move( renamed ) );
+        }
+        else if( what < 85 && index.find( id ) != nullptr )
+        {
+          auto repriced = *index.find( id );
+          repriced.price( repriced.price() + 1.0 );
+          index.update( id, std::move( repriced ) );
+        }
+        else
+        {
+          if( index.insert( catalog[next++ % catalog.size()] ) != idCount++ )  return false;
+        }
+      }
+
+      std::size_t live = 0;
+      for( TrigramIndex::ItemId id = 0; id < idCount; ++id )  live += index.find( id ) != nullptr;
+      if( live != index.size() )  return false;
+    }
+
+    try
+    {
+      index.update( static_cast<TrigramIndex::ItemId>( idCount ), catalog.front() );
+      return false;
+    }
+    catch( std::out_of_range const & ) {}
+    return true;
+  }
+
+
+
+
+  double percentile( std::vector<double> samples, double fraction )
+  {
+    std::sort( samples.begin(), samples.end() );
+    return samples[std::min( samples.size() - 1, static_cast<std::size_t>( fraction * static_cast<double>( samples.size() ) ) )];
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  std::size_t count      = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 10'000'000;
+  std::size_t queryCount = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 60;
+  constexpr std::size_t pageSize = 50;
+
+  if( !verifyIndex() )
+  {
+    std::cerr << "TrigramIndex disagrees with a scan\n";
+    return EXIT_FAILURE;
+  }
+
+  std::size_t  residentBase = residentSetBytes();
+  auto         catalog      = makeSyntheticCatalog( count );
+  std::size_t  itemsBytes   = residentSetBytes() - std::min( residentSetBytes(), residentBase );
+
+  TrigramIndex index;
+  double       buildSeconds = secondsToRun( [&] { index = TrigramIndex( std::move( catalog ) ); } );
+  auto         queries      = makeQueries( index, count, queryCount, 7 );
+
+  // Per kind of query:  scan, index for every match, and index for the first page of matches
+  std::size_t kinds = std::size( kindNames );
+  std::vector<std::vector<double>> scanMs( kinds ), indexMs( kinds ), pageMs( kinds );
+  std::vector<double>              matches( kinds );
+  for( auto const & query : queries )
+  {
+    std::vector<TrigramIndex::ItemId> expected, found, page;
+    scanMs [query.kind].push_back( secondsToRun( [&] { expected = scan( index, count, query.text ); } ) * 1e3 );
+    indexMs[query.kind].push_back( secondsToRun( [&] { found = index.search( query.text );           } ) * 1e3 );
+    pageMs [query.kind].push_back( secondsToRun( [&] { page  = index.search( query.text, pageSize ); } ) * 1e3 );
+
+    if( found != expected || !isPage( page, expected, pageSize ) )
+    {
+      std::cerr << "query \"" << query.text << "\":  the index and the scan disagree\n";
+      return EXIT_FAILURE;
+    }
+    matches[query.kind] += static_cast<double>( expected.size() );
+  }
+
+  std::vector<double> allScan, allIndex, allPage;
+  for( std::size_t kind = 0; kind < kinds; ++kind )
+  {
+    allScan .insert( allScan .end(), scanMs [kind].begin(), scanMs [kind].end() );
+    allIndex.insert( allIndex.end(), indexMs[kind].begin(), indexMs[kind].end() );
+    allPage .insert( allPage .end(), pageMs [kind].begin(), pageMs [kind].end() );
+  }
+
+  std::cout << "items: " << count << "   queries: " << queries.size() << "   build ms: " << buildSeconds * 1e3
+            << "   items MB: " << static_cast<double>( itemsBytes ) / 1e6 << "   postings MB: " << static_cast<double>( index.postingBytes() ) / 1e6 << '\n';
+  for( std::size_t kind = 0; kind < kinds; ++kind )
+  {
+    if( scanMs[kind].empty() )  continue;
+    std::cout << kindNames[kind] << "   (" << scanMs[kind].size() << " queries, " << matches[kind] / static_cast<double>( scanMs[kind].size() ) << " matches on average)\n"
+              << "  scan             p50 ms: " << percentile( scanMs [kind], 0.50 ) << "   p99 ms: " << percentile( scanMs [kind], 0.99 ) << '\n'
+              << "  index, all       p50 ms: " << percentile( indexMs[kind], 0.50 ) << "   p99 ms: " << percentile( indexMs[kind], 0.99 ) << '\n'
+              << "  index, first " << pageSize << " p50 ms: " << percentile( pageMs [kind], 0.50 ) << "   p99 ms: " << percentile( pageMs [kind], 0.99 ) << '\n';
+  }
+  std::cout << "all queries\n"
+            << "  scan             p50 ms: " << percentile( allScan,  0.50 ) << "   p99 ms: " << percentile( allScan,  0.99 ) << '\n'
+            << "  index, all       p50 ms: " << percentile( allIndex, 0.50 ) << "   p99 ms: " << percentile( allIndex, 0.99 ) << '\n'
+            << "  index, first " << pageSize << " p50 ms: " << percentile( allPage,  0.50 ) << "   p99 ms: " << percentile( allPage,  0.99 ) << '\n';
+  return EXIT_SUCCESS;
+}
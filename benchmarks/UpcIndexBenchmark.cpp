@@ -0,0 +1,202 @@
+// Measures the latency of single lookups by UPC code in UpcIndex, std::map, and std::unordered_map, reporting the median and 99th
+// percentile.  Before timing it checks that all three agree on every lookup, that erasing from UpcIndex leaves exactly the expected
+// items findable, and that std::hash<GroceryItem> agrees with operator== for prices that differ by less than epsilon.
+//
+// The maps are keyed by UPC string with transparent comparison and hashing, so they too look up a std::string_view without building
+// a std::string - the comparison is between the data structures, not between a lookup that allocates and one that doesn't.  Only one
+// structure is alive at a time, so 50 million items fit in memory.
+//
+// Usage:  UpcIndexBenchmark [itemCount = 1000000] [lookupCount = 1000000]
+//         UpcIndexBenchmark --verify [itemCount = 100000] [lookupCount = 100000]    The checks alone, for ctest
+
+#include <algorithm>                                                  // sort(), shuffle()
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <functional>                                                 // hash, less, equal_to
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "GroceryItem.hpp"
+#include "SyntheticCatalog.hpp"
+#include "UpcIndex.hpp"
+
+
+namespace
+{
+  struct TransparentHash
+  {
+    using is_transparent = void;
+    std::size_t operator()( std::string_view text ) const noexcept { return std::hash<std::string_view>{}( text ); }
+  };
+
+  using OrderedMap   = std::map<std::string, GroceryItem, std::less<>>;
+  using UnorderedMap = std::unordered_map<std::string, GroceryItem, TransparentHash, std::equal_to<>>;
+
+  GroceryItem const * lookup( UpcIndex     const & index, std::string_view upc ) { return index.find( upc ); }
+  GroceryItem const * lookup( OrderedMap   const & map,   std::string_view upc ) { auto it = map.find( upc );  return it == map.end() ? nullptr : &it->second; }
+  GroceryItem const * lookup( UnorderedMap const & map,   std::string_view upc ) { auto it = map.find( upc );  return it == map.end() ? nullptr : &it->second; }
+
+
+  // What each lookup key should find:  the first item with that UPC code, or nothing
+  std::vector<GroceryItem const *> expectedResults( std::vector<GroceryItem> const & items, std::vector<std::string> const & keys )
+  {
+    std::unordered_map<std::string_view, GroceryItem const *> first;
+    for( auto const & item : items )  first.try_emplace( item.upcCode(), &item );
+
+    std::vector<GroceryItem const *> expected;
+    for( auto const & key : keys )
+    {
+      auto it = first.find( key );
+      expected.push_back( it == first.end() ? nullptr : it->second );
+    }
+    return expected;
+  }
+
+
+  template< typename Container >
+  bool agrees( Container const & container, std::vector<std::string> const & keys, std::vector<GroceryItem const *> const & expected )
+  {
+    for( std::size_t i = 0; i < keys.size(); ++i )
+    {
+      auto found = lookup( container, keys[i] );
+      if( ( found == nullptr ) != ( expected[i] == nullptr ) || ( found != nullptr && *found != *expected[i] ) )  return false;
+    }
+    return true;
+  }
+
+
+  bool verifyErase( std::vector<GroceryItem> const & items )
+  {
+    UpcIndex                                        index( items );
+    std::unordered_map<std::string, GroceryItem>    reference;
+    for( auto const & item : items )  reference.try_emplace( item.upcCode(), item );
+
+    std::mt19937_64 random( 7 );
+    for( auto const & item : items )
+    {
+      if( random() % 3 != 0 )  continue;
+      if( index.erase( item.upcCode() ) != ( reference.erase( item.upcCode() ) == 1 ) )  return false;
+    }
+
+    if( index.size() != reference.size() )  return false;
+    for( auto const & item : items )
+    {
+      auto found = index.find( item.upcCode() );
+      auto it    = reference.find( item.upcCode() );
+      if( ( found == nullptr ) != ( it == reference.end() ) || ( found != nullptr && *found != it->second ) )  return false;
+    }
+    return index.find( std::string_view{} ) == nullptr;                 // A default-constructed view:  no characters, and a null data()
+  }
+
+
+  bool verifyHash()
+  {
+    GroceryItem a( "Bread", "Acme", "012345678905", 2.49 ),  b( "Bread", "Acme", "012345678905", 2.49 + 5e-5 );
+    GroceryItem c( "Bread", "Acme", "012345678906", 2.49 );
+    std::hash<GroceryItem> hasher;
+    return a == b && hasher( a ) == hasher( b ) && hasher( a ) != hasher( c );
+  }
+
+
+  struct Latency
+  {
+    double p50 = 0.0,  p99 = 0.0,  mean = 0.0;
+  };
+
+  // Times each lookup on its own.  The clock reads add a roughly constant overhead to every sample, the same for every container.
+  template< typename Container >
+  Latency measure( Container const & container, std::vector<std::string> const & keys, std::size_t & checksum )
+  {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<double> nanoseconds;
+    nanoseconds.reserve( keys.size() );
+    for( auto const & key : keys )
+    {
+      auto start = Clock::now();
+      auto found = lookup( container, key );
+      auto stop  = Clock::now();
+      checksum += found != nullptr;
+      nanoseconds.push_back( std::chrono::duration<double, std::nano>( stop - start ).count() );
+    }
+
+    Latency latency;
+    for( double sample : nanoseconds )  latency.mean += sample;
+    latency.mean /= static_cast<double>( nanoseconds.size() );
+
+    std::sort( nanoseconds.begin(), nanoseconds.end() );
+    latency.p50 = nanoseconds[nanoseconds.size() / 2];
+    latency.p99 = nanoseconds[nanoseconds.size() * 99 / 100];
+    return latency;
+  }
+
+
+  void report( char const * name, Latency const & latency )
+  {
+    std::cout << name << "   p50 " << latency.p50 << " ns   p99 " << latency.p99 << " ns   mean " << latency.mean << " ns\n";
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly  = verifyOnly( argc, argv );
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 100'000 : 1'000'000;
+  std::size_t lookupCount = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : checksOnly ? 100'000 : 1'000'000;
+  if( count == 0 || lookupCount == 0 )  return EXIT_FAILURE;
+
+  std::vector<GroceryItem> items = makeSyntheticCatalog( count );
+
+  // Random keys in random order, one in ten a miss (a present UPC code with its last digit changed, which may or may not exist)
+  std::mt19937_64          random( 99 );
+  std::vector<std::string> keys;
+  keys.reserve( lookupCount );
+  for( std::size_t i = 0; i < lookupCount; ++i )
+  {
+    std::string key = items[random() % count].upcCode();
+    if( random() % 10 == 0 )  key.back() = key.back() == '9' ? '0' : static_cast<char>( key.back() + 1 );
+    keys.push_back( std::move( key ) );
+  }
+  auto expected = expectedResults( items, keys );
+
+  if( !verifyHash() )
+  {
+    std::cerr << "std::hash<GroceryItem> disagrees with operator==\n";
+    return EXIT_FAILURE;
+  }
+  if( !verifyErase( std::vector<GroceryItem>( items.begin(), items.begin() + static_cast<std::ptrdiff_t>( std::min<std::size_t>( count, 200'000 ) ) ) ) )
+  {
+    std::cerr << "UpcIndex::erase() left the index out of step with std::unordered_map\n";
+    return EXIT_FAILURE;
+  }
+
+  std::size_t checksum = 0;
+  std::cout << "items: " << count << "   lookups: " << lookupCount << '\n';
+  {
+    UpcIndex index( items );
+    if( !agrees( index, keys, expected ) )  { std::cerr << "UpcIndex lookups differ\n";  return EXIT_FAILURE; }
+    if( !checksOnly )  report( "UpcIndex               ", measure( index, keys, checksum ) );
+  }
+  {
+    UnorderedMap map;
+    map.reserve( count );
+    for( auto const & item : items )  map.try_emplace( item.upcCode(), item );
+    if( !agrees( map, keys, expected ) )  { std::cerr << "std::unordered_map lookups differ\n";  return EXIT_FAILURE; }
+    if( !checksOnly )  report( "std::unordered_map     ", measure( map, keys, checksum ) );
+  }
+  {
+    OrderedMap map;
+    for( auto const & item : items )  map.try_emplace( item.upcCode(), item );
+    if( !agrees( map, keys, expected ) )  { std::cerr << "std::map lookups differ\n";  return EXIT_FAILURE; }
+    if( !checksOnly )  report( "std::map               ", measure( map, keys, checksum ) );
+  }
+  if( checksOnly )  std::cout << "verified hashing, erasure, and every lookup against std::map and std::unordered_map\n";
+  else               std::cout << "(checksum " << checksum << ")\n";
+  return EXIT_SUCCESS;
+}
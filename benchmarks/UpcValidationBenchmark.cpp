@@ -0,0 +1,272 @@
+// Checks the batch UPC validation kernels against a plain one-code-at-a-time GS1 check over edge cases (every length near 12 and
+// 14, a non-digit at every position, codes ending right at an unmapped page) and a synthetic catalog's codes, half of them given
+// correct check digits, then checks and times normalizeUpcs() and checks the loaders' opt-in normalization.  Then times validation
+// next to the load that produces the codes:  fused into parsing a batch at a time, and by each kernel over the whole catalog, as
+// views into its text and as GroceryItems.
+//
+// Usage:  UpcValidationBenchmark [itemCount = 5000000] [repetitions = 10]
+//         UpcValidationBenchmark --verify [itemCount = 100000]                The checks alone, for ctest
+
+#include <algorithm>                                                  // min()
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoull()
+#include <cstring>                                                    // memcpy()
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/mman.h>                                                 // mmap(), mprotect()
+#include <unistd.h>                                                   // sysconf()
+
+#include "CatalogLoader.hpp"
+#include "GroceryItem.hpp"
+#include "GroceryItemParser.hpp"
+#include "SyntheticCatalog.hpp"
+#include "UpcValidation.hpp"
+
+
+namespace
+{
+  // The definition, digit by digit:  weights 1, 3, 1, 3, ... from the check digit leftward
+  UpcStatus reference( std::string_view code )
+  {
+    if( code.size() != 12 && code.size() != 14 )  return UpcStatus::badLength;
+    for( char c : code )  if( c < '0' || c > '9' )  return UpcStatus::notDigits;
+
+    int sum = 0;
+    for( std::size_t fromRight = 0; fromRight < code.size(); ++fromRight )
+    {
+      int digit = code[code.size() - 1 - fromRight] - '0';
+      sum += fromRight % 2 == 0 ? digit : 3 * digit;
+    }
+    return sum % 10 == 0 ? UpcStatus::valid : UpcStatus::badCheckDigit;
+  }
+
+
+  // code with its last digit replaced by the right check digit
+  std::string withCheckDigit( std::string code )
+  {
+    for( char digit = '0'; digit <= '9'; ++digit )
+    {
+      code.back() = digit;
+      if( reference( code ) == UpcStatus::valid )  break;
+    }
+    return code;
+  }
+
+
+  std::vector<std::string> edgeCases()
+  {
+    std::vector<std::string> codes{ "", "0", "03600029145", "036000291452", "036000291453", "0360002914520", "00036000291452",
+                                    "00036000291453", "000360002914520", "000000000000", "00000000000000", "999999999999",
+                                    "036000291452\n", " 36000291452", "05017402006207", "0501740200620" };
+    for( std::string base : { std::string( "036000291452" ), std::string( "00036000291452" ) } )
+    {
+      for( std::size_t i = 0; i < base.size(); ++i )
+      {
+        for( char bad : { '/', ':', ' ', 'A', '\0', '\x80', '\xff', '\xb0' } )    // '/' and ':' sit either side of the digits
+        {
+          std::string code = base;
+          code[i] = bad;
+          codes.push_back( code );
+        }
+      }
+    }
+    return codes;
+  }
+
+
+  bool sameAsReference( std::span<std::string_view const> codes, char const * what )
+  {
+    for( UpcKernelIsa isa : { UpcKernelIsa::scalar, UpcKernelIsa::avx2 } )
+    {
+      if( !setUpcKernelIsa( isa ) )  continue;
+
+      std::vector<UpcStatus> statuses( codes.size() );
+      std::size_t            validCount = validateUpcs( codes, statuses ), expectedValid = 0;
+      for( std::size_t i = 0; i < codes.size(); ++i )
+      {
+        auto expected  = reference( codes[i] );
+        expectedValid += expected == UpcStatus::valid;
+        if( statuses[i] != expected || validateUpc( codes[i] ) != expected )
+        {
+          std::cerr << what << " mismatch:  \"" << codes[i] << "\" is " << describe( expected ) << ", kernel says " << describe( statuses[i] ) << '\n';
+          return false;
+        }
+      }
+      if( validCount != expectedValid )
+      {
+        std::cerr << what << ":  wrong valid count\n";
+        return false;
+      }
+    }
+    return true;
+  }
+
+
+  // Each code copied to end exactly at an inaccessible page, so any read past its end would fault.  Sixteen views of it, two full
+  // groups of eight, so the AVX2 kernel loads it there itself rather than leaving it to the scalar tail.
+  bool pageEndsAreSafe( std::vector<std::string> const & codes )
+  {
+    auto  pageSize = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+    void * pages   = mmap( nullptr, 2 * pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( pages == MAP_FAILED || mprotect( static_cast<char *>( pages ) + pageSize, pageSize, PROT_NONE ) != 0 )  return false;
+
+    bool ok = true;
+    for( auto const & code : codes )
+    {
+      char * end = static_cast<char *>( pages ) + pageSize;
+      std::memcpy( end - code.size(), code.data(), code.size() );
+      std::vector<std::string_view> views( 16, std::string_view( end - code.size(), code.size() ) );
+      ok = ok && sameAsReference( views, "page end" );
+    }
+    munmap( pages, 2 * pageSize );
+    return ok;
+  }
+
+
+  std::vector<std::string_view> upcViews( std::string const & text )
+  {
+    std::vector<std::string_view> views;
+    char const * cursor = text.data();
+    for( RecordView record; parseRecord( cursor, text.data() + text.size(), record ) == ParseStatus::ok; )  views.push_back( record.upcCode.text );
+    return views;
+  }
+
+
+  // Parses text a batch of records at a time, as a loader would, validating each batch's codes while its text is still in cache if
+  // asked to.  Returns the number of valid codes, and the time spent validating, alone, in validationSeconds.
+  std::size_t parseInBatches( std::string const & text, bool validate, double & validationSeconds )
+  {
+    constexpr std::size_t batchSize = 4096;
+
+    std::vector<std::string_view> batch;
+    std::vector<UpcStatus>        statuses( batchSize );
+    std::size_t                   validCount = 0;
+
+    char const * cursor = text.data();
+    char const * end    = text.data() + text.size();
+    for( bool more = true; more; )
+    {
+      batch.clear();
+      RecordView record;
+      while( batch.size() < batchSize && ( more = parseRecord( cursor, end, record ) == ParseStatus::ok ) )  batch.push_back( record.upcCode.text );
+      if( validate )  validationSeconds += secondsToRun( [&] { validCount += validateUpcs( batch, statuses ); } );   // A clock read per 4096 codes
+    }
+    return validCount;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  bool        checksOnly  = verifyOnly( argc, argv );
+  std::size_t count       = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : checksOnly ? 100'000 : 5'000'000;
+  std::size_t repetitions = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 10;
+
+  // Correctness
+  auto edges = edgeCases();
+  std::vector<std::string_view> edgeViews( edges.begin(), edges.end() );
+  if( !sameAsReference( edgeViews, "edge case" ) || !pageEndsAreSafe( edges ) )  return EXIT_FAILURE;
+
+  auto items = makeSyntheticCatalog( count );
+  for( std::size_t i = 0; i < items.size(); i += 2 )  items[i].upcCode( withCheckDigit( items[i].upcCode() ) );
+
+  auto text  = toCatalogText( items );
+  auto views = upcViews( text );
+  if( views.size() != count || !sameAsReference( views, "catalog" ) )  return EXIT_FAILURE;
+
+  for( UpcKernelIsa isa : { UpcKernelIsa::scalar, UpcKernelIsa::avx2 } )
+  {
+    if( !setUpcKernelIsa( isa ) )  continue;
+    std::vector<UpcStatus> fromViews( count ), fromItems( count );
+    if( validateUpcs( views, fromViews ) != validateUpcs( items, fromItems ) || fromViews != fromItems )
+    {
+      std::cerr << "GroceryItem batch disagrees with the view batch\n";
+      return EXIT_FAILURE;
+    }
+  }
+  std::cout << "verified " << edges.size() << " edge cases, at page ends too, and " << count << " catalog codes against the GS1 definition\n";
+
+  // Normalization:  every valid UPC-A code gains its "00", nothing else changes, and both spellings now compare equal
+  auto        normalized = items;
+  std::size_t rewritten  = 0;
+  double      seconds    = secondsToRun( [&] { rewritten = normalizeUpcs( normalized ); } );
+
+  std::size_t expectedRewrites = 0;
+  for( std::size_t i = 0; i < count; ++i )
+  {
+    auto const & before = items[i].upcCode();
+    bool upcA = before.size() == 12 && reference( before ) == UpcStatus::valid;
+    expectedRewrites += upcA;
+    if( normalized[i].upcCode() != ( upcA ? "00" + before : before ) || toGtin14( before ) != ( reference( before ) == UpcStatus::valid ? std::optional( normalized[i].upcCode() ) : std::nullopt ) )
+    {
+      std::cerr << "Wrong normalization of \"" << before << "\"\n";
+      return EXIT_FAILURE;
+    }
+  }
+  GroceryItem upcA( "Ketchup", "Heinz", "036000291452", 2.29 ),  gtin14( "Ketchup", "Heinz", "00036000291452", 2.29 );
+  GroceryItem pair[] = { upcA, gtin14 };
+  normalizeUpcs( pair );
+  if( rewritten != expectedRewrites || upcA == gtin14 || pair[0] != pair[1] )
+  {
+    std::cerr << "Normalized codes don't compare equal\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << "normalized " << rewritten << " UPC-A codes to GTIN-14   items/sec: " << static_cast<double>( count ) / seconds << '\n';
+
+  // Normalizing while loading, serially and chunk by chunk, gives the same items, and counts the codes that aren't valid
+  auto        asRead          = loadCatalog( text );
+  std::size_t expectedInvalid = 0;
+  for( auto const & item : asRead.items )  expectedInvalid += reference( item.upcCode() ) != UpcStatus::valid;
+  normalizeUpcs( asRead.items );
+  for( unsigned threads : { 1u, 3u } )
+  {
+    auto loaded = loadCatalogParallel( text, threads, UpcHandling::normalize );
+    if( !loaded || loaded.items != asRead.items || loaded.invalidUpcs != expectedInvalid || asRead.invalidUpcs != 0 )
+    {
+      std::cerr << "Loading with UpcHandling::normalize on " << threads << " thread(s) disagrees with normalizeUpcs()\n";
+      return EXIT_FAILURE;
+    }
+  }
+  std::cout << "verified normalizing loads, " << expectedInvalid << " invalid codes counted\n";
+  if( checksOnly )  return EXIT_SUCCESS;
+
+  // Throughput, against the load that produces the codes
+  double loadSeconds = secondsToRun( [&] { loadCatalog( text ); } );
+  std::cout << "load                   records/sec: " << static_cast<double>( count ) / loadSeconds << '\n';
+
+  // Validation is timed on its own, inside the fused loop:  the difference of the two loops' times is smaller than their noise
+  double parseSeconds = 1e300,  fusedSeconds = 1e300,  validationSeconds = 1e300;   // Best of three each, alternating
+  for( int round = 0; round < 3; ++round )
+  {
+    double validating = 0.0,  unused = 0.0;
+    parseSeconds      = std::min( parseSeconds, secondsToRun( [&] { parseInBatches( text, false, unused     ); } ) );
+    fusedSeconds      = std::min( fusedSeconds, secondsToRun( [&] { parseInBatches( text, true,  validating ); } ) );
+    validationSeconds = std::min( validationSeconds, validating );
+  }
+  std::cout << "parse alone            records/sec: " << static_cast<double>( count ) / parseSeconds
+            << "   parse and validate records/sec: " << static_cast<double>( count ) / fusedSeconds
+            << "   validation ns/record: " << validationSeconds / static_cast<double>( count ) * 1e9 << '\n';
+
+  std::vector<UpcStatus> statuses( count );
+  auto                   validated = static_cast<double>( count * repetitions );
+  for( UpcKernelIsa isa : { UpcKernelIsa::scalar, UpcKernelIsa::avx2 } )
+  {
+    if( !setUpcKernelIsa( isa ) )
+    {
+      std::cout << "(AVX2 not available on this CPU)\n";
+      continue;
+    }
+    double viewSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  validateUpcs( views, statuses ); } );
+    double itemSeconds = secondsToRun( [&] { for( std::size_t r = 0; r < repetitions; ++r )  validateUpcs( items, statuses ); } );
+
+    std::cout << ( isa == UpcKernelIsa::scalar ? "scalar" : "avx2  " )
+              << "   text views codes/sec: " << validated / viewSeconds
+              << "   GroceryItems codes/sec: " << validated / itemSeconds << '\n';
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+// Merges supplier catalogs, too large together to fit in memory, into one sorted catalog with duplicates collapsed (see
+// CatalogMerge.hpp), and reports what it did, how fast, and the process's peak resident set.
+//
+// Usage:  MergeCatalogs [--memory MiB] [--keep first|lowest-price|all] [--temp directory] [--threads count] output input...
+//
+//   --memory   memory budget for items and buffers, in MiB (default 256)
+//   --keep     which of a group of duplicates to keep:  the one read first (default), the cheapest, or all of them
+//   --temp     where to spill sorted runs (default:  the system's temporary directory)
+//   --threads  threads sorting each run (default:  one per hardware thread)
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>                                                    // EXIT_SUCCESS, EXIT_FAILURE, strtoul(), strtoull()
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CatalogMerge.hpp"
+#include "GroceryItemParser.hpp"
+
+
+namespace
+{
+  int usage()
+  {
+    std::cerr << "Usage:  MergeCatalogs [--memory MiB] [--keep first|lowest-price|all] [--temp directory] [--threads count] output input...\n";
+    return EXIT_FAILURE;
+  }
+
+
+  // The process's peak resident set size in bytes (Linux), or 0 if it can't be determined
+  std::size_t peakResidentSetBytes()
+  {
+    std::ifstream status( "/proc/self/status" );
+    for( std::string line; std::getline( status, line ); )
+    {
+      if( line.rfind( "VmHWM:", 0 ) == 0 )  return std::stoull( line.substr( 6 ) ) * 1024;   // Reported in kB
+    }
+    return 0;
+  }
+}
+
+
+int main( int argc, char * argv[] )
+{
+  CatalogMergeOptions                options;
+  std::vector<std::filesystem::path> paths;                           // The output, then the inputs
+
+  for( int i = 1; i < argc; ++i )
+  {
+    std::string_view argument = argv[i];
+    if( !argument.starts_with( "--" ) )
+    {
+      paths.emplace_back( argument );
+      continue;
+    }
+    if( i + 1 == argc )  return usage();
+
+    std::string_view value = argv[++i];
+    if     ( argument == "--memory"  )  options.memoryBudget       = std::strtoull( value.data(), nullptr, 10 ) << 20;
+    else if( argument == "--temp"    )  options.temporaryDirectory = value;
+    else if( argument == "--threads" )  options.threadCount        = static_cast<unsigned>( std::strtoul( value.data(), nullptr, 10 ) );
+    else if( argument == "--keep"    )
+    {
+      if     ( value == "first"        )  options.duplicates = DuplicatePolicy::keepFirst;
+      else if( value == "lowest-price" )  options.duplicates = DuplicatePolicy::keepLowestPrice;
+      else if( value == "all"          )  options.duplicates = DuplicatePolicy::keepAll;
+      else                                return usage();
+    }
+    else  return usage();
+  }
+  if( paths.size() < 2 )  return usage();
+
+  std::filesystem::path                  output = paths.front();
+  std::span<std::filesystem::path const> inputs = std::span( paths ).subspan( 1 );
+
+  try
+  {
+    auto               start   = std::chrono::steady_clock::now();
+    CatalogMergeResult result  = mergeCatalogs( inputs, output, options );
+    double             seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    if( result.status != ParseStatus::endOfInput )
+    {
+      std::cerr << inputs[result.errorInput].string() << ':' << result.errorLine << ":  " << describe( result.status ) << " - nothing written\n";
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "read "    << result.recordsRead    << " records from " << inputs.size() << " catalogs, wrote " << result.recordsWritten
+              << " ("       << result.duplicatesDropped << " duplicates dropped) to " << output.string() << '\n'
+              << "runs: "   << result.runCount       << "   merge passes: " << result.mergePasses
+              << "   seconds: " << seconds << "   records/sec: " << static_cast<double>( result.recordsRead ) / seconds
+              << "   peak RSS MiB: " << static_cast<double>( peakResidentSetBytes() ) / ( 1 << 20 ) << '\n';
+  }
+  catch( std::exception const & error )
+  {
+    std::cerr << error.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}